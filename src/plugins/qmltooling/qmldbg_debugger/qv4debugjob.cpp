@@ -5,6 +5,7 @@
 
 #include <private/qqmlcontext_p.h>
 #include <private/qqmldebugservice_p.h>
+#include <private/qv4mm_p.h>
 #include <private/qv4jscall_p.h>
 #include <private/qv4qmlcontext_p.h>
 #include <private/qv4qobjectwrapper_p.h>
@@ -13,6 +14,7 @@
 
 #include <QtQml/qqmlengine.h>
 
+#include <QtCore/qfile.h>
 #include <QtCore/qpointer.h>
 
 QT_BEGIN_NAMESPACE
@@ -245,6 +247,24 @@ const QStringList &GatherSourcesJob::result() const
     return sources;
 }
 
+HeapSnapshotJob::HeapSnapshotJob(QV4::ExecutionEngine *engine, const QString &fileName)
+    : engine(engine), fileName(fileName)
+{}
+
+void HeapSnapshotJob::run()
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        error = file.errorString();
+    else if (!engine->memoryManager->writeHeapSnapshot(&file))
+        error = file.errorString();
+}
+
+const QString &HeapSnapshotJob::errorMessage() const
+{
+    return error;
+}
+
 EvalJob::EvalJob(QV4::ExecutionEngine *engine, const QString &script) :
     JavaScriptJob(engine, /*frameNr*/-1, /*context*/ -1, script), result(false)
 {}
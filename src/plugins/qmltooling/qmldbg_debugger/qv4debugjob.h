@@ -116,6 +116,18 @@ public:
     const QStringList &result() const;
 };
 
+class HeapSnapshotJob: public QV4DebugJob
+{
+    QV4::ExecutionEngine *engine;
+    const QString &fileName;
+    QString error;
+
+public:
+    HeapSnapshotJob(QV4::ExecutionEngine *engine, const QString &fileName);
+    void run() override;
+    const QString &errorMessage() const;
+};
+
 class EvalJob: public JavaScriptJob
 {
     bool result;
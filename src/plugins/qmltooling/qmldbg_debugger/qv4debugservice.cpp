@@ -138,6 +138,7 @@ public:
         body.insert(QStringLiteral("UnpausedEvaluate"), true);
         body.insert(QStringLiteral("ContextEvaluate"), true);
         body.insert(QStringLiteral("ChangeBreakpoint"), true);
+        body.insert(QStringLiteral("HeapSnapshot"), true);
         addBody(body);
     }
 };
@@ -637,6 +638,63 @@ public:
         }
     }
 };
+
+// Request:
+// {
+//   "seq": 6,
+//   "type": "request",
+//   "command": "heapsnapshot",
+//   "arguments": {
+//     "fileName": "/tmp/app.heapsnapshot"
+//   }
+// }
+//
+// Writes a snapshot of the JS heap to "fileName" on the device the application runs on. See
+// QV4::MemoryManager::writeHeapSnapshot() for the format.
+class V4HeapSnapshotRequest: public V4CommandHandler
+{
+public:
+    V4HeapSnapshotRequest(): V4CommandHandler(QStringLiteral("heapsnapshot")) {}
+
+    void handleRequest() override
+    {
+        QJsonObject arguments = req.value(QLatin1String("arguments")).toObject();
+        const QString fileName = arguments.value(QLatin1String("fileName")).toString();
+        if (fileName.isEmpty()) {
+            createErrorResponse(QStringLiteral("heapsnapshot command needs a file name"));
+            return;
+        }
+
+        QV4Debugger *debugger = debugService->debuggerAgent.pausedDebugger();
+        if (!debugger) {
+            const QList<QV4Debugger *> &debuggers = debugService->debuggerAgent.debuggers();
+            if (debuggers.size() > 1) {
+                createErrorResponse(QStringLiteral("Cannot write heap snapshot if multiple debuggers are running and none is paused"));
+                return;
+            } else if (debuggers.size() == 0) {
+                createErrorResponse(QStringLiteral("No debuggers available to write heap snapshot"));
+                return;
+            }
+            debugger = debuggers.first();
+        }
+
+        HeapSnapshotJob job(debugger->engine(), fileName);
+        debugger->runInEngine(&job);
+        if (!job.errorMessage().isEmpty()) {
+            createErrorResponse(job.errorMessage());
+            return;
+        }
+
+        QJsonObject body;
+        body[QLatin1String("fileName")] = fileName;
+
+        addCommand();
+        addRequestSequence();
+        addSuccess(true);
+        addRunning();
+        addBody(body);
+    }
+};
 } // anonymous namespace
 
 void QV4DebugServiceImpl::addHandler(V4CommandHandler* handler)
@@ -671,6 +729,7 @@ QV4DebugServiceImpl::QV4DebugServiceImpl(QObject *parent) :
     addHandler(new V4SetExceptionBreakRequest);
     addHandler(new V4ScriptsRequest);
     addHandler(new V4EvaluateRequest);
+    addHandler(new V4HeapSnapshotRequest);
 }
 
 QV4DebugServiceImpl::~QV4DebugServiceImpl()
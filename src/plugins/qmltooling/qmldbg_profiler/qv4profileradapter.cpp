@@ -41,6 +41,11 @@ qint64 QV4ProfilerAdapter::appendMemoryEvents(qint64 until, QList<QByteArray> &m
     while (memoryData.size() > m_memoryPos && memoryData[m_memoryPos].timestamp <= until) {
         const QV4::Profiling::MemoryAllocationProperties &props = memoryData[m_memoryPos];
         d << props.timestamp << int(MemoryAllocation) << int(props.type) << props.size;
+        if (props.type == QV4::Profiling::SampledAllocation) {
+            const QV4::Profiling::AllocationSite &site = m_allocationSites.at(props.site);
+            d << site.count << site.location.file << site.location.line << site.location.column
+              << site.location.name;
+        }
         ++m_memoryPos;
         messages.append(d.squeezedData());
         d.clear();
@@ -64,6 +69,7 @@ qint64 QV4ProfilerAdapter::finalizeMessages(qint64 until, QList<QByteArray> &mes
 
     if (memoryNext == -1) {
         m_memoryData.clear();
+        m_allocationSites.clear();
         m_memoryPos = 0;
         return callNext;
     }
@@ -125,7 +131,8 @@ qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &message
 void QV4ProfilerAdapter::receiveData(
         const QV4::Profiling::FunctionLocationHash &locations,
         const QVector<QV4::Profiling::FunctionCallProperties> &functionCallData,
-        const QVector<QV4::Profiling::MemoryAllocationProperties> &memoryData)
+        const QVector<QV4::Profiling::MemoryAllocationProperties> &memoryData,
+        const QVector<QV4::Profiling::AllocationSite> &allocationSites)
 {
     // In rare cases it could be that another flush or stop event is processed while data from
     // the previous one is still pending. In that case we just append the data.
@@ -139,10 +146,18 @@ void QV4ProfilerAdapter::receiveData(
     else
         m_functionCallData.append(functionCallData);
 
-    if (m_memoryData.isEmpty())
+    // Sampled allocations refer to their sites by index
+    const int siteOffset = m_allocationSites.size();
+    if (m_memoryData.isEmpty() && siteOffset == 0) {
         m_memoryData = memoryData;
-    else
-        m_memoryData.append(memoryData);
+    } else {
+        for (QV4::Profiling::MemoryAllocationProperties props : memoryData) {
+            if (props.type == QV4::Profiling::SampledAllocation)
+                props.site += siteOffset;
+            m_memoryData.append(props);
+        }
+    }
+    m_allocationSites.append(allocationSites);
 
     service->dataReady(this);
 }
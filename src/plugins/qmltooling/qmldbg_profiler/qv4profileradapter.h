@@ -36,7 +36,8 @@ public:
 
     void receiveData(const QV4::Profiling::FunctionLocationHash &,
                      const QVector<QV4::Profiling::FunctionCallProperties> &,
-                     const QVector<QV4::Profiling::MemoryAllocationProperties> &);
+                     const QVector<QV4::Profiling::MemoryAllocationProperties> &,
+                     const QVector<QV4::Profiling::AllocationSite> &);
 
 Q_SIGNALS:
     void v4ProfilingEnabled(quint64 v4Features);
@@ -46,6 +47,7 @@ private:
     QV4::Profiling::FunctionLocationHash m_functionLocations;
     QVector<QV4::Profiling::FunctionCallProperties> m_functionCallData;
     QVector<QV4::Profiling::MemoryAllocationProperties> m_memoryData;
+    QVector<QV4::Profiling::AllocationSite> m_allocationSites;
     int m_functionCallPos;
     int m_memoryPos;
     QStack<qint64> m_stack;
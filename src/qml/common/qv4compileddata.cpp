@@ -7,6 +7,7 @@
 #include <private/qml_compile_hash_p.h>
 #include <private/qqmlscriptdata_p.h>
 #include <private/qqmltypenamecache_p.h>
+#include <private/qv4compilationunitbundle_p.h>
 #include <private/qv4resolvedtypereference_p.h>
 
 #include <QtQml/qqmlfile.h>
@@ -117,6 +118,7 @@ CompilationUnit::CompilationUnit(
 CompilationUnit::~CompilationUnit()
 {
     qDeleteAll(resolvedTypes);
+    delete literalBindingValues.loadRelaxed();
 
     if (data) {
         if (data->qmlUnit() != qmlData)
@@ -133,6 +135,17 @@ CompilationUnit::~CompilationUnit()
 #endif
 }
 
+void CompilationUnit::setLiteralBindingValues(LiteralBindingValues &&values)
+{
+    // Another engine may have validated the same unit already. Its values are the same.
+    if (values.isEmpty() || literalBindingValues.loadAcquire())
+        return;
+
+    const LiteralBindingValues *published = new LiteralBindingValues(std::move(values));
+    if (!literalBindingValues.testAndSetOrdered(nullptr, published))
+        delete published;
+}
+
 QString CompilationUnit::localCacheFilePath(const QUrl &url)
 {
     static const QByteArray envCachePath = qgetenv("QML_DISK_CACHE_PATH");
@@ -160,14 +173,8 @@ bool CompilationUnit::loadFromDisk(
     }
 
     const QString sourcePath = QQmlFile::urlToLocalFileOrQrc(url);
-    auto cacheFile = std::make_unique<CompilationUnitMapper>();
-
-    const QStringList cachePaths = { sourcePath + QLatin1Char('c'), localCacheFilePath(url) };
-    for (const QString &cachePath : cachePaths) {
-        Unit *mappedUnit = cacheFile->get(cachePath, sourceTimeStamp, errorString);
-        if (!mappedUnit)
-            continue;
 
+    const auto useMappedUnit = [&](const Unit *mappedUnit) {
         const Unit *oldData = unitData();
         const Unit * const oldDataPtr
                 = (oldData && !(oldData->flags & Unit::StaticData))
@@ -183,17 +190,36 @@ bool CompilationUnit::loadFromDisk(
             if (mappedUnit->sourceFileIndex >=
                 mappedUnit->stringTableSize + dynamicStrings.size()) {
                 *errorString = QStringLiteral("QML source file index is invalid.");
-                continue;
+                return false;
             }
             if (sourcePath !=
                 QQmlFile::urlToLocalFileOrQrc(stringAt(mappedUnit->sourceFileIndex))) {
                 *errorString = QStringLiteral("QML source file has moved to a different location.");
-                continue;
+                return false;
             }
         }
 
         dataPtrRevert.dismiss();
         free(const_cast<Unit*>(oldDataPtr));
+        return true;
+    };
+
+    // The bundle is mapped as a whole and stays mapped. There is no backing file to keep.
+    if (const CompilationUnitBundle *bundle = CompilationUnitBundle::instance()) {
+        if (const Unit *bundledUnit = bundle->get(sourcePath, sourceTimeStamp, errorString)) {
+            if (useMappedUnit(bundledUnit))
+                return true;
+        }
+    }
+
+    auto cacheFile = std::make_unique<CompilationUnitMapper>();
+
+    const QStringList cachePaths = { sourcePath + QLatin1Char('c'), localCacheFilePath(url) };
+    for (const QString &cachePath : cachePaths) {
+        Unit *mappedUnit = cacheFile->get(cachePath, sourceTimeStamp, errorString);
+        if (!mappedUnit || !useMappedUnit(mappedUnit))
+            continue;
+
         backingFile = std::move(cacheFile);
         return true;
     }
@@ -16,6 +16,7 @@
 
 #include <functional>
 
+#include <QtCore/qatomic.h>
 #include <QtCore/qcryptographichash.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qhashfunctions.h>
@@ -24,6 +25,7 @@
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
 #include <QtCore/qurl.h>
+#include <QtCore/qvariant.h>
 #include <QtCore/qvector.h>
 #include <QtCore/qversionnumber.h>
 
@@ -1499,6 +1501,13 @@ struct CompilationUnit final : public QQmlRefCounted<CompilationUnit>
 
     QVector<QQmlRefPointer<QQmlScriptData>> dependentScripts;
 
+    // Values of literal bindings that have to be parsed from strings, such as colors or points,
+    // by binding. They are parsed when validating the bindings on the type loader thread, so that
+    // creating objects doesn't have to. Published only once, as units can be shared between
+    // engines.
+    using LiteralBindingValues = QHash<const Binding *, QVariant>;
+    QAtomicPointer<const LiteralBindingValues> literalBindingValues;
+
 public:
     // --- interface for QQmlPropertyCacheCreator
     using CompiledObject = const CompiledData::Object;
@@ -1612,6 +1621,17 @@ public:
         return constants[binding->value.constantValueIndex].doubleValue();
     }
 
+    // The callers have to check that the value's type matches the property.
+    const QVariant *literalBindingValue(const CompiledData::Binding *binding) const
+    {
+        const LiteralBindingValues *values = literalBindingValues.loadAcquire();
+        if (!values)
+            return nullptr;
+        const auto it = values->constFind(binding);
+        return it == values->constEnd() ? nullptr : &*it;
+    }
+    void setLiteralBindingValues(LiteralBindingValues &&values);
+
     Q_QML_EXPORT static QString localCacheFilePath(const QUrl &url);
     Q_QML_EXPORT bool loadFromDisk(
             const QUrl &url, const QDateTime &sourceTimeStamp, QString *errorString);
@@ -114,6 +114,15 @@ void PlatformAssemblerCommon::link(Function *function, const char *jitKind)
         linkBuffer.patch(ehTarget.label, linkBuffer.locationOf(targetLabel));
     }
 
+    const auto loopEntryAddress = loopEntry.isSet()
+            ? linkBuffer.locationOf(loopEntry).executableAddress()
+            : nullptr;
+
+    std::vector<NativeCodeLine> lines;
+    lines.reserve(lineLabels.size());
+    for (const auto &lineLabel : lineLabels)
+        lines.push_back({ linkBuffer.offsetOf(lineLabel.label), lineLabel.line });
+
     JSC::MacroAssemblerCodeRef codeRef;
 
     static const bool showCode = lcAsm().isDebugEnabled();
@@ -133,13 +142,25 @@ void PlatformAssemblerCommon::link(Function *function, const char *jitKind)
         codeRef = linkBuffer.finalizeCodeWithoutDisassembly();
     }
 
+    // When replacing baseline code, keep it around. It may still be running further up the stack.
+    if (function->codeRef) {
+        Q_ASSERT(!function->supersededCodeRef);
+        function->supersededCodeRef = function->codeRef;
+    }
+    const Function::JittedCode previousCode = function->jittedCode;
+    const Function::JittedCode previousLoopEntry = function->jittedLoopEntry;
+
     function->codeRef = new JSC::MacroAssemblerCodeRef(codeRef);
     function->jittedCode = reinterpret_cast<Function::JittedCode>(function->codeRef->code().executableAddress());
+    function->jittedLoopEntry = reinterpret_cast<Function::JittedCode>(loopEntryAddress);
 
-    generateFunctionTable(function, &codeRef);
+    generateFunctionTable(function, &codeRef, lines);
 
-    if (Q_UNLIKELY(!linkBuffer.makeExecutable()))
-        function->jittedCode = nullptr; // The function is not executable, but the coderef exists.
+    // The function is not executable, but the coderef exists. Keep running the previous code, if any.
+    if (Q_UNLIKELY(!linkBuffer.makeExecutable())) {
+        function->jittedCode = previousCode;
+        function->jittedLoopEntry = previousLoopEntry;
+    }
 }
 
 void PlatformAssemblerCommon::prepareCallWithArgCount(int argc)
@@ -141,6 +141,7 @@ public:
     static const RegisterID StackPointerRegister  = RegisterID::esp;
     static const RegisterID FramePointerRegister  = RegisterID::ebp;
     static const FPRegisterID FPScratchRegister   = FPRegisterID::xmm1;
+    static const FPRegisterID FPScratchRegister2  = FPRegisterID::xmm2;
 
     static const RegisterID Arg0Reg = RegisterID::ecx;
     static const RegisterID Arg1Reg = RegisterID::edx;
@@ -321,6 +322,7 @@ public:
     static const RegisterID StackPointerRegister  = JSC::ARM64Registers::sp;
     static const RegisterID FramePointerRegister  = JSC::ARM64Registers::fp;
     static const FPRegisterID FPScratchRegister   = JSC::ARM64Registers::q1;
+    static const FPRegisterID FPScratchRegister2  = JSC::ARM64Registers::q2;
 
     static const RegisterID Arg0Reg = JSC::ARM64Registers::x0;
     static const RegisterID Arg1Reg = JSC::ARM64Registers::x1;
@@ -647,11 +649,22 @@ public:
             labelForOffset.insert(offset, label());
     }
 
+    // Marks where the code for the given line of JavaScript starts.
+    void addLineLabel(int line)
+    {
+        lineLabels.push_back({ label(), line });
+    }
+
     void addJumpToOffset(const Jump &jump, int offset)
     {
         jumpsToLink.push_back({ jump, offset });
     }
 
+    void markLoopEntry()
+    {
+        loopEntry = label();
+    }
+
     void addEHTarget(const DataLabelPtr &label, int offset)
     {
         ehTargets.push_back({ label, offset });
@@ -692,9 +705,12 @@ private:
     struct ExceptionHanlderTarget { JSC::MacroAssemblerBase::DataLabelPtr label; int offset; };
     std::vector<ExceptionHanlderTarget> ehTargets;
     QHash<int, JSC::MacroAssemblerBase::Label> labelForOffset;
+    struct LineLabel { JSC::MacroAssemblerBase::Label label; int line; };
+    std::vector<LineLabel> lineLabels;
     QHash<const void *, const char *> functions;
     std::vector<Jump> catchyJumps;
     Label functionExit;
+    Label loopEntry;
 
 #ifndef QT_NO_DEBUG
     enum { NoCall = -1 };
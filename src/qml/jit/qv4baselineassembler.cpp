@@ -32,6 +32,8 @@ namespace JIT {
 
 const QV4::Value::ValueTypeInternal IntegerTag = QV4::Value::ValueTypeInternal::Integer;
 
+enum class NumberOp { Add, Sub, Mul, Div };
+
 static ReturnedValue toNumberHelper(ReturnedValue v)
 {
     return Encode(Value::fromReturnedValue(v).toNumber());
@@ -338,6 +340,116 @@ public:
         return done;
     }
 
+    // Loads an integer or a double into target. Jumps to the returned Jump for other types.
+    Jump loadNumberAsDouble(RegisterID value, FPRegisterID target)
+    {
+        urshift64(value, TrustedImm32(32), ScratchRegister2);
+        Jump notInt = branch32(NotEqual, TrustedImm32(int(IntegerTag)), ScratchRegister2);
+        convertInt32ToDouble(value, target);
+        Jump done = jump();
+
+        notInt.link(this);
+        move(TrustedImm64(Value::DoubleMask), ScratchRegister2);
+        and64(value, ScratchRegister2);
+        Jump notDouble = branch64(LessThan, ScratchRegister2,
+                                  TrustedImm64(Value::DoubleDiscriminator));
+        move(TrustedImm64(Value::EncodeMask), ScratchRegister2);
+        xor64(value, ScratchRegister2);
+        move64ToDouble(ScratchRegister2, target);
+
+        done.link(this);
+        return notDouble;
+    }
+
+    // Like binopBothIntPath, but if inlineDoubles is set, numbers that are not both integers
+    // (or overflow the integer fast path) are handled by doublePath. It receives the lhs in
+    // FPScratchRegister and the accumulator in FPScratchRegister2. Without an intPath, two
+    // integers always take the slow path.
+    JumpList binopBothNumberPath(
+            Address lhsAddr, bool inlineDoubles, std::function<Jump(void)> intPath,
+            std::function<void(JumpList &done, JumpList &slowPath)> doublePath)
+    {
+        JumpList done;
+        if (!inlineDoubles) {
+            if (intPath)
+                done.append(binopBothIntPath(lhsAddr, intPath));
+            return done;
+        }
+
+        JumpList slowPath;
+        urshift64(AccumulatorRegister, TrustedImm32(32), ScratchRegister);
+        Jump accNotInt = branch32(NotEqual, TrustedImm32(int(IntegerTag)), ScratchRegister);
+        load64(lhsAddr, ScratchRegister);
+        urshift64(ScratchRegister, TrustedImm32(32), ScratchRegister2);
+        Jump lhsNotInt = branch32(NotEqual, TrustedImm32(int(IntegerTag)), ScratchRegister2);
+
+        // both integer
+        if (intPath) {
+            Jump failure = intPath();
+            done.append(jump());
+            if (failure.isSet())
+                failure.link(this);
+        } else {
+            slowPath.append(jump());
+        }
+
+        // at least one of them is not an integer, or the integer path overflowed
+        accNotInt.link(this);
+        lhsNotInt.link(this);
+        load64(lhsAddr, ScratchRegister);
+        slowPath.append(loadNumberAsDouble(ScratchRegister, FPScratchRegister));
+        slowPath.append(loadNumberAsDouble(AccumulatorRegister, FPScratchRegister2));
+        doublePath(done, slowPath);
+
+        // all other cases
+        slowPath.link(this);
+        return done;
+    }
+
+    JumpList binopNumberPath(Address lhsAddr, NumberOp op, bool inlineDoubles,
+                             std::function<Jump(void)> intPath)
+    {
+        return binopBothNumberPath(lhsAddr, inlineDoubles, intPath,
+                                   [this, op](JumpList &done, JumpList &slowPath) {
+            switch (op) {
+            case NumberOp::Add:
+                addDouble(FPScratchRegister2, FPScratchRegister);
+                break;
+            case NumberOp::Sub:
+                subDouble(FPScratchRegister2, FPScratchRegister);
+                break;
+            case NumberOp::Mul:
+                mulDouble(FPScratchRegister2, FPScratchRegister);
+                break;
+            case NumberOp::Div:
+                divDouble(FPScratchRegister2, FPScratchRegister);
+                break;
+            }
+
+            // NaNs need to be canonicalized. Leave that to the runtime.
+            slowPath.append(branchDouble(DoubleNotEqualOrUnordered,
+                                         FPScratchRegister, FPScratchRegister));
+            encodeDoubleIntoAccumulator(FPScratchRegister);
+            done.append(jump());
+        });
+    }
+
+    // Leaves 0 or 1 in the accumulator, to be tagged as boolean by the caller.
+    JumpList cmpNumberPath(Address lhsAddr, int doubleCond, bool inlineDoubles,
+                           std::function<Jump(void)> intPath)
+    {
+        return binopBothNumberPath(lhsAddr, inlineDoubles, intPath,
+                                   [this, doubleCond](JumpList &done, JumpList &) {
+            Jump isTrue = branchDouble(static_cast<DoubleCondition>(doubleCond),
+                                       FPScratchRegister, FPScratchRegister2);
+            move(TrustedImm32(0), AccumulatorRegister);
+            done.append(jump());
+            isTrue.link(this);
+            move(TrustedImm32(1), AccumulatorRegister);
+            done.append(jump());
+        });
+    }
+
     void callWithAccumulatorByValueAsFirstArgument(std::function<void()> doCall)
     {
         passAsArg(AccumulatorRegister, 0);
@@ -768,6 +880,20 @@ public:
         return done;
     }
 
+    // There is no inline double arithmetic on 32bit platforms.
+    JumpList binopNumberPath(Address lhsAddr, NumberOp, bool, std::function<Jump(void)> intPath)
+    {
+        JumpList done;
+        if (intPath)
+            done.append(binopBothIntPath(lhsAddr, intPath));
+        return done;
+    }
+
+    JumpList cmpNumberPath(Address lhsAddr, int, bool, std::function<Jump(void)> intPath)
+    {
+        return binopNumberPath(lhsAddr, NumberOp::Add, false, intPath);
+    }
+
     void callWithAccumulatorByValueAsFirstArgument(std::function<void()> doCall)
     {
         if (ArgInRegCount < 2) {
@@ -801,8 +927,11 @@ static Address regAddr(int reg)
     return Address(PlatformAssembler::JSStackFrameRegister, reg * int(sizeof(QV4::Value)));
 }
 
-BaselineAssembler::BaselineAssembler(const Value *constantTable)
+BaselineAssembler::BaselineAssembler(
+        const Value *constantTable, quint32 *arithmeticFeedback, bool numberFastPaths)
     : d(new PlatformAssembler(constantTable))
+    , arithmeticFeedback(arithmeticFeedback)
+    , numberFastPaths(numberFastPaths)
 {
 }
 
@@ -821,9 +950,43 @@ void BaselineAssembler::generateEpilogue()
     pasm()->generateCatchTrampoline();
 }
 
+void BaselineAssembler::generateLoopEntry(const QSet<int> &loopHeaders)
+{
+    if (loopHeaders.isEmpty())
+        return;
+
+    // Same prologue as the regular entry, but continue at the loop header the interpreter was
+    // about to execute. All other state is in the JS frame already.
+    pasm()->markLoopEntry();
+    pasm()->generateFunctionEntry();
+    loadAccumulatorFromFrame();
+    pasm()->load32(Address(PlatformAssembler::CppStackFrameRegister,
+                           offsetof(JSTypesStackFrame, instructionPointer)),
+                   PlatformAssembler::ScratchRegister);
+
+    QList<int> offsets(loopHeaders.begin(), loopHeaders.end());
+    const int last = offsets.takeLast();
+    for (int offset : std::as_const(offsets)) {
+        pasm()->addJumpToOffset(pasm()->branch32(PlatformAssembler::Equal,
+                                                 PlatformAssembler::ScratchRegister,
+                                                 TrustedImm32(offset)),
+                                offset);
+    }
+    pasm()->addJumpToOffset(pasm()->jump(), last);
+}
+
 void BaselineAssembler::link(Function *function)
 {
-    pasm()->link(function, "BaselineJIT");
+    pasm()->link(function, numberFastPaths ? "OptimizingJIT" : "BaselineJIT");
+}
+
+void BaselineAssembler::countGenericArithmetic()
+{
+    if (!arithmeticFeedback)
+        return;
+
+    pasm()->move(TrustedImmPtr(arithmeticFeedback), PlatformAssembler::ScratchRegister);
+    pasm()->add32(TrustedImm32(1), Address(PlatformAssembler::ScratchRegister));
 }
 
 void BaselineAssembler::addLabel(int offset)
@@ -831,6 +994,11 @@ void BaselineAssembler::addLabel(int offset)
     pasm()->addLabelForOffset(offset);
 }
 
+void BaselineAssembler::addLineLabel(int line)
+{
+    pasm()->addLineLabel(line);
+}
+
 void BaselineAssembler::loadConst(int constIndex)
 {
     //###
@@ -1020,7 +1188,7 @@ void BaselineAssembler::unot()
 
 void BaselineAssembler::add(int lhs)
 {
-    auto done = pasm()->binopBothIntPath(regAddr(lhs), [this](){
+    auto done = pasm()->binopNumberPath(regAddr(lhs), NumberOp::Add, numberFastPaths, [this](){
         auto overflowed = pasm()->branchAdd32(PlatformAssembler::Overflow,
                                               PlatformAssembler::AccumulatorRegisterValue,
                                               PlatformAssembler::ScratchRegister);
@@ -1030,6 +1198,7 @@ void BaselineAssembler::add(int lhs)
     });
 
     // slow path:
+    countGenericArithmetic();
     saveAccumulatorInFrame();
     pasm()->prepareCallWithArgCount(3);
     pasm()->passAccumulatorAsArg(2);
@@ -1173,16 +1342,40 @@ void BaselineAssembler::shlConst(int rhs)
 
 void BaselineAssembler::mul(int lhs)
 {
-    auto done = pasm()->binopBothIntPath(regAddr(lhs), [this](){
+    auto done = pasm()->binopNumberPath(regAddr(lhs), NumberOp::Mul, numberFastPaths, [this, lhs](){
         auto overflowed = pasm()->branchMul32(PlatformAssembler::Overflow,
                                               PlatformAssembler::AccumulatorRegisterValue,
                                               PlatformAssembler::ScratchRegister);
+
+        // A zero product with a negative operand is -0, which is not an integer.
+        auto notZero = pasm()->branchTest32(PlatformAssembler::NonZero,
+                                            PlatformAssembler::ScratchRegister);
+        auto rhsNegative = pasm()->branch32(PlatformAssembler::LessThan,
+                                            PlatformAssembler::AccumulatorRegisterValue,
+                                            TrustedImm32(0));
+        Address lhsValue = regAddr(lhs);
+        lhsValue.offset += Value::valueOffset();
+        pasm()->load32(lhsValue, PlatformAssembler::ScratchRegister);
+        auto lhsNegative = pasm()->branch32(PlatformAssembler::LessThan,
+                                            PlatformAssembler::ScratchRegister,
+                                            TrustedImm32(0));
+        pasm()->move(TrustedImm32(0), PlatformAssembler::ScratchRegister);
+        notZero.link(pasm());
+
         pasm()->setAccumulatorTag(IntegerTag,
                                   PlatformAssembler::ScratchRegister);
-        return overflowed;
+        auto isInteger = pasm()->jump();
+
+        overflowed.link(pasm());
+        rhsNegative.link(pasm());
+        lhsNegative.link(pasm());
+        auto failure = pasm()->jump();
+        isInteger.link(pasm());
+        return failure;
     });
 
     // slow path:
+    countGenericArithmetic();
     saveAccumulatorInFrame();
     pasm()->prepareCallWithArgCount(2);
     pasm()->passAccumulatorAsArg(1);
@@ -1196,12 +1389,20 @@ void BaselineAssembler::mul(int lhs)
 
 void BaselineAssembler::div(int lhs)
 {
+    // Integer division is left to the runtime, which knows when the result fits an integer.
+    auto done = pasm()->binopNumberPath(regAddr(lhs), NumberOp::Div, numberFastPaths, nullptr);
+
+    // slow path:
+    countGenericArithmetic();
     saveAccumulatorInFrame();
     pasm()->prepareCallWithArgCount(2);
     pasm()->passAccumulatorAsArg(1);
     pasm()->passJSSlotAsArg(lhs, 0);
     ASM_GENERATE_RUNTIME_CALL(Div, CallResultDestination::InAccumulator);
     checkException();
+
+    // done.
+    done.link(pasm());
 }
 
 void BaselineAssembler::mod(int lhs)
@@ -1216,7 +1417,7 @@ void BaselineAssembler::mod(int lhs)
 
 void BaselineAssembler::sub(int lhs)
 {
-    auto done = pasm()->binopBothIntPath(regAddr(lhs), [this](){
+    auto done = pasm()->binopNumberPath(regAddr(lhs), NumberOp::Sub, numberFastPaths, [this](){
         auto overflowed = pasm()->branchSub32(PlatformAssembler::Overflow,
                                               PlatformAssembler::AccumulatorRegisterValue,
                                               PlatformAssembler::ScratchRegister);
@@ -1226,6 +1427,7 @@ void BaselineAssembler::sub(int lhs)
     });
 
     // slow path:
+    countGenericArithmetic();
     saveAccumulatorInFrame();
     pasm()->prepareCallWithArgCount(2);
     pasm()->passAccumulatorAsArg(1);
@@ -1298,10 +1500,10 @@ void BaselineAssembler::cmpneInt(int lhs)
     done.link(pasm());
 }
 
-void BaselineAssembler::cmp(int cond, CmpFunc function, int lhs)
+void BaselineAssembler::cmp(int cond, int doubleCond, CmpFunc function, int lhs)
 {
     auto c = static_cast<PlatformAssembler::RelationalCondition>(cond);
-    auto done = pasm()->binopBothIntPath(regAddr(lhs), [this, c](){
+    auto done = pasm()->cmpNumberPath(regAddr(lhs), doubleCond, numberFastPaths, [this, c](){
         pasm()->compare32(c, PlatformAssembler::ScratchRegister,
                           PlatformAssembler::AccumulatorRegisterValue,
                           PlatformAssembler::AccumulatorRegisterValue);
@@ -1309,6 +1511,7 @@ void BaselineAssembler::cmp(int cond, CmpFunc function, int lhs)
     });
 
     // slow path:
+    countGenericArithmetic();
     saveAccumulatorInFrame();
     pasm()->prepareCallWithArgCount(2);
     pasm()->passAccumulatorAsArg(1);
@@ -1324,42 +1527,50 @@ void BaselineAssembler::cmp(int cond, CmpFunc function, int lhs)
 
 void BaselineAssembler::cmpeq(int lhs)
 {
-    cmp(PlatformAssembler::Equal, &Runtime::CompareEqual::call, lhs);
+    cmp(PlatformAssembler::Equal, PlatformAssembler::DoubleEqual,
+        &Runtime::CompareEqual::call, lhs);
 }
 
 void BaselineAssembler::cmpne(int lhs)
 {
-    cmp(PlatformAssembler::NotEqual, &Runtime::CompareNotEqual::call, lhs);
+    cmp(PlatformAssembler::NotEqual, PlatformAssembler::DoubleNotEqualOrUnordered,
+        &Runtime::CompareNotEqual::call, lhs);
 }
 
 void BaselineAssembler::cmpgt(int lhs)
 {
-    cmp(PlatformAssembler::GreaterThan, &Runtime::CompareGreaterThan::call, lhs);
+    cmp(PlatformAssembler::GreaterThan, PlatformAssembler::DoubleGreaterThan,
+        &Runtime::CompareGreaterThan::call, lhs);
 }
 
 void BaselineAssembler::cmpge(int lhs)
 {
-    cmp(PlatformAssembler::GreaterThanOrEqual, &Runtime::CompareGreaterEqual::call, lhs);
+    cmp(PlatformAssembler::GreaterThanOrEqual, PlatformAssembler::DoubleGreaterThanOrEqual,
+        &Runtime::CompareGreaterEqual::call, lhs);
 }
 
 void BaselineAssembler::cmplt(int lhs)
 {
-    cmp(PlatformAssembler::LessThan, &Runtime::CompareLessThan::call, lhs);
+    cmp(PlatformAssembler::LessThan, PlatformAssembler::DoubleLessThan,
+        &Runtime::CompareLessThan::call, lhs);
 }
 
 void BaselineAssembler::cmple(int lhs)
 {
-    cmp(PlatformAssembler::LessThanOrEqual, &Runtime::CompareLessEqual::call, lhs);
+    cmp(PlatformAssembler::LessThanOrEqual, PlatformAssembler::DoubleLessThanOrEqual,
+        &Runtime::CompareLessEqual::call, lhs);
 }
 
 void BaselineAssembler::cmpStrictEqual(int lhs)
 {
-    cmp(PlatformAssembler::Equal, &Runtime::CompareStrictEqual::call, lhs);
+    cmp(PlatformAssembler::Equal, PlatformAssembler::DoubleEqual,
+        &Runtime::CompareStrictEqual::call, lhs);
 }
 
 void BaselineAssembler::cmpStrictNotEqual(int lhs)
 {
-    cmp(PlatformAssembler::NotEqual, &Runtime::CompareStrictNotEqual::call, lhs);
+    cmp(PlatformAssembler::NotEqual, PlatformAssembler::DoubleNotEqualOrUnordered,
+        &Runtime::CompareStrictNotEqual::call, lhs);
 }
 
 int BaselineAssembler::jump(int offset)
@@ -1510,6 +1721,25 @@ void BaselineAssembler::checkException()
     pasm()->checkException();
 }
 
+void BaselineAssembler::checkExecutionBudget()
+{
+    Address countdown(PlatformAssembler::EngineRegister,
+                      offsetof(EngineBase, executionBudgetCountdown));
+    pasm()->load32(countdown, PlatformAssembler::ScratchRegister);
+    pasm()->sub32(TrustedImm32(1), PlatformAssembler::ScratchRegister);
+    pasm()->store32(PlatformAssembler::ScratchRegister, countdown);
+    auto withinBudget = pasm()->branch32(
+            PlatformAssembler::GreaterThan, PlatformAssembler::ScratchRegister, TrustedImm32(0));
+    saveAccumulatorInFrame();
+    // if it ran out, let the engine check the time
+    pasm()->prepareCallWithArgCount(1);
+    pasm()->passEngineAsArg(0);
+    ASM_GENERATE_RUNTIME_CALL(CheckExecutionBudget, CallResultDestination::Ignore);
+    checkException();
+    loadAccumulatorFromFrame();
+    withinBudget.link(pasm());
+}
+
 void BaselineAssembler::gotoCatchException()
 {
     pasm()->addCatchyJump(pasm()->jump());
@@ -34,14 +34,19 @@ namespace JIT {
 
 class BaselineAssembler {
 public:
-    BaselineAssembler(const Value* constantTable);
+    // Baseline code counts generic arithmetic in arithmeticFeedback. Optimized code handles
+    // doubles inline instead.
+    BaselineAssembler(const Value* constantTable, quint32 *arithmeticFeedback = nullptr,
+                      bool numberFastPaths = false);
     ~BaselineAssembler();
 
     // codegen infrastructure
     void generatePrologue();
     void generateEpilogue();
+    void generateLoopEntry(const QSet<int> &loopHeaders);
     void link(Function *function);
     void addLabel(int offset);
+    void addLineLabel(int line);
 
     // loads/stores/moves
     void loadConst(int constIndex);
@@ -120,6 +125,7 @@ public:
 
     // exception/context stuff
     void checkException();
+    void checkExecutionBudget();
     void gotoCatchException();
     void getException();
     void setException();
@@ -139,7 +145,11 @@ protected:
 
 private:
     typedef unsigned(*CmpFunc)(const Value&,const Value&);
-    void cmp(int cond, CmpFunc function, int lhs);
+    void cmp(int cond, int doubleCond, CmpFunc function, int lhs);
+    void countGenericArithmetic();
+
+    quint32 *arithmeticFeedback;
+    bool numberFastPaths;
 };
 
 } // namespace JIT
@@ -5,6 +5,7 @@
 #include "qv4baselineassembler_p.h"
 #include <private/qv4lookup_p.h>
 #include <private/qv4generatorobject_p.h>
+#include <private/qv4functiontable_p.h>
 
 #if QT_CONFIG(qml_jit)
 
@@ -13,9 +14,11 @@ using namespace QV4;
 using namespace QV4::JIT;
 using namespace QV4::Moth;
 
-BaselineJIT::BaselineJIT(Function *function)
+BaselineJIT::BaselineJIT(Function *function, Tier tier)
     : function(function)
-      , as(new BaselineAssembler(&(function->compilationUnit->constants->asValue<Value>())))
+      , as(new BaselineAssembler(&(function->compilationUnit->constants->asValue<Value>()),
+                                 tier == Tier::Baseline ? &function->arithmeticFeedback : nullptr,
+                                 tier == Tier::Optimized))
 {}
 
 BaselineJIT::~BaselineJIT()
@@ -30,11 +33,17 @@ void BaselineJIT::generate()
     for (unsigned i = 0, ei = function->compiledFunction->nLabelInfos; i != ei; ++i)
         labels.insert(int(function->compiledFunction->labelInfoTable()[i]));
 
+    if (functionTableNeedsLines()) {
+        nextLine = function->compiledFunction->lineAndStatementNumberTable();
+        linesEnd = nextLine + function->compiledFunction->nLineAndStatementNumbers;
+    }
+
     as->generatePrologue();
     // Make sure the ACC register is initialized and not clobbered by the caller.
     as->loadAccumulatorFromFrame();
     decode(code, len);
     as->generateEpilogue();
+    as->generateLoopEntry(loopHeaders);
 
     as->link(function);
 //    qDebug()<<"done";
@@ -760,16 +769,22 @@ void BaselineJIT::generate_ToObject()
 
 void BaselineJIT::generate_Jump(int offset)
 {
+    if (offset < 0)
+        loopHeaders.insert(absoluteOffset(offset));
     labels.insert(as->jump(absoluteOffset(offset)));
 }
 
 void BaselineJIT::generate_JumpTrue(int offset)
 {
+    if (offset < 0)
+        loopHeaders.insert(absoluteOffset(offset));
     labels.insert(as->jumpTrue(absoluteOffset(offset)));
 }
 
 void BaselineJIT::generate_JumpFalse(int offset)
 {
+    if (offset < 0)
+        loopHeaders.insert(absoluteOffset(offset));
     labels.insert(as->jumpFalse(absoluteOffset(offset)));
 }
 
@@ -786,6 +801,8 @@ void BaselineJIT::generate_JumpNotUndefined(int offset)
 void BaselineJIT::generate_CheckException()
 {
     as->checkException();
+    // The code generator emits this once per loop iteration.
+    as->checkExecutionBudget();
 }
 
 void BaselineJIT::generate_CmpEqNull() { as->cmpeqNull(); }
@@ -908,6 +925,14 @@ ByteCodeHandler::Verdict BaselineJIT::startInstruction(Instr::Type /*instr*/)
 {
     if (labels.contains(currentInstructionOffset()))
         as->addLabel(currentInstructionOffset());
+
+    const CompiledData::CodeOffsetToLineAndStatement *line = nullptr;
+    while (nextLine != linesEnd && int(nextLine->codeOffset) <= currentInstructionOffset())
+        line = nextLine++;
+    // Debug instructions have negative line numbers.
+    if (line && line->line > 0)
+        as->addLineLabel(line->line);
+
     return ProcessInstruction;
 }
 
@@ -33,7 +33,11 @@ class BaselineAssembler;
 class BaselineJIT final: public Moth::ByteCodeHandler
 {
 public:
-    Q_AUTOTEST_EXPORT BaselineJIT(QV4::Function *);
+    // The optimizing tier reuses the baseline code generator, but handles arithmetic and
+    // comparisons on doubles inline. The guards fall back to the same runtime calls.
+    enum class Tier { Baseline, Optimized };
+
+    Q_AUTOTEST_EXPORT BaselineJIT(QV4::Function *, Tier tier = Tier::Baseline);
     Q_AUTOTEST_EXPORT ~BaselineJIT() override;
 
     Q_AUTOTEST_EXPORT void generate();
@@ -180,6 +184,11 @@ private:
     QV4::Function *function;
     QScopedPointer<BaselineAssembler> as;
     QSet<int> labels;
+    // Line table entries not reached yet, if the code is to be annotated with lines
+    const CompiledData::CodeOffsetToLineAndStatement *nextLine = nullptr;
+    const CompiledData::CodeOffsetToLineAndStatement *linesEnd = nullptr;
+    // Targets of backward jumps. The interpreter can switch over to the jitted code there.
+    QSet<int> loopHeaders;
 };
 
 } // namespace JIT
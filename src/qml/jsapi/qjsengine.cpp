@@ -1248,6 +1248,11 @@ void QJSEnginePrivate::removeFromDebugServer(QJSEngine *q)
         server->removeEngine(q);
 }
 
+size_t QJSEnginePrivate::releaseUnusedMemory(QJSEngine *q)
+{
+    return q->handle()->memoryManager->releaseUnusedMemory().released;
+}
+
 /*!
    \since 5.5
    \relates QJSEngine
@@ -45,6 +45,11 @@ public:
     static void addToDebugServer(QJSEngine *q);
     static void removeFromDebugServer(QJSEngine *q);
 
+    // Collects garbage and hands free heap pages back to the operating system, for
+    // applications that become idle after a phase of high memory usage. Returns the number
+    // of bytes released.
+    static size_t releaseUnusedMemory(QJSEngine *q);
+
     void uiLanguageChanged() { Q_Q(QJSEngine); if (q) q->uiLanguageChanged(); }
     Q_OBJECT_BINDABLE_PROPERTY(QJSEnginePrivate, QString, uiLanguage, &QJSEnginePrivate::uiLanguageChanged);
 };
@@ -50,6 +50,13 @@ struct Q_QML_EXPORT SharedArrayBuffer : Object {
 
     bool arrayDataNeedsDetach() const noexcept { return constArrayDataPointer().needsDetach(); }
 
+    // Returns a QByteArray that refers to the same memory, without copying it. Writes through
+    // either of them are visible in the other.
+    QByteArray sharedArrayData() noexcept
+    {
+        return QByteArray(QByteArray::DataPointer(arrayDataPointer()));
+    }
+
 private:
     const QArrayDataPointer<const char> &constArrayDataPointer() const noexcept
     {
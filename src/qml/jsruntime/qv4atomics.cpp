@@ -5,8 +5,38 @@
 #include "qv4atomics_p.h"
 #include "qv4symbol_p.h"
 
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qwaitcondition.h>
+
+#include <cmath>
+#include <limits>
+
 using namespace QV4;
 
+namespace {
+
+// Agents blocked in Atomics.wait(). Shared memory is shared between engines, so this is process
+// wide. Waiters are kept in the order they started waiting, which is the order notify() wakes
+// them up in.
+struct Waiter
+{
+    const char *address = nullptr;
+    QWaitCondition condition;
+    bool notified = false;
+};
+
+struct WaiterList
+{
+    QMutex mutex;
+    QList<Waiter *> waiters;
+};
+
+Q_GLOBAL_STATIC(WaiterList, waiterList)
+
+} // namespace
+
 DEFINE_OBJECT_VTABLE(Atomics);
 
 void Heap::Atomics::init()
@@ -21,11 +51,13 @@ void Heap::Atomics::init()
     m->defineDefaultProperty(QStringLiteral("exchange"), QV4::Atomics::method_exchange, 3);
     m->defineDefaultProperty(QStringLiteral("isLockFree"), QV4::Atomics::method_isLockFree, 1);
     m->defineDefaultProperty(QStringLiteral("load"), QV4::Atomics::method_load, 2);
+    m->defineDefaultProperty(QStringLiteral("notify"), QV4::Atomics::method_notify, 3);
     m->defineDefaultProperty(QStringLiteral("or"), QV4::Atomics::method_or, 3);
     m->defineDefaultProperty(QStringLiteral("store"), QV4::Atomics::method_store, 3);
     m->defineDefaultProperty(QStringLiteral("sub"), QV4::Atomics::method_sub, 3);
     m->defineDefaultProperty(QStringLiteral("wait"), QV4::Atomics::method_wait, 4);
-    m->defineDefaultProperty(QStringLiteral("wake"), QV4::Atomics::method_wake, 3);
+    // "wake" is the name notify() had in ECMAScript 2017.
+    m->defineDefaultProperty(QStringLiteral("wake"), QV4::Atomics::method_notify, 3);
     m->defineDefaultProperty(QStringLiteral("xor"), QV4::Atomics::method_xor, 3);
 
     ScopedString name(scope, scope.engine->newString(QStringLiteral("Atomics")));
@@ -204,14 +236,116 @@ ReturnedValue Atomics::method_sub(const FunctionObject *f, const Value *, const
     return atomicReadModifyWrite(f, argv, argc, AtomicSub);
 }
 
-ReturnedValue Atomics::method_wait(const FunctionObject *f, const Value *, const Value *, int)
+ReturnedValue Atomics::method_wait(const FunctionObject *f, const Value *, const Value *argv, int argc)
 {
-    return f->engine()->throwTypeError();
+    Scope scope(f);
+    if (!argc)
+        return scope.engine->throwTypeError();
+
+    SharedArrayBuffer *buffer = validateSharedIntegerTypedArray(scope, argv[0], true);
+    if (!buffer)
+        return Encode::undefined();
+    const TypedArray &a = static_cast<const TypedArray &>(argv[0]);
+    int index = validateAtomicAccess(scope, a, argc > 1 ? argv[1] : Value::undefinedValue());
+    if (index < 0)
+        return Encode::undefined();
+
+    const int expected = (argc > 2 ? argv[2] : Value::undefinedValue()).toInt32();
+    if (scope.hasException())
+        return Encode::undefined();
+
+    double timeout = argc > 3 ? argv[3].toNumber() : qInf();
+    if (scope.hasException())
+        return Encode::undefined();
+    if (std::isnan(timeout))
+        timeout = qInf();
+    timeout = std::max(timeout, 0.);
+
+    // Blocking the GUI thread would freeze the application. The specification leaves it to the
+    // host to decide which agents can suspend.
+    if (QThread::isMainThread())
+        return scope.engine->throwTypeError(QStringLiteral("Atomics.wait cannot be called on the main thread."));
+
+    int bytesPerElement = a.d()->type->bytesPerElement;
+    int byteOffset = a.d()->byteOffset + index * bytesPerElement;
+    char *address = buffer->arrayData() + byteOffset;
+
+    QDeadlineTimer deadline(QDeadlineTimer::Forever);
+    if (timeout < double(std::numeric_limits<qint64>::max()))
+        deadline.setRemainingTime(qint64(std::ceil(timeout)));
+
+    Waiter waiter;
+    waiter.address = address;
+    bool equal = true;
+    {
+        WaiterList *list = waiterList();
+        QMutexLocker locker(&list->mutex);
+
+        // Checked while holding the lock, so that a notify() in between cannot get lost.
+        const Value current = Value::fromReturnedValue(a.d()->type->atomicLoad(address));
+        equal = current.toInt32() == expected;
+        if (equal) {
+            list->waiters.append(&waiter);
+            while (!waiter.notified) {
+                if (!waiter.condition.wait(&list->mutex, deadline))
+                    break;
+            }
+            if (!waiter.notified)
+                list->waiters.removeOne(&waiter);
+        }
+    }
+
+    if (!equal)
+        return scope.engine->newString(QStringLiteral("not-equal"))->asReturnedValue();
+    return scope.engine->newString(waiter.notified ? QStringLiteral("ok")
+                                                   : QStringLiteral("timed-out"))
+            ->asReturnedValue();
 }
 
-ReturnedValue Atomics::method_wake(const FunctionObject *f, const Value *, const Value *, int)
+ReturnedValue Atomics::method_notify(const FunctionObject *f, const Value *, const Value *argv, int argc)
 {
-    return f->engine()->throwTypeError();
+    Scope scope(f);
+    if (!argc)
+        return scope.engine->throwTypeError();
+
+    const TypedArray *a = argv[0].as<TypedArray>();
+    if (!a || TypedArrayType(a->arrayType()) != TypedArrayType::Int32Array)
+        return scope.engine->throwTypeError();
+    int index = validateAtomicAccess(scope, *a, argc > 1 ? argv[1] : Value::undefinedValue());
+    if (index < 0)
+        return Encode::undefined();
+
+    double count = qInf();
+    if (argc > 2 && !argv[2].isUndefined()) {
+        count = std::max(argv[2].toInteger(), 0.);
+        if (scope.hasException())
+            return Encode::undefined();
+    }
+
+    // Nobody can wait on memory that is not shared.
+    Scoped<SharedArrayBuffer> buffer(scope, a->d()->buffer);
+    if (!buffer->isSharedArrayBuffer())
+        return Encode(0);
+
+    int bytesPerElement = a->d()->type->bytesPerElement;
+    int byteOffset = a->d()->byteOffset + index * bytesPerElement;
+    const char *address = buffer->arrayData() + byteOffset;
+
+    int woken = 0;
+    WaiterList *list = waiterList();
+    QMutexLocker locker(&list->mutex);
+    for (auto it = list->waiters.begin(); it != list->waiters.end() && woken < count;) {
+        Waiter *waiter = *it;
+        if (waiter->address != address) {
+            ++it;
+            continue;
+        }
+        waiter->notified = true;
+        waiter->condition.wakeOne();
+        it = list->waiters.erase(it);
+        ++woken;
+    }
+    return Encode(woken);
 }
 
 ReturnedValue Atomics::method_xor(const FunctionObject *f, const Value *, const Value *argv, int argc)
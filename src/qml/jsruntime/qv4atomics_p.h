@@ -39,11 +39,11 @@ struct Atomics : Object
     static ReturnedValue method_exchange(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_isLockFree(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_load(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
+    static ReturnedValue method_notify(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_or(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_store(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_sub(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_wait(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
-    static ReturnedValue method_wake(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_xor(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
 };
 
@@ -0,0 +1,203 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qv4compilationunitbundle_p.h"
+
+#include <private/qv4compileddata_p.h>
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatetime.h>
+#if QT_CONFIG(temporaryfile)
+#include <QtCore/qsavefile.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QV4;
+
+static quint64 alignedUnitOffset(quint64 offset)
+{
+    return (offset + CompilationUnitBundle::UnitAlignment - 1)
+            & ~quint64(CompilationUnitBundle::UnitAlignment - 1);
+}
+
+const CompilationUnitBundle *CompilationUnitBundle::instance()
+{
+    static const CompilationUnitBundle *bundle = []() -> const CompilationUnitBundle * {
+        const QString fileName = qEnvironmentVariable("QML_DISK_CACHE_BUNDLE");
+        if (fileName.isEmpty())
+            return nullptr;
+
+        // Never destroyed, as the units are used without copying them.
+        auto *bundle = new CompilationUnitBundle;
+        QString errorString;
+        if (!bundle->open(fileName, &errorString)) {
+            qWarning("Cannot use QML disk cache bundle %s: %s",
+                     qPrintable(fileName), qPrintable(errorString));
+            delete bundle;
+            return nullptr;
+        }
+        return bundle;
+    }();
+    return bundle;
+}
+
+bool CompilationUnitBundle::open(const QString &fileName, QString *errorString)
+{
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        *errorString = m_file.errorString();
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < qint64(sizeof(Header))) {
+        *errorString = QStringLiteral("File too small for the header fields");
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        *errorString = m_file.errorString();
+        return false;
+    }
+
+    const Header *header = reinterpret_cast<const Header *>(m_data);
+    if (memcmp(header->magic, magic, sizeof(magic)) != 0) {
+        *errorString = QStringLiteral("Magic bytes in the header do not match");
+        return false;
+    }
+
+    if (header->version != quint32(QV4_DATA_STRUCTURE_VERSION)) {
+        *errorString = QString::fromUtf8("V4 data structure version mismatch. Found %1 expected %2")
+                               .arg(header->version, 0, 16).arg(QV4_DATA_STRUCTURE_VERSION, 0, 16);
+        return false;
+    }
+
+    if (header->qtVersion != quint32(QT_VERSION)) {
+        *errorString = QString::fromUtf8("Qt version mismatch. Found %1 expected %2")
+                               .arg(header->qtVersion, 0, 16).arg(QT_VERSION, 0, 16);
+        return false;
+    }
+
+    if (quint64(header->entryCount) * sizeof(Entry) > quint64(m_size) - sizeof(Header)) {
+        *errorString = QStringLiteral("Potential file corruption, file too small");
+        return false;
+    }
+
+    m_entries = reinterpret_cast<const Entry *>(m_data + sizeof(Header));
+    m_entryCount = header->entryCount;
+    return true;
+}
+
+const CompiledData::Unit *CompilationUnitBundle::get(
+        const QString &sourcePath, const QDateTime &sourceTimeStamp, QString *errorString) const
+{
+    const QByteArray hash = pathHash(sourcePath);
+    Q_ASSERT(hash.size() == sizeof(Entry::pathHash));
+
+    const Entry *end = m_entries + m_entryCount;
+    const Entry *entry = std::lower_bound(
+            m_entries, end, hash, [](const Entry &entry, const QByteArray &hash) {
+        return memcmp(entry.pathHash, hash.constData(), sizeof(Entry::pathHash)) < 0;
+    });
+
+    if (entry == end || memcmp(entry->pathHash, hash.constData(), sizeof(Entry::pathHash)) != 0) {
+        *errorString = QStringLiteral("File is not part of the bundle");
+        return nullptr;
+    }
+
+    if (entry->offset % UnitAlignment != 0 || entry->size < sizeof(CompiledData::Unit)
+            || quint64(entry->offset) + entry->size > quint64(m_size)) {
+        *errorString = QStringLiteral("Potential file corruption, invalid bundle entry");
+        return nullptr;
+    }
+
+    const auto *unit = reinterpret_cast<const CompiledData::Unit *>(m_data + entry->offset);
+    if (!unit->verifyHeader(sourceTimeStamp, errorString))
+        return nullptr;
+
+    if (unit->unitSize != entry->size) {
+        *errorString = QStringLiteral("Potential file corruption, unit size mismatch");
+        return nullptr;
+    }
+
+    if (!(unit->flags & CompiledData::Unit::StaticData)) {
+        *errorString = QStringLiteral("Bundled unit is not static data");
+        return nullptr;
+    }
+
+    return unit;
+}
+
+QByteArray CompilationUnitBundle::pathHash(const QString &sourcePath)
+{
+    return QCryptographicHash::hash(sourcePath.toUtf8(), QCryptographicHash::Sha1);
+}
+
+bool CompilationUnitBundle::write(
+        const QString &fileName, const QMap<QString, QByteArray> &units, QString *errorString)
+{
+#if QT_CONFIG(temporaryfile)
+    QMap<QByteArray, QByteArray> sorted;
+    for (auto it = units.constBegin(), end = units.constEnd(); it != end; ++it)
+        sorted.insert(pathHash(it.key()), it.value());
+
+    Header header;
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = QV4_DATA_STRUCTURE_VERSION;
+    header.qtVersion = QT_VERSION;
+    header.entryCount = quint32(sorted.size());
+    header.reserved = 0;
+
+    QByteArray entries;
+    entries.reserve(sorted.size() * sizeof(Entry));
+    quint64 offset = alignedUnitOffset(sizeof(Header) + sorted.size() * sizeof(Entry));
+    for (auto it = sorted.constBegin(), end = sorted.constEnd(); it != end; ++it) {
+        if (offset + it.value().size() > std::numeric_limits<quint32>::max()) {
+            *errorString = QStringLiteral("Bundle exceeds 4GB");
+            return false;
+        }
+
+        Entry entry;
+        memcpy(entry.pathHash, it.key().constData(), sizeof(entry.pathHash));
+        entry.offset = quint32(offset);
+        entry.size = quint32(it.value().size());
+        entries.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        offset = alignedUnitOffset(offset + it.value().size());
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(entries);
+    for (const QByteArray &unit : std::as_const(sorted)) {
+        const qint64 padding = alignedUnitOffset(file.pos()) - file.pos();
+        file.write(QByteArray(padding, '\0'));
+        file.write(unit);
+    }
+
+    if (!file.commit()) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    errorString->clear();
+    return true;
+#else
+    Q_UNUSED(fileName);
+    Q_UNUSED(units);
+    *errorString = QStringLiteral("features.temporaryfile is disabled.");
+    return false;
+#endif
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,89 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QV4COMPILATIONUNITBUNDLE_P_H
+#define QV4COMPILATIONUNITBUNDLE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qv4global_p.h>
+
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qmap.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+
+namespace CompiledData {
+struct Unit;
+}
+
+// A single file holding the compilation units of many QML and JavaScript files. The units are
+// found by the SHA1 hash of their local source path, the same one localCacheFilePath() uses.
+// The file is mapped once, and never unmapped. Like cache files, bundled units have to be
+// built with the StaticData flag.
+//
+// Layout: Header, Entry[entryCount] sorted by pathHash, units aligned to UnitAlignment.
+class Q_QML_EXPORT CompilationUnitBundle
+{
+    Q_DISABLE_COPY_MOVE(CompilationUnitBundle)
+public:
+    static constexpr char magic[8] = { 'q', 'v', '4', 'b', 'n', 'd', 'l', '\0' };
+    static constexpr quint32 UnitAlignment = 16;
+
+    struct Header {
+        char magic[8];
+        quint32_le version;
+        quint32_le qtVersion;
+        quint32_le entryCount;
+        quint32_le reserved;
+    };
+    static_assert(sizeof(Header) == 24, "Header structure needs to have the expected size");
+
+    struct Entry {
+        char pathHash[20];
+        quint32_le offset;
+        quint32_le size;
+    };
+    static_assert(sizeof(Entry) == 28, "Entry structure needs to have the expected size");
+
+    CompilationUnitBundle() = default;
+
+    // The bundle given by QML_DISK_CACHE_BUNDLE, or nullptr.
+    static const CompilationUnitBundle *instance();
+
+    bool open(const QString &fileName, QString *errorString);
+    const CompiledData::Unit *get(
+            const QString &sourcePath, const QDateTime &sourceTimeStamp,
+            QString *errorString) const;
+
+    static QByteArray pathHash(const QString &sourcePath);
+
+    // Writes the units in \a units, keyed by their local source paths.
+    static bool write(const QString &fileName, const QMap<QString, QByteArray> &units,
+                      QString *errorString);
+
+private:
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    const Entry *m_entries = nullptr;
+    quint32 m_entryCount = 0;
+};
+
+}
+
+QT_END_NAMESPACE
+
+#endif // QV4COMPILATIONUNITBUNDLE_P_H
@@ -63,6 +63,7 @@
 #include "qv4qobjectwrapper_p.h"
 #include "qv4qmetaobjectwrapper_p.h"
 #include "qv4memberdata_p.h"
+#include "qv4lookup_p.h"
 #include "qv4arraybuffer_p.h"
 #include "qv4dataview_p.h"
 #include "qv4promiseobject_p.h"
@@ -93,6 +94,12 @@
 #include <valgrind/memcheck.h>
 #endif
 
+#if defined(Q_OS_WIN)
+#  include <qt_windows.h>
+#elif defined(Q_OS_UNIX)
+#  include <time.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 DEFINE_BOOL_CONFIG_OPTION(disableDiskCache, QML_DISABLE_DISK_CACHE);
@@ -100,6 +107,32 @@ DEFINE_BOOL_CONFIG_OPTION(forceDiskCache, QML_FORCE_DISK_CACHE);
 
 using namespace QV4;
 
+Q_STATIC_LOGGING_CATEGORY(lcExecutionBudget, "qt.qml.executionbudget.statistics")
+
+// Reading the clock on every loop iteration would be too expensive.
+static constexpr qint32 ExecutionBudgetCheckInterval = 1000;
+
+// The CPU time the current thread has used so far, in nanoseconds. Where that is not available,
+// the time of a monotonic clock is returned instead.
+static qint64 threadCpuTime()
+{
+#if defined(Q_OS_WIN)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        // Both are given in units of 100 ns.
+        const auto toQint64 = [](const FILETIME &time) {
+            return (qint64(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+        };
+        return (toQint64(kernelTime) + toQint64(userTime)) * 100;
+    }
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) == 0)
+        return qint64(time.tv_sec) * 1000 * 1000 * 1000 + time.tv_nsec;
+#endif
+    return QElapsedTimer::msecsSinceReference() * 1000 * 1000;
+}
+
 // While engineSerial is odd the statics haven't been initialized. The engine that receives ID 1
 // initializes the statics and sets engineSerial to 2 afterwards.
 // Each engine does engineSerial.fetchAndAddOrdered(2) on creation. Therefore engineSerial stays
@@ -110,6 +143,11 @@ Q_CONSTINIT static QBasicAtomicInt engineSerial = Q_BASIC_ATOMIC_INITIALIZER(1);
 Q_CONSTINIT static QBasicAtomicInt hasPreview = Q_BASIC_ATOMIC_INITIALIZER(0);
 int ExecutionEngine::s_maxCallDepth = -1;
 int ExecutionEngine::s_jitCallCountThreshold = 3;
+int ExecutionEngine::s_jitOptimizeCallCountThreshold = 1000;
+int ExecutionEngine::s_jitLoopIterationThreshold = 1000;
+int ExecutionEngine::s_regExpJitThreshold = 5;
+int ExecutionEngine::s_regExpJitStringLength = 1024;
+int ExecutionEngine::s_regExpCacheSize = 64;
 int ExecutionEngine::s_maxJSStackSize = 4 * 1024 * 1024;
 int ExecutionEngine::s_maxGCStackSize = 2 * 1024 * 1024;
 
@@ -315,8 +353,32 @@ void ExecutionEngine::initializeStaticMembers()
     s_jitCallCountThreshold = qEnvironmentVariableIntValue("QV4_JIT_CALL_THRESHOLD", &ok);
     if (!ok)
         s_jitCallCountThreshold = 3;
-    if (qEnvironmentVariableIsSet("QV4_FORCE_INTERPRETER"))
+    ok = false;
+    s_jitOptimizeCallCountThreshold
+            = qEnvironmentVariableIntValue("QV4_JIT_OPTIMIZE_CALL_THRESHOLD", &ok);
+    if (!ok)
+        s_jitOptimizeCallCountThreshold = 1000;
+    ok = false;
+    s_jitLoopIterationThreshold = qEnvironmentVariableIntValue("QV4_JIT_LOOP_THRESHOLD", &ok);
+    if (!ok)
+        s_jitLoopIterationThreshold = 1000;
+    ok = false;
+    s_regExpJitThreshold = qEnvironmentVariableIntValue("QV4_REGEXP_JIT_THRESHOLD", &ok);
+    // An explicit threshold also applies to long strings.
+    s_regExpJitStringLength = ok ? std::numeric_limits<int>::max() : 1024;
+    if (!ok)
+        s_regExpJitThreshold = 5;
+    if (qEnvironmentVariableIsSet("QV4_FORCE_INTERPRETER")) {
         s_jitCallCountThreshold = std::numeric_limits<int>::max();
+        s_jitOptimizeCallCountThreshold = std::numeric_limits<int>::max();
+        s_jitLoopIterationThreshold = std::numeric_limits<int>::max();
+        s_regExpJitThreshold = std::numeric_limits<int>::max();
+        s_regExpJitStringLength = std::numeric_limits<int>::max();
+    }
+    ok = false;
+    s_regExpCacheSize = qEnvironmentVariableIntValue("QV4_REGEXP_CACHE_SIZE", &ok);
+    if (!ok || s_regExpCacheSize < 0)
+        s_regExpCacheSize = 64;
 
     qMetaTypeId<QJSValue>();
     qMetaTypeId<QList<int> >();
@@ -853,6 +915,14 @@ ExecutionEngine::ExecutionEngine(QJSEngine *jsEngine)
 
 ExecutionEngine::~ExecutionEngine()
 {
+    if (lcExecutionBudget().isDebugEnabled()) {
+        for (auto it = m_executionBudgetOverruns.cbegin(), end = m_executionBudgetOverruns.cend();
+             it != end; ++it) {
+            qCDebug(lcExecutionBudget).noquote() << it.key() << "exceeded its execution budget"
+                                                 << it.value() << "times";
+        }
+    }
+
     for (auto val : nativeModules) {
         PersistentValueStorage::free(val);
     }
@@ -872,6 +942,7 @@ ExecutionEngine::~ExecutionEngine()
 
     delete bumperPointerAllocator;
     delete regExpCache;
+    delete megamorphicLookupCache;
     delete regExpAllocator;
     delete executableAllocator;
     jsStack->deallocate();
@@ -1028,6 +1099,11 @@ Heap::ArrayBuffer *ExecutionEngine::newArrayBuffer(size_t length)
     return memoryManager->allocate<ArrayBuffer>(length);
 }
 
+Heap::SharedArrayBuffer *ExecutionEngine::newSharedArrayBuffer(const QByteArray &array)
+{
+    return memoryManager->allocate<SharedArrayBuffer>(array);
+}
+
 Heap::DateObject *ExecutionEngine::newDateObject(double dateTime)
 {
     return memoryManager->allocate<DateObject>(dateTime);
@@ -1327,6 +1403,73 @@ QUrl ExecutionEngine::resolvedUrl(const QString &file)
     return base.resolved(src);
 }
 
+void ExecutionEngine::setExecutionBudget(qint64 msecs, ExecutionBudgetCallback callback)
+{
+    m_executionBudget = std::max<qint64>(msecs, 0);
+    m_executionBudgetCallback = std::move(callback);
+}
+
+void ExecutionEngine::startExecutionBudget()
+{
+    m_executionBudgetStart = threadCpuTime();
+    executionBudgetCountdown = ExecutionBudgetCheckInterval;
+}
+
+void ExecutionEngine::checkExecutionBudget()
+{
+    if (m_executionBudgetStart < 0) {
+        // No budget was started for the current call.
+        executionBudgetCountdown = std::numeric_limits<qint32>::max();
+        return;
+    }
+
+    executionBudgetCountdown = ExecutionBudgetCheckInterval;
+    if (m_executionBudgetExceeded)
+        return;
+
+    const qint64 now = threadCpuTime();
+    const qint64 elapsed = (now - m_executionBudgetStart) / (1000 * 1000);
+    if (elapsed < m_executionBudget)
+        return;
+
+    Function *function = currentStackFrame ? currentStackFrame->v4Function : nullptr;
+    if (function) {
+        QString name = function->name()->toQString();
+        if (name.isEmpty())
+            name = QStringLiteral("<anonymous>");
+        ++m_executionBudgetOverruns[QStringLiteral("%1 (%2:%3)").arg(
+                name, function->sourceFile(),
+                QString::number(function->compiledFunction->location.line()))];
+    }
+
+    // Any JavaScript the callback runs gets a fresh budget, and so does the current call if the
+    // callback lets it continue.
+    m_executionBudgetStart = now;
+    if (m_executionBudgetCallback && m_executionBudgetCallback(function, elapsed))
+        return;
+
+    // Interrupt rather than throw, so that the script cannot catch it and carry on. If the
+    // engine is interrupted already, that interrupt is not ours to clear later.
+    m_executionBudgetExceeded = true;
+    m_executionBudgetInterrupted = isInterrupted.testAndSetRelaxed(false, true);
+}
+
+void ExecutionEngine::finishExecutionBudget()
+{
+    m_executionBudgetStart = -1;
+    executionBudgetCountdown = std::numeric_limits<qint32>::max();
+    if (!m_executionBudgetExceeded)
+        return;
+
+    // The call has been unwound completely. Report the abort to whoever made it.
+    m_executionBudgetExceeded = false;
+    if (m_executionBudgetInterrupted) {
+        m_executionBudgetInterrupted = false;
+        isInterrupted.storeRelaxed(false);
+    }
+    throwError(QStringLiteral("Execution time budget of %1 ms exceeded").arg(m_executionBudget));
+}
+
 void ExecutionEngine::markObjects(MarkStack *markStack)
 {
     for (int i = 0; i < NClasses; ++i) {
@@ -1336,6 +1479,9 @@ void ExecutionEngine::markObjects(MarkStack *markStack)
 
     identifierTable->markObjects(markStack);
 
+    if (regExpCache)
+        regExpCache->markObjects(markStack);
+
     for (const auto &compilationUnit : std::as_const(m_compilationUnits))
         compilationUnit->markObjects(markStack);
 }
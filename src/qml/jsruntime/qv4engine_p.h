@@ -24,12 +24,15 @@
 #include <private/qv4function_p.h>
 #include <private/qv4global_p.h>
 #include <private/qv4stacklimits_p.h>
+#include <private/qv4string_p.h>
 
 #include <QtCore/qelapsedtimer.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qprocessordetection.h>
 #include <QtCore/qset.h>
 
+#include <functional>
+
 namespace WTF {
 class BumpPointerAllocator;
 class PageAllocation;
@@ -501,6 +504,8 @@ public:
     quint32 m_engineId;
 
     RegExpCache *regExpCache;
+    MegamorphicLookupCache *megamorphicLookupCache = nullptr;
+    StringStatistics stringStatistics;
 
     // Scarce resources are "exceptionally high cost" QVariant types where allowing the
     // normal JavaScript GC to clean them up is likely to lead to out-of-memory or other
@@ -579,6 +584,7 @@ public:
 
     Heap::ArrayBuffer *newArrayBuffer(const QByteArray &array);
     Heap::ArrayBuffer *newArrayBuffer(size_t length);
+    Heap::SharedArrayBuffer *newSharedArrayBuffer(const QByteArray &array);
 
     Heap::DateObject *newDateObject(double dateTime);
     Heap::DateObject *newDateObject(const QDateTime &dateTime);
@@ -711,6 +717,76 @@ public:
 #endif
     }
 
+    bool canOptimize(Function *f) const
+    {
+#if QT_CONFIG(qml_jit)
+        // Only tier up functions whose baseline code has seen non-integer arithmetic. The
+        // optimizing tier has nothing else to offer.
+        return f->jittedCode && !f->supersededCodeRef && f->arithmeticFeedback > 0;
+#else
+        Q_UNUSED(f);
+        return false;
+#endif
+    }
+
+    static int jitOptimizeCallCountThreshold() { return s_jitOptimizeCallCountThreshold; }
+
+    // Counts a backward jump taken by the interpreter in \a f, and returns whether the frame
+    // should continue in jitted code. Nothing is counted if loops are never jitted, and the
+    // count saturates, so that it cannot wrap around.
+    bool countLoopIteration(Function *f) const
+    {
+#if QT_CONFIG(qml_jit)
+        if (!m_canAllocateExecutableMemory
+                || s_jitLoopIterationThreshold == std::numeric_limits<int>::max()) {
+            return false;
+        }
+        if (f->interpreterLoopIterationCount < std::numeric_limits<int>::max())
+            ++f->interpreterLoopIterationCount;
+        return canReplaceOnStack(f);
+#else
+        Q_UNUSED(f);
+        return false;
+#endif
+    }
+
+    bool canReplaceOnStack(Function *f) const
+    {
+#if QT_CONFIG(qml_jit)
+        return m_canAllocateExecutableMemory
+                && s_jitLoopIterationThreshold != std::numeric_limits<int>::max()
+                && f->kind != Function::AotCompiled
+                && !f->isGenerator()
+                && f->interpreterLoopIterationCount >= s_jitLoopIterationThreshold;
+#else
+        Q_UNUSED(f);
+        return false;
+#endif
+    }
+
+    // The regular expression settings, as given by QV4_REGEXP_JIT_THRESHOLD,
+    // QV4_FORCE_INTERPRETER and QV4_REGEXP_CACHE_SIZE. The setters are meant for testing.
+    static int regExpJitThreshold() { return s_regExpJitThreshold; }
+    static void setRegExpJitThreshold(int runs) { s_regExpJitThreshold = runs; }
+    static int regExpJitStringLength() { return s_regExpJitStringLength; }
+    static void setRegExpJitStringLength(int length) { s_regExpJitStringLength = length; }
+    static int regExpCacheSize() { return s_regExpCacheSize; }
+    static void setRegExpCacheSize(int size) { s_regExpCacheSize = size; }
+
+    // Limits the time each outermost call into JavaScript may take. Once the budget is used up,
+    // the callback decides whether the call may continue for another budget, or is aborted.
+    // The budget is measured in CPU time of the engine's thread, so time the thread spends waiting
+    // or descheduled does not count. Where thread CPU time is not available, wall-clock time is
+    // used.
+    using ExecutionBudgetCallback = std::function<bool(Function *function, qint64 elapsed)>;
+    void setExecutionBudget(qint64 msecs, ExecutionBudgetCallback callback = {});
+    qint64 executionBudget() const { return m_executionBudget; }
+    QHash<QString, int> executionBudgetOverruns() const { return m_executionBudgetOverruns; }
+
+    void startExecutionBudget();
+    void checkExecutionBudget();
+    void finishExecutionBudget();
+
     QV4::ReturnedValue global();
     void initQmlGlobalObject();
     void initializeGlobal();
@@ -869,6 +945,11 @@ private:
 
     static int s_maxCallDepth;
     static int s_jitCallCountThreshold;
+    static int s_jitOptimizeCallCountThreshold;
+    static int s_jitLoopIterationThreshold;
+    static int s_regExpJitThreshold;
+    static int s_regExpJitStringLength;
+    static int s_regExpCacheSize;
     static int s_maxJSStackSize;
     static int s_maxGCStackSize;
 
@@ -894,6 +975,13 @@ private:
 
     QHash<QString, quint32> m_consoleCount;
 
+    ExecutionBudgetCallback m_executionBudgetCallback;
+    qint64 m_executionBudgetStart = -1; // thread CPU time in ns, or -1 if no budget is running
+    QHash<QString, int> m_executionBudgetOverruns;
+    qint64 m_executionBudget = 0;
+    bool m_executionBudgetExceeded = false;
+    bool m_executionBudgetInterrupted = false;
+
     QVector<Deletable *> m_extensionData;
 
     QMultiHash<QUrl, QQmlRefPointer<ExecutableCompilationUnit>> m_compilationUnits;
@@ -17,6 +17,8 @@
 #include <private/qv4global_p.h>
 #include <private/qv4runtimeapi_p.h>
 
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
 namespace QV4 {
@@ -69,6 +71,10 @@ struct Q_QML_EXPORT EngineBase {
     // Exception handling
     Value *exceptionValue = nullptr;
 
+    // Counts down on function calls and loop iterations. The execution budget is checked when
+    // it runs out.
+    qint32 executionBudgetCountdown = std::numeric_limits<qint32>::max();
+
     enum InternalClassType {
         Class_Empty,
         Class_String,
@@ -3,6 +3,10 @@
 
 #include "qv4estable_p.h"
 #include "qv4object_p.h"
+#include "qv4string_p.h"
+
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qnumeric.h>
 
 using namespace QV4;
 
@@ -10,26 +14,47 @@ using namespace QV4;
 // is a little different from most; it requires nonlinear access, and must also
 // preserve the order of insertion of items in a deterministic way.
 //
-// This class implements those requirements, except for fast access: that
-// will be addressed in a followup patch.
+// Keys and values are kept in insertion order in two plain arrays, which is
+// what iteration (and the ShiftObserver protocol) operates on. On top of that,
+// a chained hash index maps the hash of a key to its position in those arrays,
+// so that lookups don't have to scan the whole table.
+//
+// Hashes must be consistent with sameValueZero(): numbers hash by their
+// numeric value (so that 1 and 1.0, or 0 and -0, end up in the same bucket),
+// strings by their content and everything else by identity. Managed types that
+// provide their own notion of equality (e.g. QObject wrappers, which compare
+// equal for the same QObject) all share one hash value, as we can't know how
+// they would compare to each other.
+
+static constexpr uint CustomEqualityHash = 0x9e3779b9;
 
 ESTable::ESTable()
     : m_capacity(8)
 {
     m_keys = (Value*)malloc(m_capacity * sizeof(Value));
     m_values = (Value*)malloc(m_capacity * sizeof(Value));
-    memset(m_keys, 0, m_capacity);
-    memset(m_values, 0, m_capacity);
+    m_hashes = (uint*)malloc(m_capacity * sizeof(uint));
+    m_next = (uint*)malloc(m_capacity * sizeof(uint));
+    m_buckets = (uint*)malloc(m_capacity * sizeof(uint));
+    memset(m_keys, 0, m_capacity * sizeof(Value));
+    memset(m_values, 0, m_capacity * sizeof(Value));
+    rehash();
 }
 
 ESTable::~ESTable()
 {
     free(m_keys);
     free(m_values);
+    free(m_hashes);
+    free(m_next);
+    free(m_buckets);
     m_size = 0;
     m_capacity = 0;
     m_keys = nullptr;
     m_values = nullptr;
+    m_hashes = nullptr;
+    m_next = nullptr;
+    m_buckets = nullptr;
 }
 
 void ESTable::markObjects(MarkStack *s, bool isWeakMap)
@@ -46,6 +71,7 @@ void ESTable::markObjects(MarkStack *s, bool isWeakMap)
 void ESTable::clear()
 {
     m_size = 0;
+    rehash();
 
     std::for_each(m_observers.begin(), m_observers.end(), [](ShiftObserver* ob){
         Q_ASSERT(ob);
@@ -57,21 +83,15 @@ void ESTable::clear()
 // normalized, as required by the ES spec.
 void ESTable::set(const Value &key, const Value &value)
 {
-    for (uint i = 0; i < m_size; ++i) {
-        if (m_keys[i].sameValueZero(key)) {
-            m_values[i] = value;
-            return;
-        }
+    const uint hash = hashKey(key);
+    const uint index = find(key, hash);
+    if (index != NoEntry) {
+        m_values[index] = value;
+        return;
     }
 
-    if (m_capacity == m_size) {
-        uint oldCap = m_capacity;
-        m_capacity *= 2;
-        m_keys = (Value*)realloc(m_keys, m_capacity * sizeof(Value));
-        m_values = (Value*)realloc(m_values, m_capacity * sizeof(Value));
-        memset(m_keys + oldCap, 0, m_capacity - oldCap);
-        memset(m_values + oldCap, 0, m_capacity - oldCap);
-    }
+    if (m_capacity == m_size)
+        grow();
 
     Value nk = key;
     if (nk.isDouble()) {
@@ -81,6 +101,13 @@ void ESTable::set(const Value &key, const Value &value)
 
     m_keys[m_size] = nk;
     m_values[m_size] = value;
+    m_hashes[m_size] = hash;
+
+    // Chains are kept ordered by descending position, so the most recently
+    // inserted entry is always the head of its bucket.
+    uint &bucket = m_buckets[hash & (m_capacity - 1)];
+    m_next[m_size] = bucket;
+    bucket = m_size;
 
     m_size++;
 }
@@ -88,53 +115,52 @@ void ESTable::set(const Value &key, const Value &value)
 // Returns true if the table contains \a key, false otherwise.
 bool ESTable::has(const Value &key) const
 {
-    for (uint i = 0; i < m_size; ++i) {
-        if (m_keys[i].sameValueZero(key))
-            return true;
-    }
-
-    return false;
+    return find(key, hashKey(key)) != NoEntry;
 }
 
 // Fetches the value for the given \a key, and if \a hasValue is passed in,
 // it is set depending on whether or not the given key was found.
 ReturnedValue ESTable::get(const Value &key, bool *hasValue) const
 {
-    for (uint i = 0; i < m_size; ++i) {
-        if (m_keys[i].sameValueZero(key)) {
-            if (hasValue)
-                *hasValue = true;
-            return m_values[i].asReturnedValue();
-        }
-    }
-
+    const uint index = find(key, hashKey(key));
     if (hasValue)
-        *hasValue = false;
-    return Encode::undefined();
+        *hasValue = index != NoEntry;
+    return index != NoEntry ? m_values[index].asReturnedValue() : Encode::undefined();
 }
 
 // Removes the given \a key from the table
 bool ESTable::remove(const Value &key)
 {
-    for (uint index = 0; index < m_size; ++index) {
-        if (m_keys[index].sameValueZero(key)) {
-            // Remove the element at |index| by moving all elements to the right
-            // of |index| one place to the left.
-            size_t count = (m_size - (index + 1)) * sizeof(Value);
-            memmove(m_keys + index, m_keys + index + 1, count);
-            memmove(m_values + index, m_values + index + 1, count);
-            m_size--;
-
-            std::for_each(m_observers.begin(), m_observers.end(), [index](ShiftObserver* ob) {
-                Q_ASSERT(ob);
-                if (index <= ob->pivot && ob->pivot != ShiftObserver::OUT_OF_TABLE)
-                    ob->pivot = ob->pivot == 0 ? ShiftObserver::OUT_OF_TABLE : ob->pivot - 1;
-            });
-
-            return true;
-        }
+    const uint index = find(key, hashKey(key));
+    if (index == NoEntry)
+        return false;
+
+    if (index == m_size - 1) {
+        // Cheap case: the last entry is the head of its chain and nothing
+        // needs to be shifted.
+        uint &bucket = m_buckets[m_hashes[index] & (m_capacity - 1)];
+        Q_ASSERT(bucket == index);
+        bucket = m_next[index];
+        m_size--;
+    } else {
+        // Remove the element at |index| by moving all elements to the right
+        // of |index| one place to the left. This invalidates the positions
+        // stored in the index, so it has to be rebuilt.
+        size_t count = (m_size - (index + 1));
+        memmove(m_keys + index, m_keys + index + 1, count * sizeof(Value));
+        memmove(m_values + index, m_values + index + 1, count * sizeof(Value));
+        memmove(m_hashes + index, m_hashes + index + 1, count * sizeof(uint));
+        m_size--;
+        rehash();
     }
-    return false;
+
+    std::for_each(m_observers.begin(), m_observers.end(), [index](ShiftObserver* ob) {
+        Q_ASSERT(ob);
+        if (index <= ob->pivot && ob->pivot != ShiftObserver::OUT_OF_TABLE)
+            ob->pivot = ob->pivot == 0 ? ShiftObserver::OUT_OF_TABLE : ob->pivot - 1;
+    });
+
+    return true;
 }
 
 // Returns the size of the table. Note that the size may not match the underlying allocation.
@@ -164,8 +190,76 @@ void ESTable::removeUnmarkedKeys()
         if (o.d()->isMarked()) {
             m_keys[toIdx] = m_keys[idx];
             m_values[toIdx] = m_values[idx];
+            m_hashes[toIdx] = m_hashes[idx];
             ++toIdx;
         }
     }
-    m_size = toIdx;
+    if (toIdx != m_size) {
+        m_size = toIdx;
+        rehash();
+    }
+}
+
+// Returns a hash for \a key that is consistent with Value::sameValueZero().
+uint ESTable::hashKey(const Value &key)
+{
+    if (key.isInteger())
+        return uint(qHash(double(key.int_32())));
+
+    if (key.isDouble()) {
+        double d = key.doubleValue();
+        if (std::isnan(d))
+            d = qQNaN();
+        else if (d == 0)
+            d = 0; // -0 and +0 are the same key
+        return uint(qHash(d));
+    }
+
+    if (const String *s = key.stringValue())
+        return uint(qHash(s->hashValue()));
+
+    if (key.isManaged()) {
+        const Managed &m = static_cast<const Managed &>(key);
+        if (m.vtable()->isEqualTo != Object::staticVTable()->isEqualTo)
+            return CustomEqualityHash;
+        return uint(qHash(quintptr(m.d())));
+    }
+
+    return uint(qHash(key.rawValue()));
+}
+
+// Returns the position of \a key, whose hash is \a hash, or NoEntry.
+uint ESTable::find(const Value &key, uint hash) const
+{
+    for (uint i = m_buckets[hash & (m_capacity - 1)]; i != NoEntry; i = m_next[i]) {
+        if (m_hashes[i] == hash && m_keys[i].sameValueZero(key))
+            return i;
+    }
+    return NoEntry;
+}
+
+void ESTable::grow()
+{
+    uint oldCap = m_capacity;
+    m_capacity *= 2;
+    m_keys = (Value*)realloc(m_keys, m_capacity * sizeof(Value));
+    m_values = (Value*)realloc(m_values, m_capacity * sizeof(Value));
+    m_hashes = (uint*)realloc(m_hashes, m_capacity * sizeof(uint));
+    m_next = (uint*)realloc(m_next, m_capacity * sizeof(uint));
+    m_buckets = (uint*)realloc(m_buckets, m_capacity * sizeof(uint));
+    memset(m_keys + oldCap, 0, (m_capacity - oldCap) * sizeof(Value));
+    memset(m_values + oldCap, 0, (m_capacity - oldCap) * sizeof(Value));
+    rehash();
+}
+
+// Rebuilds the hash index from the cached hashes of the first m_size entries.
+void ESTable::rehash()
+{
+    const uint mask = m_capacity - 1;
+    std::fill_n(m_buckets, m_capacity, NoEntry);
+    for (uint i = 0; i < m_size; ++i) {
+        uint &bucket = m_buckets[m_hashes[i] & mask];
+        m_next[i] = bucket;
+        bucket = i;
+    }
 }
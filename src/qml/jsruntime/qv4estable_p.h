@@ -73,11 +73,26 @@ public:
 private:
     friend class ::tst_qv4estable;
 
+    static constexpr uint NoEntry = std::numeric_limits<uint>::max();
+
+    static uint hashKey(const Value &k);
+    uint find(const Value &k, uint hash) const;
+    void grow();
+    void rehash();
+
     Value *m_keys = nullptr;
     Value *m_values = nullptr;
     uint m_size = 0;
     uint m_capacity = 0;
 
+    // Hash index over the insertion ordered m_keys/m_values arrays. Every
+    // entry caches its hash and links to the next entry in the same bucket.
+    // m_buckets has m_capacity slots (always a power of two), each holding
+    // the position of the first entry in the chain, or NoEntry.
+    uint *m_hashes = nullptr;
+    uint *m_next = nullptr;
+    uint *m_buckets = nullptr;
+
     std::vector<ShiftObserver*> m_observers;
 };
 
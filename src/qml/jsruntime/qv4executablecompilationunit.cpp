@@ -7,6 +7,7 @@
 
 #include <private/qv4engine_p.h>
 #include <private/qv4regexp_p.h>
+#include <private/qv4mm_p.h>
 #include <private/qv4lookup_p.h>
 #include <private/qv4qmlcontext_p.h>
 #include <private/qv4identifiertable_p.h>
@@ -92,15 +93,11 @@ void ExecutableCompilationUnit::populate()
     for (uint i = 0; i < stringCount; ++i)
         runtimeStrings[i] = engine->newString(stringAt(i));
 
+    // Regular expressions are compiled when the literal is first evaluated. See regExpAt().
     runtimeRegularExpressions
             = new QV4::Value[data->regexpTableSize];
-    for (uint i = 0; i < data->regexpTableSize; ++i) {
-        const CompiledData::RegExp *re = data->regexpAt(i);
-        uint f = re->flags();
-        const CompiledData::RegExp::Flags flags = static_cast<CompiledData::RegExp::Flags>(f);
-        runtimeRegularExpressions[i] = QV4::RegExp::create(
-                engine, stringAt(re->stringIndex()), flags);
-    }
+    for (uint i = 0; i < data->regexpTableSize; ++i)
+        runtimeRegularExpressions[i] = Encode::undefined();
 
     if (data->lookupTableSize) {
         runtimeLookups = new QV4::Lookup[data->lookupTableSize];
@@ -239,6 +236,29 @@ Heap::Object *ExecutableCompilationUnit::templateObjectAt(int index) const
     return templateObjects.at(index);
 }
 
+StaticValue ExecutableCompilationUnit::regExpAt(int index) const
+{
+    const CompiledData::Unit *data = m_compilationUnit->data;
+    Q_ASSERT(data);
+    Q_ASSERT(engine);
+
+    Q_ASSERT(index < int(data->regexpTableSize));
+    StaticValue &regExp = runtimeRegularExpressions[index];
+    if (regExp.isUndefined()) {
+        const CompiledData::RegExp *re = data->regexpAt(index);
+        uint f = re->flags();
+        const CompiledData::RegExp::Flags flags = static_cast<CompiledData::RegExp::Flags>(f);
+        Heap::RegExp *created = QV4::RegExp::create(engine, stringAt(re->stringIndex()), flags);
+        regExp = created;
+        // The runtime regular expressions are only marked at the start of an incremental gc
+        // run, so the lazily created one needs to be marked explicitly.
+        QV4::WriteBarrier::markCustom(engine, [created](QV4::MarkStack *ms) {
+            created->mark(ms);
+        });
+    }
+    return regExp;
+}
+
 void ExecutableCompilationUnit::clear()
 {
     delete [] imports;
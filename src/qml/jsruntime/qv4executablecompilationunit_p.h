@@ -145,6 +145,7 @@ public:
     }
 
     Heap::Object *templateObjectAt(int index) const;
+    StaticValue regExpAt(int index) const;
 
     Heap::Module *instantiate();
     const Value *resolveExport(QV4::String *exportName)
@@ -179,6 +180,10 @@ public:
     {
         return m_compilationUnit->bindingValueAsScriptString(binding);
     }
+    const QVariant *literalBindingValue(const CompiledData::Binding *binding) const
+    {
+        return m_compilationUnit->literalBindingValue(binding);
+    }
 
     struct TranslationDataIndex
     {
@@ -176,6 +176,10 @@ Function::~Function()
         destroyFunctionTable(this, codeRef);
         delete codeRef;
     }
+    if (supersededCodeRef) {
+        destroyFunctionTable(this, supersededCodeRef);
+        delete supersededCodeRef;
+    }
 
     switch (kind) {
     case JsTyped:
@@ -77,6 +77,9 @@ public:
     const CompiledData::Function *compiledFunction = nullptr;
     const char *codeData = nullptr;
     JSC::MacroAssemblerCodeRef *codeRef = nullptr;
+    // Baseline code replaced by the optimizing tier. Frames further up the stack may still be
+    // running it, so it lives as long as the function.
+    JSC::MacroAssemblerCodeRef *supersededCodeRef = nullptr;
 
     typedef ReturnedValue (*JittedCode)(CppStackFrame *, ExecutionEngine *);
     typedef void (*AotCompiledCode)(const QQmlPrivate::AOTCompiledContext *context, void **argv);
@@ -92,9 +95,17 @@ public:
         AotCompiledCode aotCompiledCode;
     };
 
+    // Alternative entry into jittedCode for frames that are already running in the interpreter.
+    // It resumes at the loop header stored in the frame's instructionPointer.
+    JittedCode jittedLoopEntry = nullptr;
+
     // first nArguments names in internalClass are the actual arguments
     QV4::WriteBarrier::Pointer<Heap::InternalClass> internalClass;
     int interpreterCallCount = 0;
+    int jittedCallCount = 0;
+    int interpreterLoopIterationCount = 0;
+    // Bumped by baseline code whenever arithmetic or comparisons leave the integer fast path.
+    quint32 arithmeticFeedback = 0;
     quint16 nFormals = 0;
     enum Kind : quint8 { JsUntyped, JsTyped, AotCompiled, Eval };
     Kind kind = JsUntyped;
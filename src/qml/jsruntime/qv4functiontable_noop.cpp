@@ -7,10 +7,17 @@ QT_BEGIN_NAMESPACE
 
 namespace QV4 {
 
-void generateFunctionTable(Function *function, JSC::MacroAssemblerCodeRef *codeRef)
+bool functionTableNeedsLines()
+{
+    return false;
+}
+
+void generateFunctionTable(Function *function, JSC::MacroAssemblerCodeRef *codeRef,
+                           const std::vector<NativeCodeLine> &lines)
 {
     Q_UNUSED(function);
     Q_UNUSED(codeRef);
+    Q_UNUSED(lines);
 }
 
 void destroyFunctionTable(Function *function, JSC::MacroAssemblerCodeRef *codeRef)
@@ -17,6 +17,8 @@
 
 #include <QtQml/private/qqmlglobal_p.h>
 
+#include <vector>
+
 namespace JSC {
 class MacroAssemblerCodeRef;
 }
@@ -27,7 +29,20 @@ namespace QV4 {
 
 struct Function;
 
-void generateFunctionTable(Function *function, JSC::MacroAssemblerCodeRef *codeRef);
+// Where the machine code for a line of JavaScript starts, relative to the start
+// of the function's code.
+struct NativeCodeLine
+{
+    quint32 codeOffset;
+    qint32 line;
+};
+
+// Collecting line information slows down the JIT a bit. Only do it if the function
+// table can make use of it.
+bool functionTableNeedsLines();
+
+void generateFunctionTable(Function *function, JSC::MacroAssemblerCodeRef *codeRef,
+                           const std::vector<NativeCodeLine> &lines = {});
 void destroyFunctionTable(Function *function, JSC::MacroAssemblerCodeRef *codeRef);
 
 size_t exceptionHandlerSize();
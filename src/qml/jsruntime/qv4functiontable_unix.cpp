@@ -9,11 +9,227 @@
 #include <QtCore/qfile.h>
 #include <QtCore/qcoreapplication.h>
 
+#ifdef Q_OS_LINUX
+#include <QtCore/qmutex.h>
+#include <QtCore/qurl.h>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 namespace QV4 {
 
-void generateFunctionTable(Function *function, JSC::MacroAssemblerCodeRef *codeRef)
+#ifdef Q_OS_LINUX
+namespace {
+
+// Writes JIT'd code in perf's jitdump format. Unlike the perf map, this contains the code
+// itself and the source line for each part of it. "perf inject --jit" turns it into ELF files
+// that "perf report" and "perf annotate" can use to show the JavaScript lines in JIT'd code.
+// For the format, see:
+// https://github.com/torvalds/linux/blob/master/tools/perf/Documentation/jitdump-specification.txt
+class JitDump
+{
+public:
+    static JitDump *instance();
+
+    void write(Function *function, const JSC::MacroAssemblerCodeRef *codeRef,
+               const std::vector<NativeCodeLine> &lines);
+
+private:
+    enum RecordType : quint32 {
+        CodeLoad = 0,
+        DebugInfo = 2,
+    };
+
+    struct FileHeader {
+        quint32 magic;
+        quint32 version;
+        quint32 totalSize;
+        quint32 elfMachine;
+        quint32 padding;
+        quint32 pid;
+        quint64 timestamp;
+        quint64 flags;
+    };
+
+    struct RecordHeader {
+        quint32 id;
+        quint32 totalSize;
+        quint64 timestamp;
+    };
+
+    // Followed by the function name, null terminated, and the code.
+    struct CodeLoadRecord {
+        RecordHeader header;
+        quint32 pid;
+        quint32 tid;
+        quint64 vma;
+        quint64 codeAddress;
+        quint64 codeSize;
+        quint64 codeIndex;
+    };
+
+    // Followed by the entries.
+    struct DebugInfoRecord {
+        RecordHeader header;
+        quint64 codeAddress;
+        quint64 entryCount;
+    };
+
+    // Followed by the source file name, null terminated.
+    struct DebugEntry {
+        quint64 codeAddress;
+        quint32 line;
+        quint32 discriminator;
+    };
+
+    bool open();
+    static quint64 timestamp();
+    static quint32 elfMachine();
+
+    QFile file;
+    QMutex mutex;
+    quint64 codeIndex = 0;
+};
+
+JitDump *JitDump::instance()
+{
+    static JitDump *dump = [] {
+        if (qEnvironmentVariableIsEmpty("QV4_PROFILE_WRITE_PERF_JITDUMP"))
+            return static_cast<JitDump *>(nullptr);
+        static JitDump instance;
+        if (!instance.open()) {
+            qWarning("QV4::JIT::Assembler: Cannot write jitdump file.");
+            return static_cast<JitDump *>(nullptr);
+        }
+        return &instance;
+    }();
+    return dump;
+}
+
+bool JitDump::open()
+{
+    QString directory = qEnvironmentVariable("JITDUMPDIR");
+    if (directory.isEmpty())
+        directory = QStringLiteral("/tmp");
+
+    // perf inject recognizes the file by its name.
+    file.setFileName(QStringLiteral("%1/jit-%2.dump")
+                     .arg(directory).arg(QCoreApplication::applicationPid()));
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+        return false;
+
+    const FileHeader header = {
+        0x4A695444, // "JiTD"
+        1,
+        sizeof(FileHeader),
+        elfMachine(),
+        0,
+        quint32(QCoreApplication::applicationPid()),
+        timestamp(),
+        0
+    };
+    if (file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != qint64(sizeof(header))
+            || !file.flush()) {
+        return false;
+    }
+
+    // perf record finds the file through this mapping. It has to be executable, as perf only
+    // records those. The mapping is intentionally kept until the process exits.
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    void *marker = mmap(nullptr, pageSize, PROT_READ | PROT_EXEC, MAP_PRIVATE, file.handle(), 0);
+    return marker != MAP_FAILED;
+}
+
+quint64 JitDump::timestamp()
+{
+    // This has to match the clock perf uses. Record with "perf record -k mono".
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return quint64(ts.tv_sec) * 1000000000 + quint64(ts.tv_nsec);
+}
+
+quint32 JitDump::elfMachine()
+{
+#if defined(Q_PROCESSOR_X86_64)
+    return 62;  // EM_X86_64
+#elif defined(Q_PROCESSOR_X86_32)
+    return 3;   // EM_386
+#elif defined(Q_PROCESSOR_ARM_64)
+    return 183; // EM_AARCH64
+#elif defined(Q_PROCESSOR_ARM_32)
+    return 40;  // EM_ARM
+#else
+    return 0;   // EM_NONE
+#endif
+}
+
+void JitDump::write(Function *function, const JSC::MacroAssemblerCodeRef *codeRef,
+                    const std::vector<NativeCodeLine> &lines)
+{
+    const void *address = codeRef->code().executableAddress();
+    const quint64 codeAddress = reinterpret_cast<quintptr>(address);
+    const quint64 codeSize = codeRef->size();
+    const QByteArray name = Function::prettyName(function, address).toUtf8();
+
+    QByteArray sourceFile;
+    if (!lines.empty()) {
+        const QString fileName = function->sourceFile();
+        const QUrl url(fileName);
+        sourceFile = (url.isLocalFile() ? url.toLocalFile() : fileName).toUtf8();
+    }
+
+    QMutexLocker locker(&mutex);
+
+    // The debug info has to precede the code it describes.
+    if (!lines.empty()) {
+        const quint64 entrySize = sizeof(DebugEntry) + sourceFile.size() + 1;
+        const DebugInfoRecord record = {
+            { DebugInfo, quint32(sizeof(DebugInfoRecord) + lines.size() * entrySize), timestamp() },
+            codeAddress,
+            lines.size()
+        };
+        file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+        for (const NativeCodeLine &line : lines) {
+            const DebugEntry entry = { codeAddress + line.codeOffset, quint32(line.line), 0 };
+            file.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+            file.write(sourceFile.constData(), sourceFile.size() + 1);
+        }
+    }
+
+    const CodeLoadRecord record = {
+        { CodeLoad, quint32(sizeof(CodeLoadRecord) + name.size() + 1 + codeSize), timestamp() },
+        quint32(QCoreApplication::applicationPid()),
+        quint32(syscall(SYS_gettid)),
+        codeAddress,
+        codeAddress,
+        codeSize,
+        codeIndex++
+    };
+    file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    file.write(name.constData(), name.size() + 1);
+    file.write(static_cast<const char *>(address), codeSize);
+    file.flush();
+}
+
+} // namespace
+#endif // Q_OS_LINUX
+
+bool functionTableNeedsLines()
+{
+#ifdef Q_OS_LINUX
+    return JitDump::instance() != nullptr;
+#else
+    return false;
+#endif
+}
+
+void generateFunctionTable(Function *function, JSC::MacroAssemblerCodeRef *codeRef,
+                           const std::vector<NativeCodeLine> &lines)
 {
     // This implements writing of JIT'd addresses so that perf can find the
     // symbol names.
@@ -40,6 +256,13 @@ void generateFunctionTable(Function *function, JSC::MacroAssemblerCodeRef *codeR
             perfMapFile.flush();
         }
     }
+
+#ifdef Q_OS_LINUX
+    if (JitDump *dump = JitDump::instance(); Q_UNLIKELY(dump))
+        dump->write(function, codeRef, lines);
+#else
+    Q_UNUSED(lines);
+#endif
 }
 
 void destroyFunctionTable(Function *function, JSC::MacroAssemblerCodeRef *codeRef)
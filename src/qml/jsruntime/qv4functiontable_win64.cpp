@@ -67,7 +67,13 @@ struct ExceptionHandlerRecord
     UnwindInfo info;
 };
 
-void generateFunctionTable(Function *, JSC::MacroAssemblerCodeRef *codeRef)
+bool functionTableNeedsLines()
+{
+    return false;
+}
+
+void generateFunctionTable(Function *, JSC::MacroAssemblerCodeRef *codeRef,
+                           const std::vector<NativeCodeLine> &)
 {
     ExceptionHandlerRecord *record = reinterpret_cast<ExceptionHandlerRecord *>(
                 codeRef->executableMemory()->exceptionHandlerStart());
@@ -174,6 +174,7 @@ struct MarkStack;
 
 struct IdentifierTable;
 class RegExpCache;
+struct MegamorphicLookupCache;
 class MultiplyWrappedQObjectMap;
 
 enum PropertyFlag {
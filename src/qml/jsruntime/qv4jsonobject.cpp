@@ -11,12 +11,15 @@
 #include <qv4variantobject_p.h>
 #include "qv4jscall_p.h"
 #include <qv4symbol_p.h>
+#include <qv4identifiertable_p.h>
 
 #include <qstack.h>
 #include <qstringlist.h>
 
 #include <wtf/MathExtras.h>
 
+#include <charconv>
+
 using namespace QV4;
 
 //#define PARSER_DEBUG
@@ -37,12 +40,63 @@ DEFINE_OBJECT_VTABLE(JsonObject);
 static const int nestingLimit = 1024;
 
 
-JsonParser::JsonParser(ExecutionEngine *engine, const QChar *json, int length)
-    : engine(engine), head(json), json(json), nestingLevel(0), lastError(QJsonParseError::NoError)
+// Objects in a JSON document tend to repeat the same keys in the same order.
+// Before interning a key, parseKey() checks whether the object's internal
+// class already has a transition for it. Only a handful of transitions are
+// scanned, so dictionary-like objects fall back to interning quickly.
+static const int maxTransitionsToScan = 8;
+
+static inline char16_t unit(QChar ch)
+{
+    return ch.unicode();
+}
+
+static inline char16_t unit(char ch)
+{
+    return uchar(ch);
+}
+
+static inline bool isDigit(char16_t ch)
+{
+    return ch >= u'0' && ch <= u'9';
+}
+
+static inline void appendChars(QString *string, const QChar *chars, qsizetype length)
+{
+    string->append(chars, length);
+}
+
+static inline void appendChars(QString *string, const char *utf8, qsizetype length)
+{
+    if (string->isEmpty())
+        *string = QString::fromUtf8(utf8, length);
+    else
+        string->append(QString::fromUtf8(utf8, length));
+}
+
+static inline double toDouble(const QChar *chars, qsizetype length, bool *ok)
+{
+    return QStringView(chars, length).toDouble(ok);
+}
+
+static inline double toDouble(const char *chars, qsizetype length, bool *ok)
+{
+    return QByteArrayView(chars, length).toDouble(ok);
+}
+
+template<typename CharType>
+JsonScanner<CharType>::JsonScanner(const CharType *json, qsizetype length)
+    : head(json), json(json), nestingLevel(0), lastError(QJsonParseError::NoError)
 {
     end = json + length;
 }
 
+template<typename CharType>
+JsonParser<CharType>::JsonParser(ExecutionEngine *engine, const CharType *json, qsizetype length)
+    : JsonScanner<CharType>(json, length), engine(engine)
+{
+}
+
 
 
 /*
@@ -85,10 +139,11 @@ enum {
     Quote = 0x22
 };
 
-bool JsonParser::eatSpace()
+template<typename CharType>
+bool JsonScanner<CharType>::eatSpace()
 {
     while (json < end) {
-        const char16_t ch = json->unicode();
+        const char16_t ch = unit(*json);
         if (ch > Space)
             break;
         if (ch != Space &&
@@ -101,11 +156,12 @@ bool JsonParser::eatSpace()
     return (json < end);
 }
 
-QChar JsonParser::nextToken()
+template<typename CharType>
+QChar JsonScanner<CharType>::nextToken()
 {
     if (!eatSpace())
         return u'\0';
-    QChar token = *json++;
+    QChar token(unit(*json++));
     switch (token.unicode()) {
     case BeginArray:
     case BeginObject:
@@ -127,7 +183,8 @@ QChar JsonParser::nextToken()
 /*
     JSON-text = object / array
 */
-ReturnedValue JsonParser::parse(QJsonParseError *error)
+template<typename CharType>
+ReturnedValue JsonParser<CharType>::parse(QJsonParseError *error)
 {
 #ifdef PARSER_DEBUG
     indent = 0;
@@ -168,7 +225,8 @@ ReturnedValue JsonParser::parse(QJsonParseError *error)
     end-object
 */
 
-ReturnedValue JsonParser::parseObject()
+template<typename CharType>
+ReturnedValue JsonParser<CharType>::parseObject()
 {
     if (++nestingLevel > nestingLimit) {
         lastError = QJsonParseError::DeepNesting;
@@ -209,13 +267,14 @@ ReturnedValue JsonParser::parseObject()
 /*
     member = string name-separator value
 */
-bool JsonParser::parseMember(Object *o)
+template<typename CharType>
+bool JsonParser<CharType>::parseMember(Object *o)
 {
     BEGIN << "parseMember";
     Scope scope(engine);
 
-    QString key;
-    if (!parseString(&key))
+    ScopedPropertyKey key(scope);
+    if (!parseKey(o->internalClass(), key.ptr))
         return false;
     QChar token = nextToken();
     if (token.unicode() != NameSeparator) {
@@ -226,23 +285,61 @@ bool JsonParser::parseMember(Object *o)
     if (!parseValue(val))
         return false;
 
-    ScopedString s(scope, engine->newString(key));
-    PropertyKey skey = s->toPropertyKey();
-    if (skey.isArrayIndex()) {
-        o->put(skey.asArrayIndex(), val);
+    if (key->isArrayIndex()) {
+        o->put(key->asArrayIndex(), val);
     } else {
         // avoid trouble with properties named __proto__
-        o->insertMember(s, val);
+        InternalClassEntry idx;
+        Heap::InternalClass::addMember(o, key, Attr_Data, &idx);
+        o->setProperty(idx.index, val);
     }
 
     END;
     return true;
 }
 
+template<typename CharType>
+bool JsonParser<CharType>::parseKey(Heap::InternalClass *ic, PropertyKey *key)
+{
+    const CharType *start = json;
+    while (json < end) {
+        const char16_t ch = unit(*json);
+        if (ch == Quote || ch == u'\\' || ch <= 0x1f)
+            break;
+        ++json;
+    }
+
+    // Array indices never show up as transitions, so don't bother for those.
+    if (json < end && unit(*json) == Quote && json > start && !isDigit(unit(*start))
+            && ic->transitions.size() <= maxTransitionsToScan) {
+        PropertyAttributes data(Attr_Data);
+        data.resolve();
+        const QAnyStringView name(start, json - start);
+        for (const InternalClassTransition &t : std::as_const(ic->transitions)) {
+            // Without a live target class, nothing keeps the key alive.
+            if (!t.lookup || t.flags != int(data.all()) || !t.id.isString())
+                continue;
+            if (QAnyStringView::equal(name, t.id.asStringOrSymbol()->toQString())) {
+                ++json;
+                *key = t.id;
+                return true;
+            }
+        }
+    }
+
+    json = start;
+    QString string;
+    if (!parseString(&string))
+        return false;
+    *key = engine->identifierTable->asPropertyKey(string);
+    return true;
+}
+
 /*
     array = begin-array [ value *( value-separator value ) ] end-array
 */
-ReturnedValue JsonParser::parseArray()
+template<typename CharType>
+ReturnedValue JsonParser<CharType>::parseArray()
 {
     Scope scope(engine);
     BEGIN << "parseArray";
@@ -257,12 +354,12 @@ ReturnedValue JsonParser::parseArray()
         lastError = QJsonParseError::UnterminatedArray;
         return Encode::undefined();
     }
-    if (json->unicode() == EndArray) {
+    if (unit(*json) == EndArray) {
         nextToken();
     } else {
         uint index = 0;
+        ScopedValue val(scope);
         while (1) {
-            ScopedValue val(scope);
             if (!parseValue(val))
                 return Encode::undefined();
             array->arraySet(index, val);
@@ -292,19 +389,20 @@ value = false / null / true / object / array / number / string
 
 */
 
-bool JsonParser::parseValue(Value *val)
+template<typename CharType>
+bool JsonParser<CharType>::parseValue(Value *val)
 {
     BEGIN << "parse Value" << *json;
 
-    switch ((json++)->unicode()) {
+    switch (unit(*json++)) {
     case u'n':
         if (end - json < 3) {
             lastError = QJsonParseError::IllegalValue;
             return false;
         }
-        if (*json++ == u'u' &&
-            *json++ == u'l' &&
-            *json++ == u'l') {
+        if (unit(*json++) == u'u' &&
+            unit(*json++) == u'l' &&
+            unit(*json++) == u'l') {
             *val = Value::nullValue();
             DEBUG << "value: null";
             END;
@@ -317,9 +415,9 @@ bool JsonParser::parseValue(Value *val)
             lastError = QJsonParseError::IllegalValue;
             return false;
         }
-        if (*json++ == u'r' &&
-            *json++ == u'u' &&
-            *json++ == u'e') {
+        if (unit(*json++) == u'r' &&
+            unit(*json++) == u'u' &&
+            unit(*json++) == u'e') {
             *val = Value::fromBoolean(true);
             DEBUG << "value: true";
             END;
@@ -332,10 +430,10 @@ bool JsonParser::parseValue(Value *val)
             lastError = QJsonParseError::IllegalValue;
             return false;
         }
-        if (*json++ == u'a' &&
-            *json++ == u'l' &&
-            *json++ == u's' &&
-            *json++ == u'e') {
+        if (unit(*json++) == u'a' &&
+            unit(*json++) == u'l' &&
+            unit(*json++) == u's' &&
+            unit(*json++) == u'e') {
             *val = Value::fromBoolean(false);
             DEBUG << "value: false";
             END;
@@ -400,59 +498,65 @@ bool JsonParser::parseValue(Value *val)
 
 */
 
-bool JsonParser::parseNumber(Value *val)
+template<typename CharType>
+bool JsonScanner<CharType>::parseNumber(Value *val)
 {
     BEGIN << "parseNumber" << *json;
 
-    const QChar *start = json;
+    const CharType *start = json;
     bool isInt = true;
+    bool isNegative = false;
 
     // minus
-    if (json < end && *json == u'-')
+    if (json < end && unit(*json) == u'-') {
+        isNegative = true;
         ++json;
+    }
 
     // int = zero / ( digit1-9 *DIGIT )
-    if (json < end && *json == u'0') {
+    const CharType *digits = json;
+    int n = 0;
+    if (json < end && unit(*json) == u'0') {
         ++json;
     } else {
-        while (json < end && *json >= u'0' && *json <= u'9')
+        // Accumulate at most 9 digits, so that n cannot overflow.
+        while (json < end && isDigit(unit(*json))) {
+            if (json - digits < 9)
+                n = n * 10 + (unit(*json) - u'0');
+            else
+                isInt = false;
             ++json;
+        }
     }
 
     // frac = decimal-point 1*DIGIT
-    if (json < end && *json == u'.') {
+    if (json < end && unit(*json) == u'.') {
         isInt = false;
         ++json;
-        while (json < end && *json >= u'0' && *json <= u'9')
+        while (json < end && isDigit(unit(*json)))
             ++json;
     }
 
     // exp = e [ minus / plus ] 1*DIGIT
-    if (json < end && (*json == u'e' || *json == u'E')) {
+    if (json < end && (unit(*json) == u'e' || unit(*json) == u'E')) {
         isInt = false;
         ++json;
-        if (json < end && (*json == u'-' || *json == u'+'))
+        if (json < end && (unit(*json) == u'-' || unit(*json) == u'+'))
             ++json;
-        while (json < end && *json >= u'0' && *json <= u'9')
+        while (json < end && isDigit(unit(*json)))
             ++json;
     }
 
-    QString number(start, json - start);
-    DEBUG << "numberstring" << number;
-
-    if (isInt) {
-        bool ok;
-        int n = number.toInt(&ok);
-        if (ok && n < (1<<25) && n > -(1<<25)) {
-            *val = Value::fromInt32(n);
-            END;
-            return true;
-        }
+    // -0 has to stay a double
+    if (isInt && json > digits && !(isNegative && n == 0)) {
+        *val = Value::fromInt32(isNegative ? -n : n);
+        END;
+        return true;
     }
 
     bool ok;
-    double d;
-    d = number.toDouble(&ok);
+    double d = toDouble(start, json - start, &ok);
+    DEBUG << "number" << d;
 
     if (!ok) {
         lastError = QJsonParseError::IllegalNumber;
@@ -487,9 +591,8 @@ bool JsonParser::parseNumber(Value *val)
 
         unescaped = %x20-21 / %x23-5B / %x5D-10FFFF
  */
-static inline bool addHexDigit(QChar digit, uint *result)
+static inline bool addHexDigit(char16_t d, uint *result)
 {
-    ushort d = digit.unicode();
     *result <<= 4;
     if (d >= u'0' && d <= u'9')
         *result |= (d - u'0');
@@ -502,14 +605,15 @@ static inline bool addHexDigit(QChar digit, uint *result)
     return true;
 }
 
-static inline bool scanEscapeSequence(const QChar *&json, const QChar *end, uint *ch)
+template<typename CharType>
+static inline bool scanEscapeSequence(const CharType *&json, const CharType *end, uint *ch)
 {
     ++json;
     if (json >= end)
         return false;
 
     DEBUG << "scan escape";
-    uint escaped = (json++)->unicode();
+    uint escaped = unit(*json++);
     switch (escaped) {
     case u'"':
         *ch = '"'; break;
@@ -532,7 +636,7 @@ static inline bool scanEscapeSequence(const QChar *&json, const QChar *end, uint
         if (json > end - 4)
             return false;
         for (int i = 0; i < 4; ++i) {
-            if (!addHexDigit(*json, ch))
+            if (!addHexDigit(unit(*json), ch))
                 return false;
             ++json;
         }
@@ -545,14 +649,30 @@ static inline bool scanEscapeSequence(const QChar *&json, const QChar *end, uint
 }
 
 
-bool JsonParser::parseString(QString *string)
+template<typename CharType>
+bool JsonScanner<CharType>::parseString(QString *string)
 {
     BEGIN << "parse string stringPos=" << json;
 
     while (json < end) {
-        if (*json == u'"')
+        // Copy runs of unescaped characters in one go. For UTF-8 input this
+        // also keeps multi-byte sequences together.
+        const CharType *run = json;
+        while (json < end) {
+            const char16_t ch = unit(*json);
+            if (ch == Quote || ch == u'\\' || ch <= 0x1f)
+                break;
+            ++json;
+        }
+        if (json > run)
+            appendChars(string, run, json - run);
+        if (json >= end)
             break;
-        else if (*json == u'\\') {
+
+        const char16_t next = unit(*json);
+        if (next == Quote) {
+            break;
+        } else if (next == u'\\') {
             uint ch = 0;
             if (!scanEscapeSequence(json, end, &ch)) {
                 lastError = QJsonParseError::IllegalEscapeSequence;
@@ -564,12 +684,8 @@ bool JsonParser::parseString(QString *string)
                 *string += QChar(ch);
             }
         } else {
-            if (json->unicode() <= 0x1f) {
-                lastError = QJsonParseError::IllegalEscapeSequence;
-                return false;
-            }
-            *string += *json;
-            ++json;
+            lastError = QJsonParseError::IllegalEscapeSequence;
+            return false;
         }
     }
     ++json;
@@ -583,9 +699,348 @@ bool JsonParser::parseString(QString *string)
     return true;
 }
 
+template class JsonScanner<QChar>;
+template class JsonScanner<char>;
+template class JsonParser<QChar>;
+template class JsonParser<char>;
+
+namespace QV4 {
+
+// Same grammar as JsonParser, but records the tokens on a JsonTape instead of
+// creating JS values.
+template<typename CharType>
+class JsonTokenizer : public JsonScanner<CharType>
+{
+public:
+    JsonTokenizer(JsonTape *tape, const CharType *json, qsizetype length)
+        : JsonScanner<CharType>(json, length), tape(tape)
+    {}
+
+    void tokenize();
+
+private:
+    using JsonScanner<CharType>::eatSpace;
+    using JsonScanner<CharType>::nextToken;
+    using JsonScanner<CharType>::parseString;
+    using JsonScanner<CharType>::parseNumber;
+    using JsonScanner<CharType>::head;
+    using JsonScanner<CharType>::json;
+    using JsonScanner<CharType>::end;
+    using JsonScanner<CharType>::nestingLevel;
+    using JsonScanner<CharType>::lastError;
+
+    bool parseObject();
+    bool parseArray();
+    bool parseMember();
+    bool parseValue();
+    bool parseLiteral(const char *rest, JsonTape::Kind kind);
+
+    void append(JsonTape::Kind kind, int value = 0) { tape->m_entries.append({ kind, value }); }
+
+    JsonTape *tape;
+    QHash<QString, int> keyIndices;
+};
+
+}
+
+template<typename CharType>
+void JsonTokenizer<CharType>::tokenize()
+{
+    eatSpace();
+    if (!parseValue() || eatSpace()) {
+        if (lastError == QJsonParseError::NoError)
+            lastError = QJsonParseError::IllegalValue;
+        tape->m_error.offset = json - head;
+        tape->m_error.error = lastError;
+        tape->m_entries.clear();
+        tape->m_doubles.clear();
+        tape->m_strings.clear();
+        tape->m_keys.clear();
+        return;
+    }
+
+    tape->m_error.offset = 0;
+    tape->m_error.error = QJsonParseError::NoError;
+}
+
+template<typename CharType>
+bool JsonTokenizer<CharType>::parseObject()
+{
+    if (++nestingLevel > nestingLimit) {
+        lastError = QJsonParseError::DeepNesting;
+        return false;
+    }
+
+    append(JsonTape::BeginObject);
+
+    QChar token = nextToken();
+    while (token.unicode() == Quote) {
+        if (!parseMember())
+            return false;
+        token = nextToken();
+        if (token.unicode() != ValueSeparator)
+            break;
+        token = nextToken();
+        if (token.unicode() == EndObject) {
+            lastError = QJsonParseError::MissingObject;
+            return false;
+        }
+    }
+
+    if (token.unicode() != EndObject) {
+        lastError = QJsonParseError::UnterminatedObject;
+        return false;
+    }
+
+    append(JsonTape::End);
+    --nestingLevel;
+    return true;
+}
+
+template<typename CharType>
+bool JsonTokenizer<CharType>::parseMember()
+{
+    QString key;
+    if (!parseString(&key))
+        return false;
+
+    const auto it = keyIndices.constFind(key);
+    if (it != keyIndices.constEnd()) {
+        append(JsonTape::Key, *it);
+    } else {
+        const int index = tape->m_keys.size();
+        keyIndices.insert(key, index);
+        tape->m_keys.append(std::move(key));
+        append(JsonTape::Key, index);
+    }
+
+    if (nextToken().unicode() != NameSeparator) {
+        lastError = QJsonParseError::MissingNameSeparator;
+        return false;
+    }
+    return parseValue();
+}
+
+template<typename CharType>
+bool JsonTokenizer<CharType>::parseArray()
+{
+    if (++nestingLevel > nestingLimit) {
+        lastError = QJsonParseError::DeepNesting;
+        return false;
+    }
+
+    append(JsonTape::BeginArray);
+
+    if (!eatSpace()) {
+        lastError = QJsonParseError::UnterminatedArray;
+        return false;
+    }
+    if (unit(*json) == EndArray) {
+        nextToken();
+    } else {
+        while (1) {
+            if (!parseValue())
+                return false;
+            QChar token = nextToken();
+            if (token.unicode() == EndArray)
+                break;
+            else if (token.unicode() != ValueSeparator) {
+                if (!eatSpace())
+                    lastError = QJsonParseError::UnterminatedArray;
+                else
+                    lastError = QJsonParseError::MissingValueSeparator;
+                return false;
+            }
+        }
+    }
+
+    append(JsonTape::End);
+    --nestingLevel;
+    return true;
+}
+
+template<typename CharType>
+bool JsonTokenizer<CharType>::parseLiteral(const char *rest, JsonTape::Kind kind)
+{
+    for (; *rest; ++rest) {
+        if (json >= end || unit(*json++) != char16_t(*rest)) {
+            lastError = QJsonParseError::IllegalValue;
+            return false;
+        }
+    }
+    append(kind);
+    return true;
+}
+
+template<typename CharType>
+bool JsonTokenizer<CharType>::parseValue()
+{
+    switch (unit(*json++)) {
+    case u'n':
+        return parseLiteral("ull", JsonTape::Null);
+    case u't':
+        return parseLiteral("rue", JsonTape::True);
+    case u'f':
+        return parseLiteral("alse", JsonTape::False);
+    case Quote: {
+        QString value;
+        if (!parseString(&value))
+            return false;
+        append(JsonTape::String, tape->m_strings.size());
+        tape->m_strings.append(std::move(value));
+        return true;
+    }
+    case BeginArray:
+        return parseArray();
+    case BeginObject:
+        return parseObject();
+    case EndArray:
+        lastError = QJsonParseError::MissingObject;
+        return false;
+    default: {
+        --json;
+        Value number = Value::undefinedValue();
+        if (!parseNumber(&number))
+            return false;
+        if (number.isInteger()) {
+            append(JsonTape::Int, number.integerValue());
+        } else {
+            append(JsonTape::Double, tape->m_doubles.size());
+            tape->m_doubles.append(number.doubleValue());
+        }
+        return true;
+    }
+    }
+}
+
+JsonTape JsonTape::tokenize(QByteArrayView utf8)
+{
+    JsonTape tape;
+    JsonTokenizer<char>(&tape, utf8.data(), utf8.size()).tokenize();
+    return tape;
+}
+
+JsonTape JsonTape::tokenize(QStringView text)
+{
+    JsonTape tape;
+    JsonTokenizer<QChar>(&tape, text.data(), text.size()).tokenize();
+    return tape;
+}
+
+namespace QV4 {
+
+struct JsonMaterializer
+{
+    JsonMaterializer(ExecutionEngine *engine, const JsonTape *tape)
+        : engine(engine), tape(tape), keys(tape->m_keys.size(), PropertyKey::invalid())
+    {}
+
+    ReturnedValue materialize();
+
+    ExecutionEngine *engine;
+    const JsonTape *tape;
+    const JsonTape::Entry *entry = nullptr;
+
+    // Each distinct key is interned only once. The strings are kept alive
+    // through keyStrings, as nothing else may reference them yet.
+    QList<PropertyKey> keys;
+    ArrayObject *keyStrings = nullptr;
+    uint keyStringCount = 0;
+};
+
+}
+
+ReturnedValue JsonMaterializer::materialize()
+{
+    const JsonTape::Entry &e = *entry++;
+    switch (e.kind) {
+    case JsonTape::Null:
+        return Encode::null();
+    case JsonTape::False:
+        return Encode(false);
+    case JsonTape::True:
+        return Encode(true);
+    case JsonTape::Int:
+        return Encode(e.value);
+    case JsonTape::Double:
+        return Encode(tape->m_doubles.at(e.value));
+    case JsonTape::String:
+        return engine->newString(tape->m_strings.at(e.value))->asReturnedValue();
+    case JsonTape::BeginObject: {
+        Scope scope(engine);
+        ScopedObject o(scope, engine->newObject());
+        ScopedValue val(scope);
+        while (entry->kind != JsonTape::End) {
+            Q_ASSERT(entry->kind == JsonTape::Key);
+            PropertyKey &key = keys[entry++->value];
+            if (!key.isValid()) {
+                key = engine->identifierTable->asPropertyKey(tape->m_keys.at(entry[-1].value));
+                if (key.isStringOrSymbol())
+                    keyStrings->arraySet(keyStringCount++, Value::fromHeapObject(key.asStringOrSymbol()));
+            }
+
+            val = materialize();
+            if (key.isArrayIndex()) {
+                o->put(key.asArrayIndex(), val);
+            } else {
+                // avoid trouble with properties named __proto__
+                InternalClassEntry idx;
+                Heap::InternalClass::addMember(o, key, Attr_Data, &idx);
+                o->setProperty(idx.index, val);
+            }
+        }
+        ++entry;
+        return o.asReturnedValue();
+    }
+    case JsonTape::BeginArray: {
+        Scope scope(engine);
+        ScopedArrayObject array(scope, engine->newArrayObject());
+        ScopedValue val(scope);
+        uint index = 0;
+        while (entry->kind != JsonTape::End) {
+            val = materialize();
+            array->arraySet(index++, val);
+        }
+        ++entry;
+        return array.asReturnedValue();
+    }
+    case JsonTape::Key:
+    case JsonTape::End:
+        break;
+    }
+    Q_UNREACHABLE_RETURN(Encode::undefined());
+}
+
+ReturnedValue JsonTape::materialize(ExecutionEngine *engine) const
+{
+    if (m_error.error != QJsonParseError::NoError || m_entries.isEmpty())
+        return Encode::undefined();
+
+    Scope scope(engine);
+    JsonMaterializer materializer(engine, this);
+    ScopedArrayObject keyStrings(scope, engine->newArrayObject());
+    materializer.keyStrings = keyStrings.getPointer();
+    materializer.entry = m_entries.constData();
+    return materializer.materialize();
+}
+
 
 struct Stringify
 {
+    // Plain objects are serialized from their internal class alone: the
+    // enumerable, string-keyed data members and their quoted keys are
+    // collected once per internal class and reused for all objects sharing it.
+    struct SerializationPlan
+    {
+        struct Member
+        {
+            PropertyKey key;
+            uint index;
+            QString quotedKey;
+        };
+        QList<Member> members;
+    };
+
     ExecutionEngine *v4;
     FunctionObject *replacerFunction;
     QV4::String *propertyList;
@@ -593,6 +1048,12 @@ struct Stringify
     QString gap;
     QString indent;
     QStack<Object *> stack;
+    QString output;
+    String *toJSON;
+    // Keeps the internal classes in plans alive, so that their addresses
+    // cannot be reused for different classes during the call.
+    Object *planClasses;
+    QHash<Heap::InternalClass *, SerializationPlan> plans;
 
     bool stackContains(Object *o) {
         for (int i = 0; i < stack.size(); ++i)
@@ -601,13 +1062,17 @@ struct Stringify
         return false;
     }
 
-    Stringify(ExecutionEngine *e) : v4(e), replacerFunction(nullptr), propertyList(nullptr), propertyListSize(0) {}
+    Stringify(ExecutionEngine *e)
+        : v4(e), replacerFunction(nullptr), propertyList(nullptr), propertyListSize(0),
+          toJSON(nullptr), planClasses(nullptr)
+    {}
 
-    QString Str(const QString &key, const Value &v);
-    QString JA(Object *a);
-    QString JO(Object *o);
+    bool Str(const Value &key, const Value &v);
+    void JA(Object *a);
+    void JO(Object *o);
 
-    QString makeMember(const QString &key, const Value &v);
+    void makeMember(const Value &key, const QString *quotedKey, const Value &v, bool *empty);
+    const SerializationPlan *planFor(Object *o);
 };
 
 class [[nodiscard]] CallDepthAndCycleChecker
@@ -633,72 +1098,97 @@ private:
     ExecutionEngineCallDepthRecorder<1> m_callDepthRecorder;
 };
 
-static QString quote(const QString &str)
+// Checks four UTF-16 code units at once for characters that need escaping:
+// control characters, '"' and '\\'.
+static inline bool needsEscape(quint64 block)
+{
+    constexpr quint64 ones = 0x0001000100010001ULL;
+    constexpr quint64 highBits = 0x8000800080008000ULL;
+    const auto hasZero = [&](quint64 v) { return (v - ones) & ~v & highBits; };
+    return ((block - ones * 0x20) & ~block & highBits)
+            || hasZero(block ^ (ones * u'"'))
+            || hasZero(block ^ (ones * u'\\'));
+}
+
+static void quote(QString *product, QStringView str)
 {
-    QString product;
-    const int length = str.size();
-    product.reserve(length + 2);
-    product += u'"';
-    for (int i = 0; i < length; ++i) {
-        QChar c = str.at(i);
-        switch (c.unicode()) {
+    const char16_t *begin = str.utf16();
+    const char16_t *end = begin + str.size();
+    const char16_t *run = begin;
+
+    product->reserve(product->size() + str.size() + 2);
+    *product += u'"';
+    for (const char16_t *c = begin; c < end;) {
+        if (end - c >= 4) {
+            quint64 block;
+            memcpy(&block, c, sizeof(block));
+            if (!needsEscape(block)) {
+                c += 4;
+                continue;
+            }
+        }
+
+        const char16_t ch = *c;
+        if (ch >= 0x20 && ch != u'"' && ch != u'\\') {
+            ++c;
+            continue;
+        }
+
+        product->append(QStringView(run, c));
+        switch (ch) {
         case u'"':
-            product += QLatin1String("\\\"");
+            *product += QLatin1String("\\\"");
             break;
         case u'\\':
-            product += QLatin1String("\\\\");
+            *product += QLatin1String("\\\\");
             break;
         case u'\b':
-            product += QLatin1String("\\b");
+            *product += QLatin1String("\\b");
             break;
         case u'\f':
-            product += QLatin1String("\\f");
+            *product += QLatin1String("\\f");
             break;
         case u'\n':
-            product += QLatin1String("\\n");
+            *product += QLatin1String("\\n");
             break;
         case u'\r':
-            product += QLatin1String("\\r");
+            *product += QLatin1String("\\r");
             break;
         case u'\t':
-            product += QLatin1String("\\t");
+            *product += QLatin1String("\\t");
             break;
         default:
-            if (c.unicode() <= 0x1f) {
-                product += QLatin1String("\\u00");
-                product += (c.unicode() > 0xf ? u'1' : u'0') +
-                        QLatin1Char("0123456789abcdef"[c.unicode() & 0xf]);
-            } else {
-                product += c;
-            }
+            *product += QLatin1String("\\u00");
+            *product += (ch > 0xf ? u'1' : u'0');
+            *product += QLatin1Char("0123456789abcdef"[ch & 0xf]);
         }
+        run = ++c;
     }
-    product += u'"';
-    return product;
+    product->append(QStringView(run, end));
+    *product += u'"';
 }
 
-QString Stringify::Str(const QString &key, const Value &v)
+bool Stringify::Str(const Value &key, const Value &v)
 {
     Scope scope(v4);
 
     ScopedValue value(scope, v);
     ScopedObject o(scope, value);
     if (o) {
-        ScopedString s(scope, v4->newString(QStringLiteral("toJSON")));
-        ScopedFunctionObject toJSON(scope, o->get(s));
-        if (!!toJSON) {
+        ScopedFunctionObject toJSONFunction(scope, o->get(toJSON));
+        if (!!toJSONFunction) {
             JSCallArguments jsCallData(scope, 1);
             *jsCallData.thisObject = value;
-            jsCallData.args[0] = v4->newString(key);
-            value = toJSON->call(jsCallData);
+            jsCallData.args[0] = key.toString(v4);
+            value = toJSONFunction->call(jsCallData);
             if (v4->hasException)
-                return QString();
+                return false;
         }
     }
 
     if (replacerFunction) {
         JSCallArguments jsCallData(scope, 2);
-        jsCallData.args[0] = v4->newString(key);
+        jsCallData.args[0] = key.toString(v4);
         jsCallData.args[1] = value;
 
         if (stack.isEmpty()) {
@@ -711,7 +1201,7 @@ QString Stringify::Str(const QString &key, const Value &v)
 
         value = replacerFunction->call(jsCallData);
         if (v4->hasException)
-            return QString();
+            return false;
     }
 
     o = value->asReturnedValue();
@@ -724,150 +1214,217 @@ QString Stringify::Str(const QString &key, const Value &v)
             value = Encode(b->value());
     }
 
-    if (value->isNull())
-        return QStringLiteral("null");
-    if (value->isBoolean())
-        return value->booleanValue() ? QStringLiteral("true") : QStringLiteral("false");
-    if (value->isString())
-        return quote(value->stringValue()->toQString());
+    if (value->isNull()) {
+        output += QLatin1String("null");
+        return true;
+    }
+    if (value->isBoolean()) {
+        output += value->booleanValue() ? QLatin1String("true") : QLatin1String("false");
+        return true;
+    }
+    if (value->isString()) {
+        quote(&output, value->stringValue()->toQString());
+        return true;
+    }
 
+    if (value->isInteger()) {
+        char buffer[16];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value->integerValue());
+        output += QLatin1String(buffer, result.ptr - buffer);
+        return true;
+    }
     if (value->isNumber()) {
         double d = value->toNumber();
-        return std::isfinite(d) ? value->toQString() : QStringLiteral("null");
+        if (std::isfinite(d)) {
+            QString number;
+            RuntimeHelpers::numberToString(&number, d);
+            output += number;
+        } else {
+            output += QLatin1String("null");
+        }
+        return true;
     }
 
     if (const QV4::VariantObject *v = value->as<QV4::VariantObject>()) {
-        return quote(v->d()->data().toString());
+        quote(&output, v->d()->data().toString());
+        return true;
     }
 
     o = value->asReturnedValue();
     if (o) {
         if (!o->as<FunctionObject>()) {
             if (o->isArrayLike()) {
-                return JA(o.getPointer());
+                JA(o.getPointer());
             } else {
-                return JO(o);
+                JO(o);
             }
+            return !v4->hasException;
         }
     }
 
-    return QString();
+    return false;
 }
 
-QString Stringify::makeMember(const QString &key, const Value &v)
+void Stringify::makeMember(const Value &key, const QString *quotedKey, const Value &v, bool *empty)
 {
-    QString strP = Str(key, v);
-    if (!strP.isEmpty()) {
-        QString member = quote(key) + u':';
-        if (!gap.isEmpty())
-            member += u' ';
-        member += strP;
-        return member;
-    }
-    return QString();
+    const qsizetype rollback = output.size();
+    if (!*empty)
+        output += u',';
+    if (!gap.isEmpty()) {
+        output += u'\n';
+        output += indent;
+    }
+    if (quotedKey)
+        output += *quotedKey;
+    else
+        quote(&output, key.toQString());
+    output += u':';
+    if (!gap.isEmpty())
+        output += u' ';
+
+    if (Str(key, v))
+        *empty = false;
+    else
+        output.truncate(rollback);
 }
 
-QString Stringify::JO(Object *o)
+const Stringify::SerializationPlan *Stringify::planFor(Object *o)
+{
+    if (o->vtable() != QV4::Object::staticVTable() || o->arrayData())
+        return nullptr;
+
+    Heap::InternalClass *ic = o->internalClass();
+    auto it = plans.constFind(ic);
+    if (it != plans.constEnd())
+        return &*it;
+
+    SerializationPlan plan;
+    for (uint i = 0; i < ic->size; ++i) {
+        const PropertyKey key = ic->nameMap.at(i);
+        if (!key.isStringOrSymbol())
+            continue;
+        const InternalClassEntry e = ic->find(key);
+        if (!e.isValid())
+            continue;
+        // Getters may run arbitrary code; leave those objects to the generic path.
+        if (e.attributes.isAccessor())
+            return nullptr;
+        if (key.isSymbol() || !e.attributes.isEnumerable())
+            continue;
+        QString quotedKey;
+        quote(&quotedKey, key.toQString());
+        plan.members.append({ key, e.index, std::move(quotedKey) });
+    }
+
+    Scope scope(v4);
+    ScopedValue pinned(scope, Value::fromHeapObject(ic));
+    planClasses->push_back(pinned);
+    return &*plans.insert(ic, std::move(plan));
+}
+
+void Stringify::JO(Object *o)
 {
     CallDepthAndCycleChecker check(this, o);
     if (check.foundProblem())
-        return QString();
+        return;
 
     Scope scope(v4);
 
-    QString result;
     stack.push(o);
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
-    if (!propertyListSize) {
-        ObjectIterator it(scope, o, ObjectIterator::EnumerableOnly);
-        ScopedValue name(scope);
-
-        ScopedValue val(scope);
-        while (1) {
-            name = it.nextPropertyNameAsString(val);
-            if (name->isNull())
-                break;
-            QString key = name->toQString();
-            QString member = makeMember(key, val);
-            if (!member.isEmpty())
-                partial += member;
-        }
-    } else {
-        ScopedValue v(scope);
+    output += u'{';
+    bool empty = true;
+    ScopedValue name(scope);
+    ScopedValue val(scope);
+    if (propertyListSize) {
         for (int i = 0; i < propertyListSize; ++i) {
             bool exists;
             String *s = propertyList + i;
-            if (!s)
+            if (!s->m())
                 continue;
-            v = o->get(s, &exists);
+            val = o->get(s, &exists);
             if (!exists)
                 continue;
-            QString member = makeMember(s->toQString(), v);
-            if (!member.isEmpty())
-                partial += member;
+            makeMember(*s, nullptr, val, &empty);
+            if (v4->hasException)
+                break;
+        }
+    } else if (const SerializationPlan *plan = planFor(o)) {
+        Heap::InternalClass *ic = o->internalClass();
+        for (const SerializationPlan::Member &member : plan->members) {
+            // toJSON() or the replacer may have reshaped the object meanwhile.
+            if (o->internalClass() == ic)
+                val = *o->propertyData(member.index);
+            else
+                val = o->get(member.key);
+            name = Value::fromHeapObject(member.key.asStringOrSymbol());
+            makeMember(name, &member.quotedKey, val, &empty);
+            if (v4->hasException)
+                break;
+        }
+    } else {
+        ObjectIterator it(scope, o, ObjectIterator::EnumerableOnly);
+        while (1) {
+            name = it.nextPropertyNameAsString(val);
+            if (name->isNull())
+                break;
+            makeMember(name, nullptr, val, &empty);
+            if (v4->hasException)
+                break;
         }
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("{}");
-    } else if (gap.isEmpty()) {
-        result = u'{' + partial.join(u',') + u'}';
-    } else {
-        QString separator = QLatin1String(",\n") + indent;
-        result = QLatin1String("{\n") + indent + partial.join(separator) + u'\n'
-                 + stepback + u'}';
+    if (!empty && !gap.isEmpty()) {
+        output += u'\n';
+        output += stepback;
     }
+    output += u'}';
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
-QString Stringify::JA(Object *a)
+void Stringify::JA(Object *a)
 {
     CallDepthAndCycleChecker check(this, a);
     if (check.foundProblem())
-        return QString();
+        return;
 
     Scope scope(a->engine());
 
-    QString result;
     stack.push(a);
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
+    output += u'[';
     uint len = a->getLength();
     ScopedValue v(scope);
     for (uint i = 0; i < len; ++i) {
+        if (i)
+            output += u',';
+        if (!gap.isEmpty()) {
+            output += u'\n';
+            output += indent;
+        }
         bool exists;
         v = a->get(i, &exists);
-        if (!exists) {
-            partial += QStringLiteral("null");
-            continue;
+        if (!exists || !Str(Value::fromUInt32(i), v)) {
+            if (v4->hasException)
+                break;
+            output += QLatin1String("null");
         }
-        QString strP = Str(QString::number(i), v);
-        if (!strP.isEmpty())
-            partial += strP;
-        else
-            partial += QStringLiteral("null");
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("[]");
-    } else if (gap.isEmpty()) {
-        result = u'[' + partial.join(u',') + u']';
-    } else {
-        QString separator = QLatin1String(",\n") + indent;
-        result = QLatin1String("[\n") + indent + partial.join(separator) + u'\n' + stepback + u']';
+    if (len && !gap.isEmpty()) {
+        output += u'\n';
+        output += stepback;
     }
+    output += u']';
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
 
@@ -907,6 +1464,10 @@ ReturnedValue JsonObject::method_stringify(const FunctionObject *b, const Value
 {
     Scope scope(b);
     Stringify stringify(scope.engine);
+    ScopedString toJSON(scope, scope.engine->newIdentifier(QStringLiteral("toJSON")));
+    stringify.toJSON = toJSON;
+    ScopedObject planClasses(scope, scope.engine->newArrayObject());
+    stringify.planClasses = planClasses;
 
     ScopedObject o(scope, argc > 1 ? argv[1] : Value::undefinedValue());
     if (o) {
@@ -948,10 +1509,9 @@ ReturnedValue JsonObject::method_stringify(const FunctionObject *b, const Value
 
 
     ScopedValue arg0(scope, argc ? argv[0] : Value::undefinedValue());
-    QString result = stringify.Str(QString(), arg0);
-    if (result.isEmpty() || scope.hasException())
+    if (!stringify.Str(*scope.engine->id_empty(), arg0) || scope.hasException())
         RETURN_UNDEFINED();
-    return Encode(scope.engine->newString(result));
+    return Encode(scope.engine->newString(stringify.output));
 }
 
 
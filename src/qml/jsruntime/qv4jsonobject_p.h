@@ -20,6 +20,8 @@
 #include <qjsonvalue.h>
 #include <qjsondocument.h>
 #include <qhash.h>
+#include <qlist.h>
+#include <qstringlist.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -72,31 +74,104 @@ private:
     static QJsonArray toJsonArray(const Object *o, V4ObjectSet &visitedObjects);
 };
 
-class JsonParser
+// The lexical part of parsing JSON, shared by JsonParser and JsonTape. Works
+// on either UTF-16 text, as passed to JSON.parse(), or UTF-8 encoded bytes, as
+// received from the network, without converting them first.
+template<typename CharType>
+class Q_QML_EXPORT JsonScanner
+{
+protected:
+    JsonScanner(const CharType *json, qsizetype length);
+
+    inline bool eatSpace();
+    inline QChar nextToken();
+
+    bool parseString(QString *string);
+    bool parseNumber(Value *val);
+
+    const CharType *head;
+    const CharType *json;
+    const CharType *end;
+
+    int nestingLevel;
+    QJsonParseError::ParseError lastError;
+};
+
+extern template class JsonScanner<QChar>;
+extern template class JsonScanner<char>;
+
+template<typename CharType>
+class Q_QML_EXPORT JsonParser : public JsonScanner<CharType>
 {
 public:
-    JsonParser(ExecutionEngine *engine, const QChar *json, int length);
+    JsonParser(ExecutionEngine *engine, const CharType *json, qsizetype length);
 
     ReturnedValue parse(QJsonParseError *error);
 
 private:
-    inline bool eatSpace();
-    inline QChar nextToken();
+    using JsonScanner<CharType>::eatSpace;
+    using JsonScanner<CharType>::nextToken;
+    using JsonScanner<CharType>::parseString;
+    using JsonScanner<CharType>::parseNumber;
+    using JsonScanner<CharType>::head;
+    using JsonScanner<CharType>::json;
+    using JsonScanner<CharType>::end;
+    using JsonScanner<CharType>::nestingLevel;
+    using JsonScanner<CharType>::lastError;
 
     ReturnedValue parseObject();
     ReturnedValue parseArray();
     bool parseMember(Object *o);
-    bool parseString(QString *string);
+    bool parseKey(Heap::InternalClass *ic, PropertyKey *key);
     bool parseValue(Value *val);
-    bool parseNumber(Value *val);
 
     ExecutionEngine *engine;
-    const QChar *head;
-    const QChar *json;
-    const QChar *end;
+};
 
-    int nestingLevel;
-    QJsonParseError::ParseError lastError;
+extern template class JsonParser<QChar>;
+extern template class JsonParser<char>;
+
+// JSON text split into tokens, with all strings decoded and all numbers
+// converted. Tokenizing does not touch the JS heap and can therefore run on
+// any thread. materialize() then creates the JS values on the engine's thread
+// in a single pass, without looking at the text again.
+class Q_QML_EXPORT JsonTape
+{
+public:
+    static JsonTape tokenize(QByteArrayView utf8);
+    static JsonTape tokenize(QStringView text);
+
+    QJsonParseError error() const { return m_error; }
+    ReturnedValue materialize(ExecutionEngine *engine) const;
+
+private:
+    template<typename CharType>
+    friend class JsonTokenizer;
+    friend struct JsonMaterializer;
+
+    enum Kind : quint8 {
+        Null,
+        False,
+        True,
+        Int,            // value is the number itself
+        Double,         // value indexes m_doubles
+        String,         // value indexes m_strings
+        Key,            // value indexes m_keys
+        BeginObject,
+        BeginArray,
+        End
+    };
+
+    struct Entry {
+        Kind kind;
+        int value;
+    };
+
+    QList<Entry> m_entries;
+    QList<double> m_doubles;
+    QStringList m_strings;
+    QStringList m_keys;     // each distinct member name once
+    QJsonParseError m_error = { 0, QJsonParseError::NoError };
 };
 
 }
@@ -10,8 +10,12 @@
 #include <private/qv4runtime_p.h>
 #include <private/qv4stackframe_p.h>
 
+#include <QtCore/qloggingcategory.h>
+
 QT_BEGIN_NAMESPACE
 
+Q_STATIC_LOGGING_CATEGORY(lcLookupStats, "qt.qml.lookup.statistics")
+
 using namespace QV4;
 
 
@@ -156,6 +160,28 @@ static inline void setupProtoLookupTwoClasses(Lookup *lookup, const Lookup &firs
     lookup->protoLookupTwoClasses.data2 = data2;
 }
 
+static inline PropertyKey lookupName(const Lookup *lookup, ExecutionEngine *engine)
+{
+    return engine->identifierTable->asPropertyKey(
+            engine->currentStackFrame->v4Function->compilationUnit->runtimeStrings[lookup->nameIndex]);
+}
+
+static MegamorphicLookupCache *makeMegamorphic(Lookup *lookup, ExecutionEngine *engine)
+{
+    if (!engine->megamorphicLookupCache)
+        engine->megamorphicLookupCache = new MegamorphicLookupCache;
+    ++engine->megamorphicLookupCache->megamorphicSites;
+    lookup->call = Lookup::Call::GetterMegamorphic;
+    return engine->megamorphicLookupCache;
+}
+
+static ReturnedValue getterMegamorphicMiss(
+        Lookup *lookup, ExecutionEngine *engine, const Value &object)
+{
+    makeMegamorphic(lookup, engine);
+    return Lookup::getterMegamorphic(lookup, engine, object);
+}
+
 ReturnedValue Lookup::getterTwoClasses(Lookup *lookup, ExecutionEngine *engine, const Value &object)
 {
     if (const Object *o = object.as<Object>()) {
@@ -225,6 +251,10 @@ ReturnedValue Lookup::getterTwoClasses(Lookup *lookup, ExecutionEngine *engine,
 
         // If any of the above options were true, the propertyCache was inactive.
         second.releasePropertyCache();
+
+        // More than two shapes. Continue through the megamorphic cache.
+        makeMegamorphic(lookup, engine)->insert(second, lookupName(lookup, engine));
+        return result;
     }
 
     lookup->call = Call::GetterQObjectPropertyFallback;
@@ -290,6 +320,7 @@ ReturnedValue Lookup::getter0Inlinegetter0Inline(Lookup *lookup, ExecutionEngine
             return o->inlinePropertyDataWithOffset(lookup->objectLookupTwoClasses.offset)->asReturnedValue();
         if (lookup->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->inlinePropertyDataWithOffset(lookup->objectLookupTwoClasses.offset2)->asReturnedValue();
+        return getterMegamorphicMiss(lookup, engine, object);
     }
     lookup->call = Call::GetterQObjectPropertyFallback;
     return getterFallback(lookup, engine, object);
@@ -305,6 +336,7 @@ ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *lookup, ExecutionEn
             return o->inlinePropertyDataWithOffset(lookup->objectLookupTwoClasses.offset)->asReturnedValue();
         if (lookup->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->memberData->values.data()[lookup->objectLookupTwoClasses.offset2].asReturnedValue();
+        return getterMegamorphicMiss(lookup, engine, object);
     }
     lookup->call = Call::GetterQObjectPropertyFallback;
     return getterFallback(lookup, engine, object);
@@ -320,6 +352,7 @@ ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *lookup, Executi
             return o->memberData->values.data()[lookup->objectLookupTwoClasses.offset].asReturnedValue();
         if (lookup->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->memberData->values.data()[lookup->objectLookupTwoClasses.offset2].asReturnedValue();
+        return getterMegamorphicMiss(lookup, engine, object);
     }
     lookup->call = Call::GetterQObjectPropertyFallback;
     return getterFallback(lookup, engine, object);
@@ -338,7 +371,7 @@ ReturnedValue Lookup::getterProtoTwoClasses(Lookup *lookup, ExecutionEngine *eng
             return lookup->protoLookupTwoClasses.data->asReturnedValue();
         if (lookup->protoLookupTwoClasses.protoId2 == o->internalClass->protoId)
             return lookup->protoLookupTwoClasses.data2->asReturnedValue();
-        return getterFallback(lookup, engine, object);
+        return getterMegamorphicMiss(lookup, engine, object);
     }
     lookup->call = Call::GetterQObjectPropertyFallback;
     return getterFallback(lookup, engine, object);
@@ -358,6 +391,7 @@ ReturnedValue Lookup::getterAccessor(Lookup *lookup, ExecutionEngine *engine, co
             return checkedResult(engine, static_cast<const FunctionObject *>(getter)->call(
                                      &object, nullptr, 0));
         }
+        return getterMegamorphicMiss(lookup, engine, object);
     }
     lookup->call = Call::GetterQObjectPropertyFallback;
     return getterFallback(lookup, engine, object);
@@ -403,6 +437,7 @@ ReturnedValue Lookup::getterProtoAccessorTwoClasses(Lookup *lookup, ExecutionEng
             return checkedResult(engine, static_cast<const FunctionObject *>(getter)->call(
                                      &object, nullptr, 0));
         }
+        return getterMegamorphicMiss(lookup, engine, object);
     }
     lookup->call = Call::GetterQObjectPropertyFallback;
     return getterFallback(lookup, engine, object);
@@ -425,6 +460,67 @@ ReturnedValue Lookup::getterIndexed(Lookup *lookup, ExecutionEngine *engine, con
     return getterFallback(lookup, engine, object);
 }
 
+ReturnedValue Lookup::getterMegamorphic(Lookup *lookup, ExecutionEngine *engine, const Value &object)
+{
+    // Otherwise we cannot trust the protoIds
+    Q_ASSERT(engine->isInitialized);
+
+    MegamorphicLookupCache *cache = engine->megamorphicLookupCache;
+    Q_ASSERT(cache);
+
+    // we can safely cast to a QV4::Object here. If object is actually a string,
+    // neither the internal class nor the protoId will match
+    Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    if (!o)
+        return getterFallback(lookup, engine, object);
+
+    const PropertyKey name = lookupName(lookup, engine);
+    const MegamorphicLookupCache::Entry *entry = cache->find(quintptr(o->internalClass.get()), name);
+    if (!entry)
+        entry = cache->find(o->internalClass->protoId, name);
+
+    if (entry) {
+        ++cache->hits;
+        const Value *getter = nullptr;
+        switch (entry->kind) {
+        case MegamorphicLookupCache::Inline:
+            return o->inlinePropertyDataWithOffset(entry->offset)->asReturnedValue();
+        case MegamorphicLookupCache::MemberData:
+            return o->memberData->values.data()[entry->offset].asReturnedValue();
+        case MegamorphicLookupCache::Proto:
+            return entry->data->asReturnedValue();
+        case MegamorphicLookupCache::Accessor:
+            getter = o->propertyData(entry->offset);
+            break;
+        case MegamorphicLookupCache::ProtoAccessor:
+            getter = entry->data;
+            break;
+        }
+
+        if (!getter->isFunctionObject()) // ### catch at resolve time
+            return Encode::undefined();
+
+        return checkedResult(engine, static_cast<const FunctionObject *>(getter)->call(
+                                 &object, nullptr, 0));
+    }
+
+    ++cache->misses;
+    const Object *resolvable = object.as<Object>();
+    if (!resolvable)
+        return getterFallback(lookup, engine, object);
+
+    // Resolve on a scratch lookup, as in getterTwoClasses(), and remember the result.
+    Lookup resolved;
+    memset(&resolved, 0, sizeof(Lookup));
+    resolved.nameIndex = lookup->nameIndex;
+    resolved.forCall = lookup->forCall;
+    resolved.call = Call::GetterGeneric;
+    const ReturnedValue result = resolved.resolveGetter(engine, resolvable);
+    cache->insert(resolved, name);
+    resolved.releasePropertyCache();
+    return result;
+}
+
 ReturnedValue Lookup::getterQObject(Lookup *lookup, ExecutionEngine *engine, const Value &object)
 {
     const auto revertLookup = [lookup, engine, &object]() {
@@ -741,4 +837,46 @@ bool Lookup::arrayLengthSetter(Lookup *, ExecutionEngine *engine, Value &object,
     return true;
 }
 
+MegamorphicLookupCache::~MegamorphicLookupCache()
+{
+    qCDebug(lcLookupStats) << "Megamorphic lookup sites:" << megamorphicSites
+                           << "cache hits:" << hits << "cache misses:" << misses;
+}
+
+void MegamorphicLookupCache::insert(const Lookup &resolved, PropertyKey key)
+{
+    Entry entry = {};
+    entry.key = key.id();
+    switch (resolved.call) {
+    case Lookup::Call::Getter0Inline:
+        entry.kind = Inline;
+        break;
+    case Lookup::Call::Getter0MemberData:
+        entry.kind = MemberData;
+        break;
+    case Lookup::Call::GetterAccessor:
+        entry.kind = Accessor;
+        break;
+    case Lookup::Call::GetterProto:
+        entry.kind = Proto;
+        break;
+    case Lookup::Call::GetterProtoAccessor:
+        entry.kind = ProtoAccessor;
+        break;
+    default:
+        // QObjects, proxies, indexed and missing properties are not cached.
+        return;
+    }
+
+    if (entry.kind == Proto || entry.kind == ProtoAccessor) {
+        entry.shape = resolved.protoLookup.protoId;
+        entry.data = resolved.protoLookup.data;
+    } else {
+        entry.shape = quintptr(resolved.objectLookup.ic.get());
+        entry.offset = resolved.objectLookup.offset;
+    }
+
+    entries[indexOf(entry.shape, key)] = entry;
+}
+
 QT_END_NAMESPACE
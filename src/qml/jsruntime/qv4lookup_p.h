@@ -66,6 +66,7 @@ struct Q_QML_EXPORT Lookup {
         GetterEnumValue,
         GetterGeneric,
         GetterIndexed,
+        GetterMegamorphic,
         GetterProto,
         GetterProtoAccessor,
         GetterProtoAccessorTwoClasses,
@@ -237,6 +238,7 @@ struct Q_QML_EXPORT Lookup {
     static ReturnedValue getterProtoAccessor(Lookup *lookup, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterProtoAccessorTwoClasses(Lookup *lookup, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterIndexed(Lookup *lookup, ExecutionEngine *engine, const Value &object);
+    static ReturnedValue getterMegamorphic(Lookup *lookup, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterQObject(Lookup *lookup, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterQObjectMethod(Lookup *lookup, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterFallbackMethod(Lookup *lookup, ExecutionEngine *engine, const Value &object);
@@ -353,6 +355,8 @@ struct Q_QML_EXPORT Lookup {
             return getterGeneric(this, engine, object);
         case Call::GetterIndexed:
             return getterIndexed(this, engine, object);
+        case Call::GetterMegamorphic:
+            return getterMegamorphic(this, engine, object);
         case Call::GetterProto:
             return getterProto(this, engine, object);
         case Call::GetterProtoAccessor:
@@ -442,6 +446,55 @@ struct Q_QML_EXPORT Lookup {
 
 Q_STATIC_ASSERT(std::is_standard_layout<Lookup>::value);
 
+// Engine wide stub cache for property reads at lookup sites that have seen more shapes than
+// the two class lookups can hold. Own properties are keyed by internal class, properties
+// found on the prototype chain by protoId. The two never collide, as internal classes are
+// aligned heap pointers and protoIds are always odd. The cache holds no references to the
+// heap and is therefore cleared whenever the GC sweeps.
+struct MegamorphicLookupCache
+{
+    enum Kind : quint8 {
+        Inline,
+        MemberData,
+        Accessor,
+        Proto,
+        ProtoAccessor,
+    };
+
+    struct Entry {
+        quintptr shape;
+        quint64 key;
+        const Value *data;
+        uint offset;
+        Kind kind;
+    };
+
+    enum { SizeLog2 = 10, Size = 1 << SizeLog2 };
+
+    ~MegamorphicLookupCache();
+
+    static uint indexOf(quintptr shape, PropertyKey key)
+    {
+        const quint64 h = (quint64(shape) ^ (key.id() << 7)) * Q_UINT64_C(0x9E3779B97F4A7C15);
+        return uint(h >> (64 - SizeLog2));
+    }
+
+    const Entry *find(quintptr shape, PropertyKey key) const
+    {
+        const Entry &e = entries[indexOf(shape, key)];
+        return (e.shape == shape && e.key == key.id()) ? &e : nullptr;
+    }
+
+    void insert(const Lookup &resolved, PropertyKey key);
+    void clear() { memset(entries, 0, sizeof(entries)); }
+
+    Entry entries[Size] = {};
+
+    quint64 hits = 0;
+    quint64 misses = 0;
+    uint megamorphicSites = 0;
+};
+
 inline void setupQObjectLookup(
         Lookup *lookup, const QQmlData *ddata, const QQmlPropertyData *propertyData)
 {
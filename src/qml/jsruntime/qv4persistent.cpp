@@ -438,7 +438,7 @@ void WeakValue::allocVal(ExecutionEngine *engine)
     val = engine->memoryManager->m_weakValues->allocate();
 }
 
-void WeakValue::markOnce(MarkStack *markStack)
+void WeakValue::markOnce(MarkStack *markStack) const
 {
     if (!val)
         return;
@@ -165,7 +165,7 @@ public:
     bool isNullOrUndefined() const { return !val || val->isNullOrUndefined(); }
     void clear() { free(); }
 
-    void markOnce(MarkStack *markStack);
+    void markOnce(MarkStack *markStack) const;
 
 private:
     Value *val = nullptr;
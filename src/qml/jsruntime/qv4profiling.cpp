@@ -3,6 +3,7 @@
 
 #include "qv4profiling_p.h"
 #include <private/qv4mm_p.h>
+#include <private/qv4stackframe_p.h>
 #include <private/qv4string_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -33,9 +34,17 @@ Profiler::Profiler(QV4::ExecutionEngine *engine) : featuresEnabled(0), m_engine(
     static const int metatypes[] = {
         qRegisterMetaType<QVector<QV4::Profiling::FunctionCallProperties> >(),
         qRegisterMetaType<QVector<QV4::Profiling::MemoryAllocationProperties> >(),
+        qRegisterMetaType<QVector<QV4::Profiling::AllocationSite> >(),
         qRegisterMetaType<FunctionLocationHash>()
     };
     Q_UNUSED(metatypes);
+
+    bool ok = false;
+    const int interval = qEnvironmentVariableIntValue(
+                "QV4_PROFILE_ALLOCATION_SAMPLING_INTERVAL", &ok);
+    m_samplingInterval = ok ? qMax(0, interval) : 64 * 1024;
+    m_bytesUntilSample = m_samplingInterval;
+
     m_timer.start();
 }
 
@@ -46,6 +55,54 @@ void Profiler::stopProfiling()
     m_sentLocations.clear();
 }
 
+void Profiler::sampleAllocation()
+{
+    // Charge all the intervals the last allocation completed to the same site
+    const qint64 samples = 1 - m_bytesUntilSample / m_samplingInterval;
+    m_bytesUntilSample += samples * m_samplingInterval;
+
+    CppStackFrame *frame = m_engine->currentStackFrame;
+    while (frame && !frame->v4Function)
+        frame = frame->parentFrame();
+
+    Function *function = frame ? frame->v4Function : nullptr;
+    const int line = frame ? frame->lineNumber() : -1;
+    SampledSite &site = m_sampledSites[{ reinterpret_cast<quintptr>(function), line }];
+    if (function && !site.function.isValid())
+        site.function.setFunction(function);
+    site.line = line;
+    site.count += samples;
+    site.size += samples * m_samplingInterval;
+}
+
+void Profiler::reportAllocationSites(QVector<AllocationSite> *sites)
+{
+    if (m_sampledSites.isEmpty())
+        return;
+
+    const qint64 timestamp = m_timer.nsecsElapsed();
+    sites->reserve(m_sampledSites.size());
+    for (const SampledSite &site : std::as_const(m_sampledSites)) {
+        FunctionLocation location;
+        if (Function *function = site.function.function()) {
+            location = FunctionLocation(function->name()->toQString(),
+                                        function->executableCompilationUnit()->fileName(),
+                                        site.line, -1);
+            if (location.name.isEmpty())
+                location.name = QStringLiteral("(anonymous function)");
+        } else {
+            location.name = QStringLiteral("(native code)");
+        }
+
+        MemoryAllocationProperties allocation = {
+            timestamp, site.size, SampledAllocation, int(sites->size())
+        };
+        m_memory_data.append(allocation);
+        sites->append({ location, site.count });
+    }
+    m_sampledSites.clear();
+}
+
 bool operator<(const FunctionCall &call1, const FunctionCall &call2)
 {
     return call1.m_start < call2.m_start ||
@@ -73,7 +130,10 @@ void Profiler::reportData()
         }
     }
 
-    emit dataReady(locations, properties, m_memory_data);
+    QVector<AllocationSite> allocationSites;
+    reportAllocationSites(&allocationSites);
+
+    emit dataReady(locations, properties, m_memory_data, allocationSites);
     m_data.clear();
     m_memory_data.clear();
 }
@@ -86,18 +146,19 @@ void Profiler::startProfiling(quint64 features)
             MemoryAllocationProperties heap = {timestamp,
                                                (qint64)m_engine->memoryManager->getAllocatedMem() -
                                                (qint64)m_engine->memoryManager->getLargeItemsMem(),
-                                               HeapPage};
+                                               HeapPage, -1};
             m_memory_data.append(heap);
             MemoryAllocationProperties smallP = {timestamp,
                                                 (qint64)m_engine->memoryManager->getUsedMem(),
-                                                SmallItem};
+                                                SmallItem, -1};
             m_memory_data.append(smallP);
             MemoryAllocationProperties large = {timestamp,
                                                 (qint64)m_engine->memoryManager->getLargeItemsMem(),
-                                                LargeItem};
+                                                LargeItem, -1};
             m_memory_data.append(large);
         }
 
+        m_bytesUntilSample = m_samplingInterval;
         featuresEnabled = features;
     }
 }
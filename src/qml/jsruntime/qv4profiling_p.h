@@ -66,7 +66,8 @@ enum Features {
 enum MemoryType {
     HeapPage,
     LargeItem,
-    SmallItem
+    SmallItem,
+    SampledAllocation
 };
 
 struct FunctionCallProperties {
@@ -98,6 +99,12 @@ struct MemoryAllocationProperties {
     qint64 timestamp;
     qint64 size;
     MemoryType type;
+    int site; // index into the allocation sites reported alongside, for SampledAllocation
+};
+
+struct AllocationSite {
+    FunctionLocation location;
+    qint64 count;
 };
 
 class FunctionCall {
@@ -201,6 +208,9 @@ public:
         bool isValid() const
         { return m_function != nullptr; }
 
+        Function *function() const
+        { return m_function; }
+
     private:
         Function *m_function;
     };
@@ -210,8 +220,13 @@ public:
     bool trackAlloc(size_t size, MemoryType type)
     {
         if (size) {
-            MemoryAllocationProperties allocation = {m_timer.nsecsElapsed(), (qint64)size, type};
+            MemoryAllocationProperties allocation = {m_timer.nsecsElapsed(), (qint64)size, type, -1};
             m_memory_data.append(allocation);
+            if (type != HeapPage && m_samplingInterval > 0) {
+                m_bytesUntilSample -= qint64(size);
+                if (m_bytesUntilSample <= 0)
+                    sampleAllocation();
+            }
             return true;
         } else {
             return false;
@@ -221,7 +236,7 @@ public:
     bool trackDealloc(size_t size, MemoryType type)
     {
         if (size) {
-            MemoryAllocationProperties allocation = {m_timer.nsecsElapsed(), -(qint64)size, type};
+            MemoryAllocationProperties allocation = {m_timer.nsecsElapsed(), -(qint64)size, type, -1};
             m_memory_data.append(allocation);
             return true;
         } else {
@@ -239,15 +254,31 @@ public:
 Q_SIGNALS:
     void dataReady(const QV4::Profiling::FunctionLocationHash &,
                    const QVector<QV4::Profiling::FunctionCallProperties> &,
-                   const QVector<QV4::Profiling::MemoryAllocationProperties> &);
+                   const QVector<QV4::Profiling::MemoryAllocationProperties> &,
+                   const QVector<QV4::Profiling::AllocationSite> &);
 
 private:
+    struct SampledSite {
+        SentMarker function;
+        int line = -1;
+        qint64 count = 0;
+        qint64 size = 0;
+    };
+
+    void sampleAllocation();
+    void reportAllocationSites(QVector<AllocationSite> *sites);
+
     QV4::ExecutionEngine *m_engine;
     QElapsedTimer m_timer;
     QVector<FunctionCall> m_data;
     QVector<MemoryAllocationProperties> m_memory_data;
     QHash<quintptr, SentMarker> m_sentLocations;
 
+    // Every m_samplingInterval bytes allocated, the innermost JS function is charged with them.
+    QHash<std::pair<quintptr, int>, SampledSite> m_sampledSites;
+    qint64 m_samplingInterval = 0;
+    qint64 m_bytesUntilSample = 0;
+
     friend class FunctionCallProfiler;
 };
 
@@ -283,6 +314,7 @@ public:
 } // namespace QV4
 
 Q_DECLARE_TYPEINFO(QV4::Profiling::MemoryAllocationProperties, Q_RELOCATABLE_TYPE);
+Q_DECLARE_TYPEINFO(QV4::Profiling::AllocationSite, Q_RELOCATABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionCallProperties, Q_RELOCATABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionCall, Q_RELOCATABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionLocation, Q_RELOCATABLE_TYPE);
@@ -292,6 +324,7 @@ QT_END_NAMESPACE
 Q_DECLARE_METATYPE(QV4::Profiling::FunctionLocationHash)
 Q_DECLARE_METATYPE(QVector<QV4::Profiling::FunctionCallProperties>)
 Q_DECLARE_METATYPE(QVector<QV4::Profiling::MemoryAllocationProperties>)
+Q_DECLARE_METATYPE(QVector<QV4::Profiling::AllocationSite>)
 
 #endif // QT_CONFIG(qml_debug)
 
@@ -1481,25 +1481,27 @@ void Heap::QObjectWrapper::markObjects(Heap::Base *that, MarkStack *markStack)
             }
 
             if (ddata->hasConstWrapper) {
-                Scope scope(that->internalClass->engine);
-                Q_ASSERT(scope.engine->m_multiplyWrappedQObjects);
+                // Don't use a Scope here. Marking may happen on several threads at once
+                // (see ParallelMarker), and the gc doesn't move or free anything while
+                // marking anyway.
+                ExecutionEngine *engine = that->internalClass->engine;
+                Q_ASSERT(engine->m_multiplyWrappedQObjects);
 
-                Scoped<QV4::QObjectWrapper> constWrapper(
-                        scope,
-                        scope.engine->m_multiplyWrappedQObjects->value(
-                                static_cast<const QObject *>(o)));
+                const Value constWrapperValue = Value::fromReturnedValue(
+                        engine->m_multiplyWrappedQObjects->value(static_cast<const QObject *>(o)));
+                const QV4::QObjectWrapper *constWrapper = constWrapperValue.as<QV4::QObjectWrapper>();
 
                 Q_ASSERT(constWrapper);
 
                 if (This == constWrapper->d()) {
                     // We've got the const wrapper. Also mark the non-const one
-                    if (ddata->jsEngineId == scope.engine->m_engineId)
+                    if (ddata->jsEngineId == engine->m_engineId)
                         ddata->jsWrapper.markOnce(markStack);
                     else
-                        scope.engine->m_multiplyWrappedQObjects->mark(o, markStack);
+                        engine->m_multiplyWrappedQObjects->mark(o, markStack);
                 } else {
                     // We've got the non-const wrapper. Also mark the const one.
-                    constWrapper->mark(markStack);
+                    constWrapper->d()->mark(markStack);
                 }
             }
         }
@@ -478,11 +478,12 @@ public:
         erase(it);
     }
 
+    // Called from parallel marker threads. Must not detach.
     template<typename Pointer>
-    void mark(Pointer key, MarkStack *markStack)
+    void mark(Pointer key, MarkStack *markStack) const
     {
-        Iterator it = find(key);
-        if (it == end())
+        ConstIterator it = constFind(key);
+        if (it == constEnd())
             return;
         it->markOnce(markStack);
     }
@@ -5,13 +5,14 @@
 #include "qv4engine_p.h"
 #include "qv4scopedvalue_p.h"
 #include <private/qv4mm_p.h>
+#include <private/qv4writebarrier_p.h>
 #include <runtime/VM.h>
 
+#include <QtCore/qloggingcategory.h>
+
 using namespace QV4;
 
-#if ENABLE(YARR_JIT)
-static constexpr quint8 RegexpJitThreshold = 5;
-#endif
+Q_STATIC_LOGGING_CATEGORY(lcRegExpStats, "qt.qml.regexp.statistics")
 
 static JSC::RegExpFlags jscFlags(uint flags)
 {
@@ -35,6 +36,59 @@ RegExpCache::~RegExpCache()
         if (RegExp *re = it.value().as<RegExp>())
             re->d()->cache = nullptr;
     }
+
+    if (!hits && !misses)
+        return;
+    qCDebug(lcRegExpStats) << "Cache hits:" << hits
+                           << "misses:" << misses
+                           << "evictions:" << evictions
+                           << "JIT compilations:" << jitCompilations
+                           << "peak JIT code bytes:" << peakJitCodeBytes;
+}
+
+void RegExpCache::markUsed(Heap::RegExp *regExp)
+{
+    const qsizetype limit = ExecutionEngine::regExpCacheSize();
+    if (limit == 0)
+        return;
+
+    // The list is marked as a root only at the start of an incremental gc run. Mark the
+    // expression here, so that one created or revived while the gc is ongoing isn't swept.
+    WriteBarrier::markCustom(regExp->internalClass->engine, [regExp](MarkStack *ms) {
+        regExp->mark(ms);
+    });
+
+    for (qsizetype i = recentlyUsed.size() - 1; i >= 0; --i) {
+        if (recentlyUsed.at(i) != regExp)
+            continue;
+        if (i != recentlyUsed.size() - 1) {
+            recentlyUsed.remove(i);
+            recentlyUsed.append(regExp);
+        }
+        return;
+    }
+
+    if (recentlyUsed.size() >= limit) {
+        recentlyUsed.remove(0);
+        ++evictions;
+    }
+    recentlyUsed.append(regExp);
+}
+
+void RegExpCache::forget(Heap::RegExp *regExp)
+{
+    for (qsizetype i = 0, end = recentlyUsed.size(); i < end; ++i) {
+        if (recentlyUsed.at(i) == regExp) {
+            recentlyUsed.remove(i);
+            return;
+        }
+    }
+}
+
+void RegExpCache::markObjects(MarkStack *markStack) const
+{
+    for (Heap::RegExp *regExp : recentlyUsed)
+        regExp->mark(markStack);
 }
 
 DEFINE_MANAGED_VTABLE(RegExp);
@@ -61,6 +115,8 @@ uint RegExp::match(const QString &string, int start, uint *matchOffsets)
     };
 
     auto removeJitCode = [](Heap::RegExp *regexp) {
+        if (regexp->cache)
+            regexp->cache->jitCodeBytes -= regexp->jitCode->size();
         delete regexp->jitCode;
         regexp->jitCode = nullptr;
         regexp->jitFailed = true;
@@ -71,8 +127,21 @@ uint RegExp::match(const QString &string, int start, uint *matchOffsets)
         regexp->byteCode = nullptr;
     };
 
-    if (!priv->jitCode && !priv->jitFailed && priv->internalClass->engine->canJIT()
-            && (string.length() > 1024 || priv->matchCount++ == RegexpJitThreshold)) {
+    // Interpret the byte code first. Only regular expressions that are used repeatedly, or on
+    // long strings, are worth the time and memory the JIT needs.
+    const auto isHot = [&]() {
+        // QV4_FORCE_INTERPRETER
+        if (ExecutionEngine::regExpJitThreshold() == std::numeric_limits<int>::max())
+            return false;
+        if (string.size() > ExecutionEngine::regExpJitStringLength()
+                || priv->matchCount >= ExecutionEngine::regExpJitThreshold()) {
+            return true;
+        }
+        ++priv->matchCount;
+        return false;
+    };
+
+    if (!priv->jitCode && !priv->jitFailed && priv->internalClass->engine->canJIT() && isHot()) {
         removeByteCode(priv);
 
         JSC::Yarr::ErrorCode error = JSC::Yarr::ErrorCode::NoError;
@@ -82,6 +151,11 @@ uint RegExp::match(const QString &string, int start, uint *matchOffsets)
             priv->jitCode = new JSC::Yarr::YarrCodeBlock;
             JSC::VM *vm = static_cast<JSC::VM *>(priv->internalClass->engine);
             JSC::Yarr::jitCompile(yarrPattern, JSC::Yarr::Char16, vm, *priv->jitCode);
+            if (RegExpCache *cache = priv->cache) {
+                ++cache->jitCompilations;
+                cache->jitCodeBytes += priv->jitCode->size();
+                cache->peakJitCodeBytes = std::max(cache->peakJitCodeBytes, cache->jitCodeBytes);
+            }
         }
 
         if (!priv->hasValidJITCode()) {
@@ -197,14 +271,19 @@ Heap::RegExp *RegExp::create(ExecutionEngine* engine, const QString& pattern, ui
         cache = engine->regExpCache = new RegExpCache;
 
     QV4::WeakValue &cachedValue = (*cache)[key];
-    if (QV4::RegExp *result = cachedValue.as<RegExp>())
+    if (QV4::RegExp *result = cachedValue.as<RegExp>()) {
+        ++cache->hits;
+        cache->markUsed(result->d());
         return result->d();
+    }
 
+    ++cache->misses;
     Scope scope(engine);
     Scoped<RegExp> result(scope, engine->memoryManager->alloc<RegExp>(engine, pattern, flags));
 
     result->d()->cache = cache;
     cachedValue.set(engine, result);
+    cache->markUsed(result->d());
 
     return result->d();
 }
@@ -235,8 +314,11 @@ void Heap::RegExp::destroy()
     if (cache) {
         RegExpCacheKey key(this);
         cache->remove(key);
+        cache->forget(this);
     }
 #if ENABLE(YARR_JIT)
+    if (cache && jitCode)
+        cache->jitCodeBytes -= jitCode->size();
     delete jitCode;
 #endif
     delete byteCode;
@@ -15,6 +15,7 @@
 //
 
 #include <QString>
+#include <QVarLengthArray>
 #include <QVector>
 
 #include <wtf/RefPtr.h>
@@ -67,7 +68,7 @@ struct RegExp : Base {
     uint flags;
     bool valid;
     bool jitFailed;
-    quint8 matchCount;
+    int matchCount;
 
     QString flagsAsString() const;
     int captureCount() const { return subPatternCount + 1; }
@@ -137,6 +138,23 @@ class RegExpCache : public QHash<RegExpCacheKey, WeakValue>
 {
 public:
     ~RegExpCache();
+
+    // The most recently used regular expressions are kept alive even if nothing else references
+    // them. This way patterns that are created over and over, for example by "new RegExp(str)",
+    // are not compiled again after each garbage collection.
+    void markUsed(Heap::RegExp *regExp);
+    void forget(Heap::RegExp *regExp);
+    void markObjects(MarkStack *markStack) const;
+
+    quint64 hits = 0;
+    quint64 misses = 0;
+    quint64 evictions = 0;
+    quint64 jitCompilations = 0;
+    quint64 jitCodeBytes = 0;     // currently held by JIT-compiled regular expressions
+    quint64 peakJitCodeBytes = 0;
+
+private:
+    QVarLengthArray<Heap::RegExp *, 16> recentlyUsed; // least recently used first
 };
 
 
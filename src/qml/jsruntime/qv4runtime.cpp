@@ -672,6 +672,8 @@ QV4::ReturnedValue RuntimeHelpers::addHelper(ExecutionEngine *engine, const Valu
             return sright->asReturnedValue();
         if (!sright->d()->length())
             return sleft->asReturnedValue();
+        if (Heap::String *appended = sleft->d()->appendInPlace(sright->d()))
+            return appended->asReturnedValue();
         MemoryManager *mm = engine->memoryManager;
         return (mm->alloc<ComplexString>(sleft->d(), sright->d()))->asReturnedValue();
     }
@@ -1708,6 +1710,11 @@ void Runtime::ThrowException::call(ExecutionEngine *engine, const Value &value)
         engine->throwError(value);
 }
 
+void Runtime::CheckExecutionBudget::call(ExecutionEngine *engine)
+{
+    engine->checkExecutionBudget();
+}
+
 ReturnedValue Runtime::TypeofValue::call(ExecutionEngine *engine, const Value &value)
 {
     Scope scope(engine);
@@ -2072,7 +2079,7 @@ QV4::ReturnedValue Runtime::CreateRestParameter::call(ExecutionEngine *engine, i
 ReturnedValue Runtime::RegexpLiteral::call(ExecutionEngine *engine, int id)
 {
     const auto val
-            = engine->currentStackFrame->v4Function->compilationUnit->runtimeRegularExpressions[id];
+            = engine->currentStackFrame->v4Function->executableCompilationUnit()->regExpAt(id);
     Heap::RegExpObject *ro = engine->newRegExpObject(Value::fromStaticValue(val).as<RegExp>());
     return ro->asReturnedValue();
 }
@@ -2524,6 +2531,7 @@ QHash<const void *, const char *> Runtime::symbolTable()
             {symbol<PopScriptContext>(), "PopScriptContext" },
             {symbol<ThrowReferenceError>(), "ThrowReferenceError" },
             {symbol<ThrowOnNullOrUndefined>(), "ThrowOnNullOrUndefined" },
+            {symbol<CheckExecutionBudget>(), "CheckExecutionBudget" },
 
             {symbol<Closure>(), "Closure" },
 
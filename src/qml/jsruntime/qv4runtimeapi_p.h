@@ -229,6 +229,10 @@ struct Q_QML_EXPORT Runtime {
     {
         static void call(ExecutionEngine *, const Value &);
     };
+    struct Q_QML_EXPORT CheckExecutionBudget : Method<Throws::Yes>
+    {
+        static void call(ExecutionEngine *);
+    };
 
     /* garbage collection */
     struct Q_QML_EXPORT MarkCustom : PureMethod
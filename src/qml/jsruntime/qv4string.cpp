@@ -7,10 +7,15 @@
 #include "qv4runtime_p.h"
 #include <QtQml/private/qv4mm_p.h>
 #include <QtCore/QHash>
+#include <QtCore/qloggingcategory.h>
 #include <QtCore/private/qnumeric_p.h>
 
+#include <limits>
+
 using namespace QV4;
 
+Q_STATIC_LOGGING_CATEGORY(lcStringStats, "qt.qml.string.statistics")
+
 void Heap::StringOrSymbol::markObjects(Heap::Base *that, MarkStack *markStack)
 {
     StringOrSymbol *s = static_cast<StringOrSymbol *>(that);
@@ -57,12 +62,21 @@ void Heap::String::init(const QString &t)
     QString mutableText(t);
     StringOrSymbol::init(mutableText.data_ptr());
     subtype = String::StringType_Unknown;
+    isAppendable = false;
+}
+
+void Heap::ComplexString::init(const QString &text)
+{
+    String::init(text);
+    left = right = nullptr;
+    len = 0;
 }
 
 void Heap::ComplexString::init(String *l, String *r)
 {
     StringOrSymbol::init();
     subtype = String::StringType_AddedString;
+    isAppendable = false;
 
     left = l;
     right = r;
@@ -87,6 +101,7 @@ void Heap::ComplexString::init(Heap::String *ref, int from, int len)
     StringOrSymbol::init();
 
     subtype = String::StringType_SubString;
+    isAppendable = false;
 
     left = ref;
     this->from = from;
@@ -142,9 +157,88 @@ void Heap::String::simplifyString() const
     identifier = PropertyKey::invalid();
     cs->left = cs->right = nullptr;
 
-    internalClass->engine->memoryManager->changeUnmanagedHeapSizeUsage(
+    ExecutionEngine *engine = internalClass->engine;
+    engine->memoryManager->changeUnmanagedHeapSizeUsage(
                 qptrdiff(text().size) * qptrdiff(sizeof(QChar)));
+
+    // A concatenation that has to be flattened is likely to be appended to
+    // again, typically in a loop. Let the next append grow it in place.
+    isAppendable = (subtype == StringType_AddedString);
     subtype = StringType_Unknown;
+
+    ++engine->stringStatistics.flattenedStrings;
+    engine->stringStatistics.flattenedCharacters += l;
+}
+
+/*!
+    \internal
+
+    Appends \a right to this string and returns the result as a new flat
+    string, or \nullptr if this string is not appendable.
+
+    If nothing but this string holds the text buffer and it has enough
+    capacity left, only the characters of \a right are copied. The new
+    string then takes over the buffer, and this string becomes a substring of
+    it. A buffer that is shared, for example with a QString returned by
+    toQString(), is never written to, as the QString relies on the terminator
+    after its last character. In that case, or if the buffer is full, the text
+    is copied to a new buffer with twice the required capacity. Either way,
+    the new string takes over the right to append.
+*/
+Heap::String *Heap::String::appendInPlace(const String *right)
+{
+    if (!isAppendable || subtype >= StringType_AddedString)
+        return nullptr;
+
+    const qsizetype leftLength = text().size;
+    const qsizetype newLength = leftLength + right->length();
+    if (newLength > std::numeric_limits<int>::max() / 2)
+        return nullptr;
+
+    ExecutionEngine *engine = internalClass->engine;
+    MemoryManager *mm = engine->memoryManager;
+    QStringPrivate &buffer = text();
+
+    // Strings used as property keys have to keep their text.
+    const bool inPlace = !buffer.needsDetach() && !identifier.isValid()
+            && buffer.freeSpaceAtEnd() >= right->length();
+
+    QString result;
+    if (inPlace) {
+        append(right, reinterpret_cast<QChar *>(buffer.data() + leftLength));
+        buffer.data()[newLength] = u'\0';
+        QStringPrivate shared = buffer;
+        shared.size = newLength;
+        result = QString(std::move(shared));
+        ++engine->stringStatistics.inPlaceAppends;
+    } else {
+        result.reserve(2 * newLength);
+        result.resize(newLength);
+        QChar *ch = result.data();
+        memcpy(static_cast<void *>(ch), buffer.data(), leftLength * sizeof(QChar));
+        append(right, ch + leftLength);
+        ++engine->stringStatistics.reallocatingAppends;
+    }
+
+    isAppendable = false;
+    Heap::ComplexString *appended = mm->alloc<QV4::ComplexString>(result);
+    mm->changeUnmanagedHeapSizeUsage(qptrdiff(newLength) * qptrdiff(sizeof(QChar)));
+    appended->isAppendable = true;
+
+    if (inPlace) {
+        // Hand the buffer over, so that the next append finds it unshared again.
+        mm->changeUnmanagedHeapSizeUsage(-qptrdiff(leftLength) * qptrdiff(sizeof(QChar)));
+        buffer = QStringPrivate();
+        ComplexString *cs = static_cast<ComplexString *>(this);
+        cs->subtype = StringType_SubString;
+        cs->left = appended;
+        cs->from = 0;
+        cs->len = int(leftLength);
+        WriteBarrier::markCustom(engine, [appended](MarkStack *ms) {
+            appended->mark(ms);
+        });
+    }
+    return appended;
 }
 
 bool Heap::String::startsWithUpper() const
@@ -224,3 +318,13 @@ qint64 String::virtualGetLength(const Managed *m)
 {
     return static_cast<const String *>(m)->d()->length();
 }
+
+StringStatistics::~StringStatistics()
+{
+    if (!flattenedStrings && !inPlaceAppends && !reallocatingAppends)
+        return;
+    qCDebug(lcStringStats) << "Flattened strings:" << flattenedStrings
+                           << "characters:" << flattenedCharacters
+                           << "in-place appends:" << inPlaceAppends
+                           << "reallocating appends:" << reallocatingAppends;
+}
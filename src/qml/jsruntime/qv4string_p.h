@@ -85,6 +85,7 @@ struct Q_QML_EXPORT String : StringOrSymbol {
 
     void init(const QString &text);
     void simplifyString() const;
+    String *appendInPlace(const String *right);
     int length() const;
     std::size_t retainedTextSize() const {
         return subtype >= StringType_Complex ? 0 : (std::size_t(text().size) * sizeof(QChar));
@@ -110,12 +111,20 @@ struct Q_QML_EXPORT String : StringOrSymbol {
 
     bool startsWithUpper() const;
 
+    // Set on flat strings that were built by concatenation and own the
+    // unused capacity at the end of their text. Repeated "s += x" can then
+    // write into that capacity rather than creating and flattening ropes.
+    // Only one string per buffer may have this set, and it has to be a
+    // ComplexString, as it becomes a substring when appended to in place.
+    mutable bool isAppendable;
+
 private:
     static void append(const String *data, QChar *ch);
 };
 Q_STATIC_ASSERT(std::is_trivial_v<String>);
 
 struct ComplexString : String {
+    void init(const QString &text);
     void init(String *l, String *n);
     void init(String *ref, int from, int len);
     mutable String *left;
@@ -136,6 +145,18 @@ int String::length() const {
 
 }
 
+// Counts how often ropes are flattened and how often strings grow in place.
+// Logged through qt.qml.string.statistics when the engine is destroyed.
+struct StringStatistics
+{
+    ~StringStatistics();
+
+    quint64 flattenedStrings = 0;
+    quint64 flattenedCharacters = 0;
+    quint64 inPlaceAppends = 0;
+    quint64 reallocatingAppends = 0;
+};
+
 struct Q_QML_EXPORT StringOrSymbol : public Managed {
     V4_MANAGED(StringOrSymbol, Managed)
     V4_NEEDS_DESTROY
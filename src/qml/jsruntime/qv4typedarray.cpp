@@ -286,7 +286,7 @@ ReturnedValue TypedArrayCtor::virtualCallAsConstructor(const FunctionObject *f,
     Scoped<TypedArray> typedArray(scope, argc ? argv[0] : Value::undefinedValue());
     if (!!typedArray) {
         // ECMA 6 22.2.1.2
-        Scoped<ArrayBuffer> buffer(scope, typedArray->d()->buffer);
+        Scoped<SharedArrayBuffer> buffer(scope, typedArray->d()->buffer);
         if (!buffer || buffer->hasDetachedArrayData())
             return scope.engine->throwTypeError();
         uint srcElementSize = typedArray->bytesPerElement();
@@ -324,7 +324,7 @@ ReturnedValue TypedArrayCtor::virtualCallAsConstructor(const FunctionObject *f,
         updateProto(scope, array);
         return array.asReturnedValue();
     }
-    Scoped<ArrayBuffer> buffer(scope, argc ? argv[0] : Value::undefinedValue());
+    Scoped<SharedArrayBuffer> buffer(scope, argc ? argv[0] : Value::undefinedValue());
     if (!!buffer) {
         // ECMA 6 22.2.1.4
 
@@ -1360,7 +1360,7 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_set(const FunctionObject *b,
     Scoped<TypedArray> a(scope, *thisObject);
     if (!a)
         return scope.engine->throwTypeError();
-    Scoped<ArrayBuffer> buffer(scope, a->d()->buffer);
+    Scoped<SharedArrayBuffer> buffer(scope, a->d()->buffer);
 
     double doffset = argc >= 2 ? argv[1].toInteger() : 0;
     if (scope.hasException())
@@ -1411,7 +1411,7 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_set(const FunctionObject *b,
     }
 
     // src is a typed array
-    Scoped<ArrayBuffer> srcBuffer(scope, srcTypedArray->d()->buffer);
+    Scoped<SharedArrayBuffer> srcBuffer(scope, srcTypedArray->d()->buffer);
     if (!srcBuffer || srcBuffer->hasDetachedArrayData())
         return scope.engine->throwTypeError();
 
@@ -1508,7 +1508,7 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_subarray(const FunctionObject
     if (!a)
         return scope.engine->throwTypeError();
 
-    Scoped<ArrayBuffer> buffer(scope, a->d()->buffer);
+    Scoped<SharedArrayBuffer> buffer(scope, a->d()->buffer);
     Q_ASSERT(buffer);
 
     int len = a->length();
@@ -73,7 +73,7 @@ struct TypedArrayOperations {
 namespace Heap {
 
 #define TypedArrayMembers(class, Member) \
-    Member(class, Pointer, ArrayBuffer *, buffer) \
+    Member(class, Pointer, SharedArrayBuffer *, buffer) \
     Member(class, NoMark, const TypedArrayOperations *, type) \
     Member(class, NoMark, uint, byteLength) \
     Member(class, NoMark, uint, byteOffset) \
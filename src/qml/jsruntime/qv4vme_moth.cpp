@@ -377,6 +377,39 @@ static bool compareEqualInt(QV4::Value &accumulator, QV4::Value lhs, int rhs)
 #define STORE_IP() frame->instructionPointer = int(code - function->codeData);
 #define STORE_ACC() accumulator = acc;
 #define ACC Value::fromReturnedValue(acc)
+
+#if QT_CONFIG(qml_jit)
+static Function::JittedCode jittedLoopEntry(JSTypesStackFrame *frame, ExecutionEngine *engine)
+{
+    Function *function = frame->v4Function;
+
+    // Don't try again on every iteration if we cannot enter the jitted code.
+    function->interpreterLoopIterationCount = 0;
+
+    // Exception handlers and pending unwinds only exist in the interpreter's view of the frame.
+    if (frame->unwindHandler || frame->unwindLevel || engine->debugger())
+        return nullptr;
+
+    if (function->codeRef == nullptr)
+        QV4::JIT::BaselineJIT(function).generate();
+    return function->jittedLoopEntry;
+}
+
+// Called after a backward jump has been taken. Hot loops continue in jitted code, which takes
+// over the frame and runs the rest of the function.
+#define MOTH_LOOP_BACK_EDGE() \
+    if (offset < 0) { \
+        if (Q_UNLIKELY(engine->countLoopIteration(function))) { \
+            if (Function::JittedCode loopEntry = jittedLoopEntry(frame, engine)) { \
+                STORE_IP(); \
+                STORE_ACC(); \
+                return loopEntry(frame, engine); \
+            } \
+        } \
+    }
+#else
+#define MOTH_LOOP_BACK_EDGE()
+#endif // QT_CONFIG(qml_jit)
 #define VALUE_TO_INT(i, val) \
     int i; \
     do { \
@@ -395,6 +428,30 @@ static bool compareEqualInt(QV4::Value &accumulator, QV4::Value lhs, int rhs)
         } \
     } while (false)
 
+// The execution budget covers the outermost call into JavaScript, and everything it calls.
+struct ExecutionBudgetScope
+{
+    ExecutionBudgetScope(const CppStackFrame *frame, ExecutionEngine *engine)
+        : engine(engine)
+        , outermost(Q_UNLIKELY(engine->executionBudget() > 0) && !frame->parentFrame())
+    {
+        if (outermost)
+            engine->startExecutionBudget();
+        else if (Q_UNLIKELY(--engine->executionBudgetCountdown <= 0))
+            engine->checkExecutionBudget();
+    }
+
+    ~ExecutionBudgetScope()
+    {
+        if (outermost)
+            engine->finishExecutionBudget();
+    }
+
+private:
+    ExecutionEngine *engine;
+    bool outermost;
+};
+
 struct AOTCompiledMetaMethod
 {
 public:
@@ -418,6 +475,7 @@ void VME::exec(MetaTypesStackFrame *frame, ExecutionEngine *engine)
         return;
     }
     ExecutionEngineCallDepthRecorder executionEngineCallDepthRecorder(engine);
+    ExecutionBudgetScope executionBudgetScope(frame, engine);
 
     Function *function = frame->v4Function;
     Q_ASSERT(function->aotCompiledCode);
@@ -451,6 +509,7 @@ ReturnedValue VME::exec(JSTypesStackFrame *frame, ExecutionEngine *engine)
 {
     qt_v4ResolvePendingBreakpointsHook();
     CHECK_STACK_LIMITS(engine);
+    ExecutionBudgetScope executionBudgetScope(frame, engine);
 
     Function *function = frame->v4Function;
     Q_TRACE_SCOPE(QQmlV4_function_call, engine, function->name()->toQString(),
@@ -470,6 +529,10 @@ ReturnedValue VME::exec(JSTypesStackFrame *frame, ExecutionEngine *engine)
                 QV4::JIT::BaselineJIT(function).generate();
             else
                 ++function->interpreterCallCount;
+        } else if (function->jittedCallCount < engine->jitOptimizeCallCountThreshold()) {
+            ++function->jittedCallCount;
+        } else if (engine->canOptimize(function)) {
+            QV4::JIT::BaselineJIT(function, QV4::JIT::BaselineJIT::Tier::Optimized).generate();
         }
     }
 #endif // QT_CONFIG(qml_jit)
@@ -1047,6 +1110,7 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
 
     MOTH_BEGIN_INSTR(Jump)
         code += offset;
+        MOTH_LOOP_BACK_EDGE();
     MOTH_END_INSTR(Jump)
 
     MOTH_BEGIN_INSTR(JumpTrue)
@@ -1055,8 +1119,10 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
             takeJump = ACC.int_32();
         else
             takeJump = ACC.toBoolean();
-        if (takeJump)
+        if (takeJump) {
             code += offset;
+            MOTH_LOOP_BACK_EDGE();
+        }
     MOTH_END_INSTR(JumpTrue)
 
     MOTH_BEGIN_INSTR(JumpFalse)
@@ -1065,8 +1131,10 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
             takeJump = !ACC.int_32();
         else
             takeJump = !ACC.toBoolean();
-        if (takeJump)
+        if (takeJump) {
             code += offset;
+            MOTH_LOOP_BACK_EDGE();
+        }
     MOTH_END_INSTR(JumpFalse)
 
     MOTH_BEGIN_INSTR(JumpNoException)
@@ -1081,6 +1149,13 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
 
     MOTH_BEGIN_INSTR(CheckException)
         CHECK_EXCEPTION;
+        // The code generator emits this once per loop iteration.
+        if (Q_UNLIKELY(--engine->executionBudgetCountdown <= 0)) {
+            STORE_IP();
+            STORE_ACC();
+            engine->checkExecutionBudget();
+            CHECK_EXCEPTION;
+        }
     MOTH_END_INSTR(CheckException)
 
     MOTH_BEGIN_INSTR(CmpEqNull)
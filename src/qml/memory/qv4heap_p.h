@@ -144,6 +144,14 @@ void Base::mark(QV4::MarkStack *markStack)
     Q_ASSERT(!Chunk::testBit(c->extendsBitmap, index));
     quintptr *bitmap = c->blackBitmap + Chunk::bitmapIndex(index);
     quintptr bit = Chunk::bitForIndex(index);
+    if (Q_UNLIKELY(markStack->isSpecial())) {
+        if (!markStack->isParallel()) {
+            markStack->markSpecial(this);
+        } else if (!Chunk::testAndSetBitAtomic(bitmap, bit)) {
+            markStack->push(this);
+        }
+        return;
+    }
     if (!(*bitmap & bit)) {
         *bitmap |= bit;
         markStack->push(this);
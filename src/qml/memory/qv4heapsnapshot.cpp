@@ -0,0 +1,462 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <private/qv4mm_p.h>
+#include <private/qv4engine_p.h>
+#include <private/qv4functionobject_p.h>
+#include <private/qv4function_p.h>
+#include <private/qv4qobjectwrapper_p.h>
+#include <private/qqmldata_p.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qscopedvaluerollback.h>
+
+#include <iterator>
+#include <limits>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+Q_STATIC_LOGGING_CATEGORY(lcGcStats, "qt.qml.gc.statistics")
+
+namespace QV4 {
+
+/*
+ * Builds the object graph of the JS heap by running the markObjects() of all reachable items
+ * with a MarkStack that records the items it is handed as edges of the item currently being
+ * expanded, instead of marking them. Nodes are expanded in the order they are discovered, so
+ * the edges of each node end up next to each other.
+ */
+struct HeapSnapshotBuilder
+{
+    enum SyntheticNode {
+        Roots,
+        EngineRoots,
+        JSStackRoots,
+        PersistentRoots,
+        QObjectRoots,
+        NSyntheticNodes
+    };
+
+    std::vector<Heap::Base *> items; // nullptr for the synthetic nodes
+    std::vector<uint> firstEdge;
+    std::vector<uint> edges;
+    QHash<Heap::Base *, uint> indices;
+    uint current = 0;
+
+    HeapSnapshotBuilder() : items(NSyntheticNodes, nullptr) {}
+
+    uint nodeCount() const { return uint(items.size()); }
+
+    void beginNode(uint node)
+    {
+        Q_ASSERT(node == firstEdge.size());
+        current = node;
+        firstEdge.push_back(uint(edges.size()));
+    }
+
+    void addEdge(Heap::Base *item)
+    {
+        auto it = indices.find(item);
+        if (it == indices.end()) {
+            it = indices.insert(item, nodeCount());
+            items.push_back(item);
+        } else if (*it == current) {
+            return;
+        }
+        edges.push_back(*it);
+    }
+};
+
+MarkStack::MarkStack(ExecutionEngine *engine, HeapSnapshotBuilder *snapshot)
+    : m_engine(engine)
+    , m_snapshot(snapshot)
+    , m_special(true)
+{
+}
+
+void MarkStack::markSpecial(Heap::Base *m)
+{
+    Q_ASSERT(m_snapshot);
+    m_snapshot->addEdge(m);
+}
+
+namespace {
+
+// Writes the snapshot in the .heapsnapshot format understood by Chrome's DevTools, with an
+// additional retained_size field per node.
+class SnapshotWriter
+{
+public:
+    SnapshotWriter(QIODevice *device) : device(device) { buffer.reserve(BufferSize); }
+
+    void write(const char *data) { buffer.append(data); flushIfFull(); }
+    void write(const QByteArray &data) { buffer.append(data); flushIfFull(); }
+    void write(quint64 number) { buffer.append(QByteArray::number(number)); flushIfFull(); }
+
+    void writeString(const QString &string)
+    {
+        buffer.append('"');
+        for (QChar c : string) {
+            const ushort u = c.unicode();
+            if (u == '"' || u == '\\') {
+                buffer.append('\\');
+                buffer.append(char(u));
+            } else if (u < 0x20 || u >= 0x7f) {
+                buffer.append("\\u");
+                buffer.append(QByteArray::number(u, 16).rightJustified(4, '0'));
+            } else {
+                buffer.append(char(u));
+            }
+        }
+        buffer.append('"');
+        flushIfFull();
+    }
+
+    bool finish()
+    {
+        flush();
+        return ok;
+    }
+
+private:
+    enum { BufferSize = 64 * 1024 };
+
+    void flushIfFull()
+    {
+        if (buffer.size() >= BufferSize)
+            flush();
+    }
+
+    void flush()
+    {
+        if (ok && device->write(buffer) != buffer.size())
+            ok = false;
+        buffer.clear();
+    }
+
+    QIODevice *device;
+    QByteArray buffer;
+    bool ok = true;
+};
+
+// Node and edge types as listed in the meta data we write
+enum NodeType { Hidden, Array, String, Object, Code, Closure, RegExp, Number, Native, Synthetic,
+                ConcatenatedString };
+enum { ElementEdge = 1 };
+enum { NodeFieldCount = 6 };
+
+NodeType nodeType(const Heap::Base *item)
+{
+    const VTable *vtable = item->internalClass->vtable;
+    if (vtable->isString) {
+        return static_cast<const Heap::String *>(item)->subtype >= Heap::String::StringType_Complex
+                ? ConcatenatedString
+                : String;
+    }
+    switch (vtable->type) {
+    case Managed::Type_ArrayObject:
+        return Array;
+    case Managed::Type_FunctionObject:
+        return Closure;
+    case Managed::Type_RegExpObject:
+    case Managed::Type_RegExp:
+        return RegExp;
+    case Managed::Type_NumberObject:
+        return Number;
+    case Managed::Type_InternalClass:
+    case Managed::Type_ExecutionContext:
+        return Hidden;
+    default:
+        break;
+    }
+    return vtable->isObject ? Object : Native;
+}
+
+QString nodeName(Heap::Base *item, NodeType type)
+{
+    enum { MaxStringLength = 100 };
+    const Value value = Value::fromHeapObject(item);
+    switch (type) {
+    case String:
+        return static_cast<Heap::String *>(item)->toQString().left(MaxStringLength);
+    case Closure:
+        if (const JavaScriptFunctionObject *f = value.as<JavaScriptFunctionObject>()) {
+            if (Function *function = f->d()->function)
+                return function->name()->toQString();
+        }
+        break;
+    default:
+        if (const QObjectWrapper *wrapper = value.as<QObjectWrapper>()) {
+            if (QObject *object = wrapper->object()) {
+                return QString::fromLatin1(item->internalClass->vtable->className) + u' '
+                        + QString::fromLatin1(object->metaObject()->className());
+            }
+        }
+        break;
+    }
+    return QString::fromLatin1(item->internalClass->vtable->className);
+}
+
+size_t itemSize(const Heap::Base *item, const QHash<const Chunk *, size_t> &hugeItems)
+{
+    const HeapItem *h = reinterpret_cast<const HeapItem *>(item);
+    Chunk *c = h->chunk();
+    if (h == c->first()) {
+        const auto it = hugeItems.constFind(c);
+        if (it != hugeItems.constEnd())
+            return *it;
+    }
+    return h->size();
+}
+
+// Computes the immediate dominators of all nodes with the algorithm by Cooper, Harvey and
+// Kennedy, "A Simple, Fast Dominance Algorithm". All nodes are reachable from node 0.
+std::vector<uint> dominators(const HeapSnapshotBuilder &graph, std::vector<uint> *postOrder)
+{
+    const uint nodeCount = graph.nodeCount();
+    auto edgesEnd = [&](uint node) {
+        return node + 1 < nodeCount ? graph.firstEdge[node + 1] : uint(graph.edges.size());
+    };
+
+    // Depth first post order numbering, iteratively to not overflow the C++ stack
+    std::vector<uint> order(nodeCount, std::numeric_limits<uint>::max());
+    postOrder->reserve(nodeCount);
+    std::vector<std::pair<uint, uint>> stack; // node, next edge
+    std::vector<bool> visited(nodeCount, false);
+    stack.emplace_back(0, graph.firstEdge[0]);
+    visited[0] = true;
+    while (!stack.empty()) {
+        auto &top = stack.back();
+        if (top.second < edgesEnd(top.first)) {
+            const uint child = graph.edges[top.second++];
+            if (!visited[child]) {
+                visited[child] = true;
+                stack.emplace_back(child, graph.firstEdge[child]);
+            }
+        } else {
+            order[top.first] = uint(postOrder->size());
+            postOrder->push_back(top.first);
+            stack.pop_back();
+        }
+    }
+
+    // Reverse edges, in compressed form
+    std::vector<uint> firstPredecessor(nodeCount + 1, 0);
+    for (uint target : graph.edges)
+        ++firstPredecessor[target + 1];
+    for (uint i = 0; i < nodeCount; ++i)
+        firstPredecessor[i + 1] += firstPredecessor[i];
+    std::vector<uint> predecessors(graph.edges.size());
+    {
+        std::vector<uint> fill(firstPredecessor.begin(), firstPredecessor.end() - 1);
+        for (uint node = 0; node < nodeCount; ++node) {
+            for (uint e = graph.firstEdge[node]; e < edgesEnd(node); ++e)
+                predecessors[fill[graph.edges[e]]++] = node;
+        }
+    }
+
+    constexpr uint Undefined = std::numeric_limits<uint>::max();
+    std::vector<uint> idom(nodeCount, Undefined);
+    idom[0] = 0;
+    auto intersect = [&](uint a, uint b) {
+        while (a != b) {
+            while (order[a] < order[b])
+                a = idom[a];
+            while (order[b] < order[a])
+                b = idom[b];
+        }
+        return a;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        // reverse post order, skipping the root
+        for (auto it = postOrder->rbegin() + 1; it != postOrder->rend(); ++it) {
+            const uint node = *it;
+            uint newIdom = Undefined;
+            for (uint p = firstPredecessor[node]; p < firstPredecessor[node + 1]; ++p) {
+                const uint pred = predecessors[p];
+                if (idom[pred] == Undefined)
+                    continue;
+                newIdom = newIdom == Undefined ? pred : intersect(pred, newIdom);
+            }
+            if (idom[node] != newIdom) {
+                idom[node] = newIdom;
+                changed = true;
+            }
+        }
+    }
+    return idom;
+}
+
+} // anonymous namespace
+
+/*!
+    \internal
+    Writes a snapshot of all JS heap items reachable from the gc roots to \a device. For each
+    item, the snapshot lists its type, its size, the size of the items only it keeps alive
+    (its retained size), and the items it references. The roots are grouped by where they come
+    from. Items are identified by their address, so the same item has the same id in
+    subsequent snapshots of the same engine.
+
+    The snapshot uses the .heapsnapshot format of Chrome's DevTools, with an additional
+    retained_size node field. Memory allocated outside of the JS heap is not accounted for.
+
+    Returns \c false if writing to \a device failed.
+ */
+bool MemoryManager::writeHeapSnapshot(QIODevice *device)
+{
+    // Nothing can be allocated or freed while we walk the heap
+    QScopedValueRollback blockGC(gcBlocked, std::max(gcBlocked, NormalBlocked));
+
+    HeapSnapshotBuilder graph;
+    MarkStack stack(engine, &graph);
+
+    graph.beginNode(HeapSnapshotBuilder::Roots);
+    for (uint i = HeapSnapshotBuilder::EngineRoots; i < HeapSnapshotBuilder::NSyntheticNodes; ++i)
+        graph.edges.push_back(i);
+
+    graph.beginNode(HeapSnapshotBuilder::EngineRoots);
+    engine->markObjects(&stack);
+
+    graph.beginNode(HeapSnapshotBuilder::JSStackRoots);
+    collectFromJSStack(&stack);
+
+    graph.beginNode(HeapSnapshotBuilder::PersistentRoots);
+    for (PersistentValueStorage::Iterator it = m_persistentValues->begin(); it.p; ++it) {
+        if (Managed *m = (*it).as<Managed>())
+            m->mark(&stack);
+    }
+
+    // The same rules as for the weak values in the gc apply
+    graph.beginNode(HeapSnapshotBuilder::QObjectRoots);
+    for (PersistentValueStorage::Iterator it = m_weakValues->begin(); it.p; ++it) {
+        QObjectWrapper *wrapper = (*it).as<QObjectWrapper>();
+        if (!wrapper || !wrapper->object())
+            continue;
+        QObject *object = wrapper->object();
+        while (object->parent())
+            object = object->parent();
+        if (QQmlData::keepAliveDuringGarbageCollection(wrapper->object())
+                || (object != wrapper->object()
+                    && QQmlData::keepAliveDuringGarbageCollection(object))) {
+            wrapper->mark(&stack);
+        }
+    }
+
+    for (uint node = HeapSnapshotBuilder::NSyntheticNodes; node < graph.nodeCount(); ++node) {
+        graph.beginNode(node);
+        Heap::Base *item = graph.items[node];
+        item->internalClass->vtable->markObjects(item, &stack);
+    }
+
+    QHash<const Chunk *, size_t> hugeItems;
+    for (const HugeItemAllocator::HugeChunk &c : hugeItemAllocator.chunks)
+        hugeItems.insert(c.chunk, c.size);
+
+    const uint nodeCount = graph.nodeCount();
+    std::vector<quint64> retainedSizes(nodeCount, 0);
+    for (uint node = HeapSnapshotBuilder::NSyntheticNodes; node < nodeCount; ++node)
+        retainedSizes[node] = itemSize(graph.items[node], hugeItems);
+
+    std::vector<uint> postOrder;
+    const std::vector<uint> idom = dominators(graph, &postOrder);
+    for (uint node : postOrder) {
+        if (node != HeapSnapshotBuilder::Roots)
+            retainedSizes[idom[node]] += retainedSizes[node];
+    }
+
+    SnapshotWriter out(device);
+    out.write("{\"snapshot\":{\"meta\":{"
+              "\"node_fields\":[\"type\",\"name\",\"id\",\"self_size\",\"edge_count\","
+              "\"retained_size\"],"
+              "\"node_types\":[[\"hidden\",\"array\",\"string\",\"object\",\"code\","
+              "\"closure\",\"regexp\",\"number\",\"native\",\"synthetic\","
+              "\"concatenated string\"],\"string\",\"number\",\"number\",\"number\","
+              "\"number\"],"
+              "\"edge_fields\":[\"type\",\"name_or_index\",\"to_node\"],"
+              "\"edge_types\":[[\"context\",\"element\",\"property\",\"internal\",\"hidden\","
+              "\"shortcut\",\"weak\"],\"string_or_number\",\"node\"]},"
+              "\"node_count\":");
+    out.write(quint64(nodeCount));
+    out.write(",\"edge_count\":");
+    out.write(quint64(graph.edges.size()));
+    out.write("},\n\"nodes\":[");
+
+    QHash<QString, uint> stringIndices;
+    std::vector<QString> strings;
+    auto stringIndex = [&](const QString &string) {
+        auto it = stringIndices.find(string);
+        if (it == stringIndices.end()) {
+            it = stringIndices.insert(string, uint(strings.size()));
+            strings.push_back(string);
+        }
+        return *it;
+    };
+
+    static const char *const syntheticNames[] = {
+        "(GC roots)", "(Engine roots)", "(JS stack)", "(Persistent values)",
+        "(Kept alive QObjects)"
+    };
+    static_assert(std::size(syntheticNames) == HeapSnapshotBuilder::NSyntheticNodes);
+
+    for (uint node = 0; node < nodeCount; ++node) {
+        Heap::Base *item = graph.items[node];
+        NodeType type = Synthetic;
+        uint name;
+        quint64 id = node;
+        quint64 selfSize = 0;
+        if (item) {
+            type = nodeType(item);
+            name = stringIndex(nodeName(item, type));
+            id = quintptr(item) >> Chunk::SlotSizeShift;
+            selfSize = itemSize(item, hugeItems);
+        } else {
+            name = stringIndex(QLatin1String(syntheticNames[node]));
+        }
+        const uint edgeEnd = node + 1 < nodeCount ? graph.firstEdge[node + 1]
+                                                  : uint(graph.edges.size());
+        if (node)
+            out.write(",");
+        out.write(QByteArray::number(type) + ',' + QByteArray::number(name) + ','
+                  + QByteArray::number(id) + ',' + QByteArray::number(selfSize) + ','
+                  + QByteArray::number(edgeEnd - graph.firstEdge[node]) + ','
+                  + QByteArray::number(retainedSizes[node]) + '\n');
+    }
+
+    out.write("],\n\"edges\":[");
+    for (uint node = 0; node < nodeCount; ++node) {
+        const uint edgeEnd = node + 1 < nodeCount ? graph.firstEdge[node + 1]
+                                                  : uint(graph.edges.size());
+        for (uint e = graph.firstEdge[node]; e < edgeEnd; ++e) {
+            if (e)
+                out.write(",");
+            out.write(QByteArray::number(int(ElementEdge)) + ','
+                      + QByteArray::number(e - graph.firstEdge[node]) + ','
+                      + QByteArray::number(quint64(graph.edges[e]) * NodeFieldCount) + '\n');
+        }
+    }
+
+    out.write("],\n\"strings\":[");
+    for (size_t i = 0; i < strings.size(); ++i) {
+        if (i)
+            out.write(",");
+        out.writeString(strings[i]);
+    }
+    out.write("]}\n");
+
+    if (gcStats) {
+        qDebug(lcGcStats) << "Wrote heap snapshot with" << nodeCount << "nodes and"
+                          << graph.edges.size() << "edges," << retainedSizes[0]
+                          << "bytes reachable";
+    }
+    return out.finish();
+}
+
+} // namespace QV4
+
+QT_END_NAMESPACE
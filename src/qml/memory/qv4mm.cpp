@@ -6,6 +6,7 @@
 #include "qv4mm_p.h"
 #include "qv4qobjectwrapper_p.h"
 #include "qv4identifiertable_p.h"
+#include "qv4lookup_p.h"
 #include <QtCore/qalgorithms.h>
 #include <QtCore/private/qnumeric_p.h>
 #include <QtCore/qloggingcategory.h>
@@ -17,6 +18,12 @@
 #include <QElapsedTimer>
 #include <QMap>
 #include <QScopedValueRollback>
+#if QT_CONFIG(thread)
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+#endif
 
 #include <cstdlib>
 #include <algorithm>
@@ -194,7 +201,16 @@ Chunk *MemorySegment::allocate(size_t size)
 }
 
 struct ChunkAllocator {
-    ChunkAllocator() {}
+    ChunkAllocator()
+    {
+#if QT_CONFIG(thread)
+        if (qEnvironmentVariableIsSet("QV4_GC_BACKGROUND_SWEEP")) {
+            releaseThread = std::make_unique<QThreadPool>();
+            releaseThread->setMaxThreadCount(1);
+        }
+#endif
+    }
+    ~ChunkAllocator();
 
     size_t requiredChunkSize(size_t size) {
         size += Chunk::HeaderSize; // space required for the Chunk header
@@ -207,13 +223,40 @@ struct ChunkAllocator {
 
     Chunk *allocate(size_t size = 0);
     void free(Chunk *chunk, size_t size = 0);
+    void freeSegment(MemorySegment *segment, Chunk *chunk, size_t size);
+    void releaseFreedChunks();
 
     std::vector<MemorySegment> memorySegments;
+
+private:
+    void freeNow(Chunk *chunk, size_t size);
+
+#if QT_CONFIG(thread)
+    /* Returning memory to the OS takes a few system calls per chunk (and zeroing the
+       memory on some platforms). In background sweep mode, chunks freed during a sweep
+       are collected instead, and released on a separate thread once the sweep is done.
+       Freed chunks stay marked as allocated in their MemorySegment until then, so that
+       they can't be handed out again in the mean time.
+     */
+    struct FreedChunk {
+        MemorySegment *ownSegment; // set for huge items having their own segment
+        Chunk *chunk;
+        size_t size;
+    };
+    void release(const std::vector<FreedChunk> &chunks);
+
+    std::unique_ptr<QThreadPool> releaseThread;
+    std::vector<FreedChunk> freedChunks;
+    QMutex mutex;
+#endif
 };
 
 Chunk *ChunkAllocator::allocate(size_t size)
 {
     size = requiredChunkSize(size);
+#if QT_CONFIG(thread)
+    QMutexLocker locker(releaseThread ? &mutex : nullptr);
+#endif
     for (auto &m : memorySegments) {
         if (~m.allocatedMap) {
             Chunk *c = m.allocate(size);
@@ -230,6 +273,67 @@ Chunk *ChunkAllocator::allocate(size_t size)
 }
 
 void ChunkAllocator::free(Chunk *chunk, size_t size)
+{
+#if QT_CONFIG(thread)
+    if (releaseThread) {
+        freedChunks.push_back(FreedChunk{nullptr, chunk, size});
+        return;
+    }
+#endif
+    freeNow(chunk, size);
+}
+
+// Frees a huge item \a chunk of \a size bytes living in its own \a segment
+void ChunkAllocator::freeSegment(MemorySegment *segment, Chunk *chunk, size_t size)
+{
+#if QT_CONFIG(thread)
+    if (releaseThread) {
+        freedChunks.push_back(FreedChunk{segment, chunk, size});
+        return;
+    }
+#endif
+    segment->free(chunk, size);
+    delete segment;
+}
+
+// Called at the end of a sweep, to hand the chunks freed by it over to the release thread
+void ChunkAllocator::releaseFreedChunks()
+{
+#if QT_CONFIG(thread)
+    if (freedChunks.empty())
+        return;
+    releaseThread->start([this, chunks = std::exchange(freedChunks, {})]() {
+        release(chunks);
+    });
+#endif
+}
+
+#if QT_CONFIG(thread)
+void ChunkAllocator::release(const std::vector<FreedChunk> &chunks)
+{
+    for (const FreedChunk &c : chunks) {
+        if (c.ownSegment) {
+            c.ownSegment->free(c.chunk, c.size);
+            delete c.ownSegment;
+        } else {
+            QMutexLocker locker(&mutex);
+            freeNow(c.chunk, c.size);
+        }
+    }
+}
+#endif
+
+ChunkAllocator::~ChunkAllocator()
+{
+#if QT_CONFIG(thread)
+    if (releaseThread) {
+        releaseThread->waitForDone();
+        release(std::exchange(freedChunks, {}));
+    }
+#endif
+}
+
+void ChunkAllocator::freeNow(Chunk *chunk, size_t size)
 {
     size = requiredChunkSize(size);
     for (auto &m : memorySegments) {
@@ -544,6 +648,7 @@ HeapItem *BlockAllocator::allocate(size_t size, bool forceAllocation) {
 
 done:
     m->setAllocatedSlots(slotsRequired);
+    allocatedSlotsSinceLastSweep += slotsRequired;
     Q_V4_PROFILE_ALLOC(engine, slotsRequired * Chunk::SlotSize, Profiling::SmallItem);
 #ifdef V4_USE_HEAPTRACK
     heaptrack_report_alloc(m, slotsRequired * Chunk::SlotSize);
@@ -559,16 +664,28 @@ void BlockAllocator::sweep()
     memset(freeBins, 0, sizeof(freeBins));
 
 //    qDebug() << "BlockAlloc: sweep";
+    const size_t usedSlotsBeforeSweep = usedSlotsAfterLastSweep + allocatedSlotsSinceLastSweep;
     usedSlotsAfterLastSweep = 0;
 
     auto firstEmptyChunk = std::partition(chunks.begin(), chunks.end(), [this](Chunk *c) {
         return c->sweep(engine);
     });
 
-    std::for_each(chunks.begin(), firstEmptyChunk, [this](Chunk *c) {
-        c->sortIntoBins(freeBins, NumBins);
-        usedSlotsAfterLastSweep += c->nUsedSlots();
+    // Objects can't be moved, so the best we can do against fragmentation is to steer new
+    // allocations away from sparsely used chunks: the bins are LIFO lists, so sorting the
+    // sparsest chunks into them first makes allocations fill up the dense chunks before
+    // touching the sparse ones, which then get a chance to become empty and be freed.
+    std::vector<std::pair<uint, Chunk *>> chunksByUsage;
+    chunksByUsage.reserve(firstEmptyChunk - chunks.begin());
+    std::for_each(chunks.begin(), firstEmptyChunk, [&](Chunk *c) {
+        const uint used = c->nUsedSlots();
+        usedSlotsAfterLastSweep += used;
+        chunksByUsage.emplace_back(used, c);
     });
+    std::stable_sort(chunksByUsage.begin(), chunksByUsage.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+    for (const auto &entry : chunksByUsage)
+        entry.second->sortIntoBins(freeBins, NumBins);
 
     // only free the chunks at the end to avoid that the sweep() calls indirectly
     // access freed memory
@@ -578,6 +695,41 @@ void BlockAllocator::sweep()
     });
 
     chunks.erase(firstEmptyChunk, chunks.end());
+
+    allocatedSlotsBeforeLastSweep = std::exchange(allocatedSlotsSinceLastSweep, 0);
+    freedSlotsInLastSweep = usedSlotsBeforeSweep > usedSlotsAfterLastSweep
+            ? usedSlotsBeforeSweep - usedSlotsAfterLastSweep
+            : 0;
+}
+
+/*!
+    \internal
+    Hands the pages that only contain free slots back to the operating system, while keeping
+    them mapped. Free ranges store their list header in their first slot, so the page holding
+    it is kept. Returns the number of bytes released.
+ */
+size_t BlockAllocator::releaseFreePages()
+{
+    const quintptr pageSize = WTF::pageSize();
+    size_t released = 0;
+    auto release = [&](quintptr begin, quintptr end) {
+        begin = (begin + pageSize - 1) & ~(pageSize - 1);
+        end &= ~(pageSize - 1);
+        if (end <= begin)
+            return;
+        // decommit() may also drop the access rights, so recommit right away. The pages
+        // stay backed by nothing until they are touched again.
+        OSAllocator::decommit(reinterpret_cast<void *>(begin), end - begin);
+        OSAllocator::commit(reinterpret_cast<void *>(begin), end - begin, true, false);
+        released += end - begin;
+    };
+
+    // Only the last bin can hold ranges spanning full pages
+    for (HeapItem *h = freeBins[NumBins - 1]; h; h = h->freeData.next)
+        release(quintptr(h + 1), quintptr(h + h->freeData.availableSlots));
+    if (nFree)
+        release(quintptr(nextFree), quintptr(nextFree + nFree));
+    return released;
 }
 
 void BlockAllocator::freeAll()
@@ -633,8 +785,7 @@ static void freeHugeChunk(ChunkAllocator *chunkAllocator, const HugeItemAllocato
     }
     if (c.segment) {
         // own memory segment
-        c.segment->free(c.chunk, c.size);
-        delete c.segment;
+        chunkAllocator->freeSegment(c.segment, c.chunk, c.size);
     } else {
         chunkAllocator->free(c.chunk, c.size);
     }
@@ -673,6 +824,213 @@ void HugeItemAllocator::freeAll()
     }
 }
 
+#if QT_CONFIG(thread)
+
+/*!
+    \internal
+    Drains the mark stack using several threads. Each thread has its own, small MarkStack.
+    Threads that accumulate more items than they can handle hand some of them over to a
+    shared pool of batches, from which idle threads take their work. Marking is complete
+    once all threads are idle and the pool is empty. Mark bits are set atomically while
+    the threads are running; the mutator is not running during that time.
+
+    Enabled by setting QV4_GC_PARALLEL_MARK_THREADS to the number of threads to use
+    (including the engine thread), or to 0 for one thread per core.
+ */
+struct ParallelMarker
+{
+    enum {
+        LocalStackSize = 16 * 1024,
+        BatchSize = 256,
+        DeadlineCheckInterval = 1024,
+        // Below this, waking up the worker threads costs more than it saves
+        MinParallelWork = 2 * BatchSize,
+    };
+
+    using Batch = std::vector<Heap::Base *>;
+
+    ParallelMarker(ExecutionEngine *engine, int threadCount)
+        : engine(engine)
+        , threadCount(threadCount)
+    {
+        pool.setMaxThreadCount(threadCount - 1);
+        for (int i = 0; i < threadCount; ++i)
+            stacks.emplace_back(new Heap::Base *[LocalStackSize]);
+    }
+
+    ~ParallelMarker() { pool.waitForDone(); }
+
+    MarkStack::DrainState drain(MarkStack *markStack, QDeadlineTimer deadline);
+    void shareWork(MarkStack *stack);
+
+    ExecutionEngine *engine;
+    const int threadCount;
+    QThreadPool pool;
+    QMutex mutex;
+    QWaitCondition workAvailable;
+    std::vector<Batch> sharedWork;
+    std::vector<std::unique_ptr<Heap::Base *[]>> stacks;
+    std::atomic<int> idleThreads = 0;
+    std::atomic<quint64> markedObjects = 0;
+    bool finished = false;
+
+private:
+    void work(int index, QDeadlineTimer deadline);
+    bool takeWork(MarkStack *stack);
+    void giveBackWork(MarkStack *stack);
+};
+
+void MarkStack::shareWork()
+{
+    m_parallelMarker->shareWork(this);
+}
+
+// Moves the upper half of \a stack to the shared pool
+void ParallelMarker::shareWork(MarkStack *stack)
+{
+    const size_t n = stack->size() / 2;
+    if (!n)
+        return;
+    Batch batch(stack->m_top - n, stack->m_top);
+    stack->m_top -= n;
+
+    QMutexLocker locker(&mutex);
+    sharedWork.push_back(std::move(batch));
+    workAvailable.wakeOne();
+}
+
+void ParallelMarker::giveBackWork(MarkStack *stack)
+{
+    Batch batch(stack->m_base, stack->m_top);
+    stack->m_top = stack->m_base;
+
+    QMutexLocker locker(&mutex);
+    if (!batch.empty())
+        sharedWork.push_back(std::move(batch));
+    // Make everybody stop; the remaining work is picked up in the next drain() call.
+    finished = true;
+    workAvailable.wakeAll();
+}
+
+bool ParallelMarker::takeWork(MarkStack *stack)
+{
+    Q_ASSERT(stack->isEmpty());
+
+    QMutexLocker locker(&mutex);
+    ++idleThreads;
+    while (sharedWork.empty() && !finished) {
+        if (idleThreads == threadCount) {
+            // Everybody is out of work. We're done.
+            finished = true;
+            workAvailable.wakeAll();
+            break;
+        }
+        workAvailable.wait(&mutex);
+    }
+    --idleThreads;
+    if (finished)
+        return false;
+
+    Batch batch = std::move(sharedWork.back());
+    sharedWork.pop_back();
+    locker.unlock();
+
+    Q_ASSERT(batch.size() < size_t(stack->m_softLimit - stack->m_base));
+    memcpy(stack->m_base, batch.data(), batch.size() * sizeof(Heap::Base *));
+    stack->m_top = stack->m_base + batch.size();
+    return true;
+}
+
+void ParallelMarker::work(int index, QDeadlineTimer deadline)
+{
+    MarkStack stack(engine, stacks[index].get(), LocalStackSize, this);
+    quint64 count = 0;
+    while (takeWork(&stack)) {
+        while (!stack.isEmpty()) {
+            Heap::Base *h = stack.pop();
+            Q_ASSERT(h && h->internalClass);
+            h->internalClass->vtable->markObjects(h, &stack);
+            if (++count % DeadlineCheckInterval)
+                continue;
+            if (deadline.hasExpired()) {
+                giveBackWork(&stack);
+                break;
+            }
+            // Keep the other threads busy
+            if (idleThreads.load(std::memory_order_relaxed) && stack.size() >= MinParallelWork)
+                shareWork(&stack);
+        }
+    }
+    markedObjects.fetch_add(count, std::memory_order_relaxed);
+}
+
+MarkStack::DrainState ParallelMarker::drain(MarkStack *markStack, QDeadlineTimer deadline)
+{
+    // Process items serially until there is enough work to split up. Often the mark stack
+    // only holds a few items, but those reference lots of others.
+    for (int i = 1; markStack->size() < MinParallelWork; ++i) {
+        if (markStack->isEmpty())
+            return MarkStack::DrainState::Complete;
+        Heap::Base *h = markStack->pop();
+        h->internalClass->vtable->markObjects(h, markStack);
+        ++engine->memoryManager->markStackSize;
+        if (!(i % DeadlineCheckInterval) && deadline.hasExpired())
+            return MarkStack::DrainState::Ongoing;
+    }
+
+    for (size_t i = 0, end = markStack->size(); i < end; i += BatchSize) {
+        sharedWork.emplace_back(markStack->m_base + i,
+                                markStack->m_base + std::min<size_t>(i + BatchSize, end));
+    }
+    markStack->m_top = markStack->m_base;
+    finished = false;
+    markedObjects = 0;
+
+    for (int i = 1; i < threadCount; ++i)
+        pool.start([this, i, deadline]() { work(i, deadline); });
+    work(0, deadline);
+    pool.waitForDone();
+
+    engine->memoryManager->markStackSize += uint(markedObjects.load(std::memory_order_relaxed));
+
+    // If we ran into the deadline, put the remaining work back.
+    for (const Batch &batch : std::exchange(sharedWork, {})) {
+        for (Heap::Base *h : batch)
+            markStack->push(h);
+    }
+
+    return markStack->isEmpty()
+            ? MarkStack::DrainState::Complete
+            : MarkStack::DrainState::Ongoing;
+}
+
+#else
+
+void MarkStack::shareWork()
+{
+    Q_UNREACHABLE();
+}
+
+#endif // QT_CONFIG(thread)
+
+/*!
+    \internal
+    Logs how much of the memory allocated since the previous gc cycle was reclaimed by the
+    last sweep. Objects surviving the sweep are not necessarily young ones, but as long as
+    the old generation is mostly stable, this is a good approximation of the nursery
+    survival rate.
+ */
+static void logYoungGenerationStats(const BlockAllocator &allocator)
+{
+    const size_t allocated = allocator.allocatedSlotsBeforeLastSweep;
+    if (!allocated)
+        return;
+    const size_t freed = std::min(allocator.freedSlotsInLastSweep, allocated);
+    qDebug(lcGcStats) << "Allocated" << allocated * Chunk::SlotSize
+                      << "bytes since last GC, freed" << freed * Chunk::SlotSize << "bytes,"
+                      << "young survival rate" << (100 * (allocated - freed) / allocated) << "%";
+}
+
 namespace {
 using ExtraData = GCStateInfo::ExtraData;
 GCState markStart(GCStateMachine *that, ExtraData &)
@@ -742,6 +1100,11 @@ GCState markWeakValues(GCStateMachine *that, ExtraData &stateData)
     if (wasDrainNecessary(markStack, that->deadline) && that->deadline.hasExpired())
         return GCState::MarkWeakValues;
     PersistentValueStorage::Iterator& it = get<GCIteratorStorage>(stateData).it;
+    // Siblings tend to be wrapped one after the other, so remember the outcome of the last
+    // walk up to the root of the object tree instead of repeating it for every wrapper.
+    // No user code runs within this loop, so the object tree can't change underneath us.
+    QObject *lastParent = nullptr;
+    bool lastParentKeepsAlive = false;
     // avoid repeatedly hitting the timer constantly by batching iterations
     for (int i = 0; i < markLoopIterationCount; ++i) {
         if (!it.p)
@@ -757,9 +1120,13 @@ GCState markWeakValues(GCStateMachine *that, ExtraData &stateData)
 
         if (!keepAlive) {
             if (QObject *parent = qobject->parent()) {
-                while (parent->parent())
-                    parent = parent->parent();
-                keepAlive = QQmlData::keepAliveDuringGarbageCollection(parent);
+                if (parent != lastParent) {
+                    lastParent = parent;
+                    while (parent->parent())
+                        parent = parent->parent();
+                    lastParentKeepsAlive = QQmlData::keepAliveDuringGarbageCollection(parent);
+                }
+                keepAlive = lastParentKeepsAlive;
             }
         }
 
@@ -771,6 +1138,24 @@ GCState markWeakValues(GCStateMachine *that, ExtraData &stateData)
 
 GCState markDrain(GCStateMachine *that, ExtraData &)
 {
+#if QT_CONFIG(thread)
+    if (ParallelMarker *parallelMarker = that->mm->parallelMarker.get()) {
+        QElapsedTimer timer;
+        if (that->mm->gcStats)
+            timer.start();
+        const uint markedBefore = that->mm->markStackSize;
+        auto drainState = parallelMarker->drain(that->mm->markStack(), that->deadline);
+        if (that->mm->gcStats) {
+            const qint64 elapsed = timer.nsecsElapsed() / 1000;
+            const uint marked = that->mm->markStackSize - markedBefore;
+            qDebug(lcGcStats) << "Parallel mark step using" << parallelMarker->threadCount
+                              << "threads marked" << marked << "objects in" << elapsed << "us";
+        }
+        return drainState == MarkStack::DrainState::Complete
+                ? GCState::MarkReady
+                : GCState::MarkDrain;
+    }
+#endif
     if (that->deadline.isForever()) {
         that->mm->markStack()->drain();
         return GCState::MarkReady;
@@ -875,9 +1260,12 @@ GCState doSweep(GCStateMachine *that, ExtraData &)
     auto mm = that->mm;
 
     mm->engine->identifierTable->sweep();
+    if (mm->engine->megamorphicLookupCache)
+        mm->engine->megamorphicLookupCache->clear();
     mm->blockAllocator.sweep();
     mm->hugeItemAllocator.sweep(that->mm->gcCollectorStats ? increaseFreedCountForClass : nullptr);
     mm->icAllocator.sweep();
+    mm->chunkAllocator->releaseFreedChunks();
 
     // reset all black bits
     mm->blockAllocator.resetBlackBits();
@@ -885,6 +1273,8 @@ GCState doSweep(GCStateMachine *that, ExtraData &)
     mm->icAllocator.resetBlackBits();
 
     mm->usedSlotsAfterLastFullSweep = mm->blockAllocator.usedSlotsAfterLastSweep + mm->icAllocator.usedSlotsAfterLastSweep;
+    if (mm->gcStats)
+        logYoungGenerationStats(mm->blockAllocator);
     mm->gcBlocked = MemoryManager::Unblocked;
     mm->m_markStack.reset();
     mm->engine->isGCOngoing = false;
@@ -917,6 +1307,16 @@ MemoryManager::MemoryManager(ExecutionEngine *engine)
     if (gcStats)
         blockAllocator.allocationStats = statistics.allocations;
 
+#if QT_CONFIG(thread)
+    if (qEnvironmentVariableIsSet("QV4_GC_PARALLEL_MARK_THREADS")) {
+        int threads = qEnvironmentVariableIntValue("QV4_GC_PARALLEL_MARK_THREADS");
+        if (threads <= 0)
+            threads = QThread::idealThreadCount();
+        if (threads > 1)
+            parallelMarker = std::make_unique<ParallelMarker>(engine, threads);
+    }
+#endif
+
     gcStateMachine = std::make_unique<GCStateMachine>();
     gcStateMachine->mm = this;
 
@@ -1051,8 +1451,6 @@ Heap::Object *MemoryManager::allocObjectWithMemberData(const QV4::VTable *vtable
     return o;
 }
 
-static uint markStackSize = 0;
-
 MarkStack::MarkStack(ExecutionEngine *engine)
     : m_engine(engine)
 {
@@ -1066,13 +1464,15 @@ MarkStack::MarkStack(ExecutionEngine *engine)
 void MarkStack::drain()
 {
     // we're not calling drain(QDeadlineTimer::Forever) as that has higher overhead
+    uint marked = 0;
     while (m_top > m_base) {
         Heap::Base *h = pop();
-        ++markStackSize;
+        ++marked;
         Q_ASSERT(h); // at this point we should only have Heap::Base objects in this area on the stack. If not, weird things might happen.
         Q_ASSERT(h->internalClass);
         h->internalClass->vtable->markObjects(h, this);
     }
+    m_engine->memoryManager->markStackSize += marked;
 }
 
 MarkStack::DrainState MarkStack::drain(QDeadlineTimer deadline)
@@ -1082,7 +1482,7 @@ MarkStack::DrainState MarkStack::drain(QDeadlineTimer deadline)
             if (m_top == m_base)
                 return DrainState::Complete;
             Heap::Base *h = pop();
-            ++markStackSize;
+            ++m_engine->memoryManager->markStackSize;
             Q_ASSERT(h); // at this point we should only have Heap::Base objects in this area on the stack. If not, weird things might happen.
             Q_ASSERT(h->internalClass);
             h->internalClass->vtable->markObjects(h, this);
@@ -1097,6 +1497,18 @@ void MarkStack::setSoftLimit(size_t size)
     Q_ASSERT(m_softLimit < m_hardLimit);
 }
 
+MarkStack::MarkStack(ExecutionEngine *engine, Heap::Base **base, size_t size,
+                     ParallelMarker *marker)
+    : m_top(base)
+    , m_base(base)
+    , m_softLimit(base + size * 3 / 4)
+    , m_hardLimit(base + size)
+    , m_engine(engine)
+    , m_parallelMarker(marker)
+    , m_special(true)
+{
+}
+
 void MemoryManager::onEventLoop()
 {
     if (engine->inShutdown)
@@ -1139,9 +1551,14 @@ void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPt
 
     if (!lastSweep) {
         engine->identifierTable->sweep();
+        if (engine->megamorphicLookupCache)
+            engine->megamorphicLookupCache->clear();
         blockAllocator.sweep(/*classCountPtr*/);
         hugeItemAllocator.sweep(classCountPtr);
         icAllocator.sweep(/*classCountPtr*/);
+        chunkAllocator->releaseFreedChunks();
+        if (gcStats)
+            logYoungGenerationStats(blockAllocator);
     }
 
     // reset all black bits
@@ -1363,6 +1780,51 @@ void MemoryManager::runGC()
         statistics.maxUsedMem = qMax(statistics.maxUsedMem, getUsedMem() + getLargeItemsMem());
 }
 
+static void logFragmentation(const char *when, const BlockAllocator &allocator)
+{
+    size_t sparseChunks = 0;
+    for (const Chunk *c : allocator.chunks) {
+        if (c->nUsedSlots() * 4 < Chunk::AvailableSlots)
+            ++sparseChunks;
+    }
+    qDebug(lcGcStats) << "Heap" << when << ":" << allocator.chunks.size() << "chunks,"
+                      << allocator.usedMem() << "of" << allocator.allocatedMem() << "bytes used,"
+                      << sparseChunks << "chunks less than 25% used";
+}
+
+/*!
+    \internal
+    Runs a full garbage collection and then returns the memory of free heap pages to the
+    operating system. Meant for long running engines that went through a phase of high
+    memory usage, for example when the application becomes idle.
+
+    Heap objects are referenced by raw pointers from C++ and can't be moved, so this does
+    not compact the heap. Chunks that become entirely empty are freed by the collection;
+    of the partially used ones only the free pages are released.
+ */
+MemoryManager::ReleaseStatistics MemoryManager::releaseUnusedMemory()
+{
+    ReleaseStatistics result;
+    result.allocatedBefore = getAllocatedMem();
+    result.usedBefore = getUsedMem();
+    if (gcStats)
+        logFragmentation("before releasing unused memory", blockAllocator);
+
+    runFullGC();
+
+    // Don't touch the free lists while a collection is still running
+    if (!engine->isGCOngoing)
+        result.released = blockAllocator.releaseFreePages() + icAllocator.releaseFreePages();
+
+    result.allocatedAfter = getAllocatedMem();
+    result.usedAfter = getUsedMem();
+    if (gcStats) {
+        logFragmentation("after releasing unused memory", blockAllocator);
+        qDebug(lcGcStats) << "Released" << result.released << "bytes of free heap pages";
+    }
+    return result;
+}
+
 size_t MemoryManager::getUsedMem() const
 {
     return blockAllocator.usedMem() + icAllocator.usedMem();
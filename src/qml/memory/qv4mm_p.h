@@ -26,6 +26,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QIODevice;
+
 namespace QV4 {
 
 struct GCData { virtual ~GCData(){};};
@@ -142,11 +144,18 @@ struct BlockAllocator {
     void sweep();
     void freeAll();
     void resetBlackBits();
+    size_t releaseFreePages();
 
     // bump allocations
     HeapItem *nextFree = nullptr;
     size_t nFree = 0;
     size_t usedSlotsAfterLastSweep = 0;
+    // Slots handed out since the last sweep. As the heap is not generational, this is what a
+    // nursery would contain; comparing it with the slots freed by the sweep tells us how much
+    // of the young objects died.
+    size_t allocatedSlotsSinceLastSweep = 0;
+    size_t allocatedSlotsBeforeLastSweep = 0;
+    size_t freedSlotsInLastSweep = 0;
     HeapItem *freeBins[NumBins];
     ChunkAllocator *chunkAllocator;
     ExecutionEngine *engine;
@@ -327,6 +336,17 @@ public:
     void runGC();
     bool tryForceGCCompletion();
     void runFullGC();
+    struct ReleaseStatistics
+    {
+        size_t allocatedBefore = 0;
+        size_t usedBefore = 0;
+        size_t allocatedAfter = 0;
+        size_t usedAfter = 0;
+        // Bytes of free pages handed back to the operating system, out of allocatedAfter.
+        size_t released = 0;
+    };
+    ReleaseStatistics releaseUnusedMemory();
+    bool writeHeapSnapshot(QIODevice *device);
 
     void dumpStats() const;
 
@@ -425,6 +445,7 @@ public:
 
     std::unique_ptr<GCStateMachine> gcStateMachine{nullptr};
     std::unique_ptr<MarkStack> m_markStack{nullptr};
+    std::unique_ptr<ParallelMarker> parallelMarker{nullptr};
 
     std::size_t unmanagedHeapSize = 0; // the amount of bytes of heap that is not managed by the memory manager, but which is held onto by managed items.
     std::size_t unmanagedHeapSizeGCLimit;
@@ -439,6 +460,10 @@ public:
     int allocationCount = 0;
     size_t lastAllocRequestedSlots = 0;
 
+    // Number of objects marked, for the gc statistics. Only updated on the engine thread,
+    // parallel marker threads count on their own and add up at the end of each drain.
+    uint markStackSize = 0;
+
     struct {
         size_t maxReservedMem = 0;
         size_t maxAllocatedMem = 0;
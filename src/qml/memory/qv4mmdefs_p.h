@@ -19,6 +19,8 @@
 #include <QtCore/qalgorithms.h>
 #include <QtCore/qmath.h>
 
+#include <atomic>
+
 QT_BEGIN_NAMESPACE
 
 class QDeadlineTimer;
@@ -100,6 +102,15 @@ struct Chunk {
         quintptr bit = bitForIndex(index);
         *bitmap &= ~bit;
     }
+    // Used when several threads mark concurrently. Returns whether the bit was already set.
+    static bool testAndSetBitAtomic(quintptr *word, quintptr bit) {
+        static_assert(sizeof(std::atomic<quintptr>) == sizeof(quintptr));
+        static_assert(std::atomic<quintptr>::is_always_lock_free);
+        std::atomic<quintptr> *atomicWord = reinterpret_cast<std::atomic<quintptr> *>(word);
+        if (atomicWord->load(std::memory_order_relaxed) & bit)
+            return true;
+        return atomicWord->fetch_or(bit, std::memory_order_relaxed) & bit;
+    }
     static bool testBit(quintptr *bitmap, size_t index) {
 //        Q_ASSERT(index >= HeaderSize/SlotSize && index < ChunkSize/SlotSize);
         bitmap += bitmapIndex(index);
@@ -229,8 +240,13 @@ Q_STATIC_ASSERT(sizeof(HeapItem) == Chunk::SlotSize);
 Q_STATIC_ASSERT(QT_POINTER_SIZE*8 == Chunk::Bits);
 Q_STATIC_ASSERT((1 << Chunk::BitShift) == Chunk::Bits);
 
+struct ParallelMarker;
+struct HeapSnapshotBuilder;
+
 struct Q_QML_EXPORT MarkStack {
     MarkStack(ExecutionEngine *engine);
+    MarkStack(ExecutionEngine *engine, Heap::Base **base, size_t size, ParallelMarker *marker);
+    MarkStack(ExecutionEngine *engine, HeapSnapshotBuilder *snapshot);
     ~MarkStack() { /* we drain manually */ }
 
     void push(Heap::Base *m) {
@@ -239,6 +255,13 @@ struct Q_QML_EXPORT MarkStack {
         if (m_top < m_softLimit)
             return;
 
+        // Stacks of parallel marker threads hand part of their work over to the other
+        // threads instead of recursing.
+        if (m_parallelMarker) {
+            shareWork();
+            return;
+        }
+
         // If at or above soft limit, partition the remaining space into at most 64 segments and
         // allow one C++ recursion of drain() per segment, plus one for the fence post.
         const quintptr segmentSize = qNextPowerOfTwo(quintptr(m_hardLimit - m_softLimit) / 64u);
@@ -253,6 +276,15 @@ struct Q_QML_EXPORT MarkStack {
     }
 
     bool isEmpty() const { return m_top == m_base; }
+    size_t size() const { return m_top - m_base; }
+
+    // True if other threads may be marking concurrently, and mark bits need to be set atomically
+    bool isParallel() const { return m_parallelMarker != nullptr; }
+
+    // True for parallel marking and for stacks that don't mark at all, but hand the objects to
+    // markSpecial() instead. Keeps the common case down to a single check in Base::mark().
+    bool isSpecial() const { return m_special; }
+    void markSpecial(Heap::Base *m);
 
     qptrdiff remainingBeforeSoftLimit() const
     {
@@ -266,7 +298,10 @@ struct Q_QML_EXPORT MarkStack {
     DrainState drain(QDeadlineTimer deadline);
     void setSoftLimit(size_t size);
 private:
+    friend struct ParallelMarker;
+
     Heap::Base *pop() { return *(--m_top); }
+    void shareWork();
 
     Heap::Base **m_top = nullptr;
     Heap::Base **m_base = nullptr;
@@ -274,6 +309,9 @@ private:
     Heap::Base **m_hardLimit = nullptr;
 
     ExecutionEngine *m_engine = nullptr;
+    ParallelMarker *m_parallelMarker = nullptr;
+    HeapSnapshotBuilder *m_snapshot = nullptr;
+    bool m_special = false;
 
     quintptr m_drainRecursion = 0;
 };
@@ -63,7 +63,7 @@ Create a new QQmlDataBlob for \a url and of the provided \a type.
 */
 QQmlDataBlob::QQmlDataBlob(const QUrl &url, Type type, QQmlTypeLoader *manager)
 : m_typeLoader(manager), m_type(type), m_url(url), m_finalUrl(url), m_redirectCount(0),
-  m_inCallback(false), m_isDone(false)
+  m_inCallback(false), m_isDone(false), m_isParsing(false)
 {
     //Set here because we need to get the engine from the manager
     if (const QQmlEngine *qmlEngine = m_typeLoader->engine())
@@ -437,6 +437,28 @@ void QQmlDataBlob::allDependenciesDone()
     m_data.setStatus(QQmlDataBlob::ResolvingDependencies);
 }
 
+/*!
+Called on one of the type loader's parser threads if the blob handed itself to
+QQmlTypeLoader::parseInParallel() from dataReceived(). Implementations must only
+read the received source and write the blob's own parse results. Errors have to
+be stored and reported from sourceParsed(), as setError() is not available here.
+
+The default implementation does nothing.
+*/
+void QQmlDataBlob::parseSource()
+{
+}
+
+/*!
+Called in the load thread once parseSource() has returned. The blob is in a
+callback, just like in dataReceived(), and can set errors or add dependencies.
+
+The default implementation does nothing.
+*/
+void QQmlDataBlob::sourceParsed()
+{
+}
+
 /*!
 Called when the download progress of this blob changes.  \a progress goes
 from 0 to 1.
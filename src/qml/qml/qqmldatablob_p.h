@@ -118,6 +118,12 @@ protected:
     virtual void dependencyComplete(const QQmlDataBlob::Ptr &);
     virtual void allDependenciesDone();
 
+    // Made on a parser thread if QQmlTypeLoader::parseInParallel() accepted the blob.
+    // Must only touch the blob's own parse results.
+    virtual void parseSource();
+    // Made in load thread once parseSource() has returned
+    virtual void sourceParsed();
+
     // Callbacks made in main thread
     virtual void downloadProgressChanged(qreal);
     virtual void completed();
@@ -221,9 +227,10 @@ private:
     // List of QQmlDataBlob's that I am waiting for to complete.
     QVector<QQmlRefPointer<QQmlDataBlob>> m_waitingFor;
 
-    int m_redirectCount:30;
+    int m_redirectCount:29;
     bool m_inCallback:1;
     bool m_isDone:1;
+    bool m_isParsing:1;
 };
 
 QT_END_NAMESPACE
@@ -132,7 +132,7 @@ public:
     QV4::ExecutionEngine *v4engine() const { return q_func()->handle(); }
 
 #if QT_CONFIG(qml_worker_script)
-    QThread *workerScriptEngine = nullptr;
+    QObject *workerScriptEnginePool = nullptr;
 #endif
 
     QUrl baseUrl;
@@ -169,6 +169,14 @@ public:
     QQmlIncubationController *incubationController = nullptr;
     void incubate(QQmlIncubator &, const QQmlRefPointer<QQmlContextData> &);
 
+    // Time and number of objects it took to incubate components, by URL and sub-component.
+    struct IncubationCost
+    {
+        qint64 nsecs = 0;
+        int objectCount = 0;
+    };
+    QHash<QString, IncubationCost> incubationCosts;
+
     // These methods may be called from any thread
     QString offlineStorageDatabaseDirectory() const;
 
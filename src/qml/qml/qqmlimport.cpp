@@ -1628,6 +1628,11 @@ QString QQmlImportDatabase::absoluteFilePath(const QString &path) const
     return QQmlEnginePrivate::get(engine)->typeLoader.absoluteFilePath(path);
 }
 
+QQmlPersistentImportCache *QQmlImportDatabase::persistentImportCache() const
+{
+    return QQmlEnginePrivate::get(engine)->typeLoader.persistentImportCache();
+}
+
 /*!
     \internal
 */
@@ -13,6 +13,7 @@
 #include <QtQml/qqmlerror.h>
 #include <QtQml/qqmlfile.h>
 #include <private/qqmldirparser_p.h>
+#include <private/qqmlpersistentimportcache_p.h>
 #include <private/qqmltype_p.h>
 #include <private/qstringhash_p.h>
 #include <private/qfieldlist_p.h>
@@ -321,6 +322,7 @@ private:
     friend class QQmlPluginImporter;
 
     QString absoluteFilePath(const QString &path) const;
+    QQmlPersistentImportCache *persistentImportCache() const;
     void clearDirCache();
 
     struct QmldirCache {
@@ -329,6 +331,10 @@ private:
         QString qmldirPathUrl;
         QmldirCache *next;
     };
+
+    LocalQmldirResult finishLocateLocalQmldir(
+            const QString &uri, QTypeRevision version, QmldirCache *cacheHead,
+            LocalQmldirResult result, const QString &qmldirAbsoluteFilePath);
     // Maps from an import to a linked list of qmldir info.
     // Used in QQmlImports::locateQmldir()
     QStringHash<QmldirCache *> qmldirCache;
@@ -381,11 +387,45 @@ QQmlImportDatabase::LocalQmldirResult QQmlImportDatabase::locateLocalQmldir(
     // Interceptor might redirect remote files to local ones.
     QStringList localImportPaths = importPathList(hasInterceptors ? LocalOrRemote : Local);
 
+    const auto addLocation = [&](const QString &qmldirFilePath, const QString &url) {
+        QmldirCache *cache = new QmldirCache;
+        cache->version = version;
+        cache->qmldirFilePath = qmldirFilePath;
+        cache->qmldirPathUrl = url;
+        cache->next = nullptr;
+        if (cacheTail)
+            cacheTail->next = cache;
+        else
+            qmldirCache.insert(uri, cache);
+        cacheTail = cache;
+
+        if (result != QmldirFound)
+            result = callback(qmldirFilePath, url) ? QmldirFound : QmldirRejected;
+    };
+
+    // Without interceptors the locations only depend on the file system. An earlier run
+    // may have found them already.
+    QQmlPersistentImportCache *persistentCache = hasInterceptors
+            ? nullptr
+            : persistentImportCache();
+    QString qmldirAbsoluteFilePath;
+    if (persistentCache) {
+        if (const auto locations = persistentCache->qmldirLocations(
+                    uri, version, localImportPaths)) {
+            for (const QQmlPersistentImportCache::QmldirLocation &location : *locations) {
+                qmldirAbsoluteFilePath = location.filePath;
+                addLocation(location.filePath, location.url);
+            }
+            return finishLocateLocalQmldir(
+                    uri, version, cacheHead, result, qmldirAbsoluteFilePath);
+        }
+    }
+
     // Search local import paths for a matching version
     const QStringList qmlDirPaths = QQmlImports::completeQmldirPaths(
                 uri, localImportPaths, version);
 
-    QString qmldirAbsoluteFilePath;
+    QList<QQmlPersistentImportCache::QmldirLocation> foundLocations;
     for (QString qmldirPath : qmlDirPaths) {
         if (hasInterceptors) {
             const QUrl intercepted = engine->interceptUrl(
@@ -411,24 +451,26 @@ QQmlImportDatabase::LocalQmldirResult QQmlImportDatabase::locateLocalQmldir(
                 sanitizeUNCPath(&qmldirAbsoluteFilePath);
             }
 
-            QmldirCache *cache = new QmldirCache;
-            cache->version = version;
-            cache->qmldirFilePath = qmldirAbsoluteFilePath;
-            cache->qmldirPathUrl = url;
-            cache->next = nullptr;
-            if (cacheTail)
-                cacheTail->next = cache;
-            else
-                qmldirCache.insert(uri, cache);
-            cacheTail = cache;
-
-            if (result != QmldirFound)
-                result = callback(qmldirAbsoluteFilePath, url) ? QmldirFound : QmldirRejected;
+            if (persistentCache)
+                foundLocations.append({ qmldirAbsoluteFilePath, url });
+            addLocation(qmldirAbsoluteFilePath, url);
 
             // Do not return here. Rather, construct the complete cache for this URI.
         }
     }
 
+    if (persistentCache) {
+        persistentCache->insertQmldirLocations(
+                uri, version, localImportPaths, foundLocations, qmlDirPaths);
+    }
+
+    return finishLocateLocalQmldir(uri, version, cacheHead, result, qmldirAbsoluteFilePath);
+}
+
+inline QQmlImportDatabase::LocalQmldirResult QQmlImportDatabase::finishLocateLocalQmldir(
+        const QString &uri, QTypeRevision version, QmldirCache *cacheHead,
+        LocalQmldirResult result, const QString &qmldirAbsoluteFilePath)
+{
     // Nothing found? Add an empty cache entry to signal that for further requests.
     if (result == QmldirNotFound || result == QmldirInterceptedToRemote) {
         QmldirCache *cache = new QmldirCache;
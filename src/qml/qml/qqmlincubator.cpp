@@ -8,6 +8,10 @@
 #include "qqmlobjectcreator_p.h"
 #include <private/qqmlcomponent_p.h>
 
+#include <QtCore/qloggingcategory.h>
+
+Q_STATIC_LOGGING_CATEGORY(lcIncubatorStats, "qt.qml.incubator.statistics")
+
 void QQmlEnginePrivate::incubate(
         QQmlIncubator &i, const QQmlRefPointer<QQmlContextData> &forContext)
 {
@@ -36,16 +40,19 @@ void QQmlEnginePrivate::incubate(
             mode = QQmlIncubator::Asynchronous;
             p->waitingOnMe = parentIncubator;
             parentIncubator->waitingFor.insert(p.data());
+            p->priority = std::max(p->priority, parentIncubator->priority);
         }
     }
 
     p->isAsynchronous = (mode != QQmlIncubator::Synchronous);
+    p->startStatistics();
 
     inProgressCreations++;
 
     if (mode == QQmlIncubator::Synchronous) {
         QRecursionWatcher<QQmlIncubatorPrivate, &QQmlIncubatorPrivate::recursion> watcher(p.data());
 
+        p->statistics.forced = true;
         p->changeStatus(QQmlIncubator::Loading);
 
         if (!watcher.hasRecursed()) {
@@ -186,6 +193,12 @@ time on the table in some frames and disturb the application in others.
 controller that spaces out incubation over multiple frames using a more intelligent
 algorithm. You rarely have to write your own.
 
+When several objects are incubating, incubateFor() and incubateWhile() first work on the
+ones that are needed first, such as the items of visible Loaders. The time it
+took to incubate a component before is used to avoid starting on an object that is not
+expected to finish within the remaining time. Timing statistics for each incubation can be
+logged by enabling the \c{qt.qml.incubator.statistics} logging category.
+
 */
 
 /*!
@@ -233,6 +246,7 @@ void QQmlIncubationController::incubatingObjectCountChanged(int incubatingObject
 
 void QQmlIncubatorPrivate::forceCompletion(QQmlInstantiationInterrupt &i)
 {
+    statistics.forced = true;
     while (QQmlIncubator::Loading == status) {
         while (QQmlIncubator::Loading == status && !waitingFor.isEmpty())
             waitingFor.first()->forceCompletion(i);
@@ -330,10 +344,13 @@ void QQmlIncubatorPrivate::incubate(QQmlInstantiationInterrupt &i)
         if (watcher.hasRecursed())
             return;
 
-        if (errors.isEmpty())
+        if (errors.isEmpty()) {
             progress = QQmlIncubatorPrivate::Completing;
-        else
+            statistics.objectCount = creator->allCreatedObjects().count();
+            finalizeWork = creator->pendingFinalizeWork();
+        } else {
             progress = QQmlIncubatorPrivate::Completed;
+        }
 
         changeStatus(calculateStatus());
 
@@ -359,6 +376,9 @@ void QQmlIncubatorPrivate::incubate(QQmlInstantiationInterrupt &i)
 
 finishIncubate:
     if (progress == QQmlIncubatorPrivate::Completed && waitingFor.isEmpty()) {
+        if (errors.isEmpty())
+            finishStatistics(enginePriv);
+
         QExplicitlySharedDataPointer<QQmlIncubatorPrivate> isWaiting = waitingOnMe;
         clear();
 
@@ -413,6 +433,142 @@ void QQmlIncubatorPrivate::incubateCppBasedComponent(QQmlComponent *component, Q
 
 }
 
+void QQmlIncubatorPrivate::setPriority(int priority)
+{
+    this->priority = priority;
+    for (QQmlIncubatorPrivate *nested : waitingFor) {
+        if (nested->priority < priority)
+            nested->setPriority(priority);
+    }
+}
+
+/*!
+    \internal
+    Looks up how long incubating the same component took before, so that the time
+    per object can be predicted.
+ */
+void QQmlIncubatorPrivate::startStatistics()
+{
+    statistics = Statistics();
+    finalizeWork = 0;
+    costKey = compilationUnit->finalUrlString() + QLatin1Char('#')
+            + QString::number(subComponentToCreate);
+
+    const auto it = enginePriv->incubationCosts.constFind(costKey);
+    if (it != enginePriv->incubationCosts.constEnd()) {
+        statistics.predictedNSecs = it->nsecs;
+        statistics.predictedObjectCount = it->objectCount;
+    }
+}
+
+void QQmlIncubatorPrivate::finishStatistics(QQmlEnginePrivate *engine)
+{
+    if (costKey.isEmpty())
+        return;
+
+    // The current slice is still running if we complete inside of it.
+    const qint64 elapsed = statistics.elapsedNSecs
+            + (sliceTimer.isValid() ? sliceTimer.nsecsElapsed() : 0);
+
+    qCDebug(lcIncubatorStats) << costKey
+                              << "priority:" << priority
+                              << "elapsed (ms):" << elapsed / 1000000.0
+                              << "slices:" << statistics.slices
+                              << "objects:" << statistics.objectCount
+                              << "predicted (ms):" << statistics.predictedNSecs / 1000000.0
+                              << "forced:" << statistics.forced;
+
+    // Forced completion is not representative of the time spent in slices.
+    if (statistics.forced || statistics.objectCount == 0)
+        return;
+
+    QQmlEnginePrivate::IncubationCost &cost = engine->incubationCosts[costKey];
+    if (cost.objectCount == 0) {
+        cost.nsecs = elapsed;
+        cost.objectCount = statistics.objectCount;
+    } else {
+        // Average over the last few runs, so that outliers don't dominate.
+        cost.nsecs = (3 * cost.nsecs + elapsed) / 4;
+        cost.objectCount = (3 * cost.objectCount + statistics.objectCount + 2) / 4;
+    }
+}
+
+qreal QQmlIncubatorPrivate::completedFraction() const
+{
+    if (status == QQmlIncubator::Ready)
+        return 1;
+    if (status != QQmlIncubator::Loading || !creator)
+        return 0;
+
+    switch (progress) {
+    case Execute: {
+        const int expected = statistics.predictedObjectCount > 0
+                ? statistics.predictedObjectCount
+                : compilationUnit->totalObjectCount();
+        if (expected <= 0)
+            return 0;
+        const int created = creator->allCreatedObjects().count();
+        return 0.5 * std::min(qreal(1), qreal(created) / expected);
+    }
+    case Completing:
+        if (finalizeWork <= 0)
+            return 0.5;
+        return 0.5 + 0.5 * (1 - qreal(creator->pendingFinalizeWork()) / finalizeWork);
+    case Completed:
+        break;
+    }
+    return 1;
+}
+
+qint64 QQmlIncubatorPrivate::predictedObjectNSecs() const
+{
+    if (statistics.predictedNSecs < 0 || statistics.predictedObjectCount <= 0)
+        return -1;
+    return statistics.predictedNSecs / statistics.predictedObjectCount;
+}
+
+/*!
+    \internal
+    Runs the incubators of the controller's engine until \a i interrupts, highest priority
+    first. Of incubators with the same priority, the most recently started one is run. Once
+    some work has been done, an incubator whose objects are predicted to take longer than
+    the remaining time is left for the next slice.
+ */
+void QQmlIncubatorPrivate::incubateScheduled(
+        QQmlIncubationController *controller, QQmlInstantiationInterrupt &i)
+{
+    bool didWork = false;
+    do {
+        QQmlIncubatorPrivate *next = nullptr;
+        for (QIPBase *base : controller->d->incubatorList) {
+            QQmlIncubatorPrivate *incubator = static_cast<QQmlIncubatorPrivate *>(base);
+
+            // Only waiting for nested incubators, which are in the list themselves.
+            if (incubator->progress == Completed)
+                continue;
+
+            if (!next || incubator->priority > next->priority)
+                next = incubator;
+        }
+        if (!next)
+            next = static_cast<QQmlIncubatorPrivate *>(controller->d->incubatorList.first());
+
+        if (didWork) {
+            const qint64 remaining = i.remainingTimeNSecs();
+            if (remaining >= 0 && next->predictedObjectNSecs() > remaining)
+                break;
+        }
+
+        QExplicitlySharedDataPointer<QQmlIncubatorPrivate> protect(next);
+        next->sliceTimer.start();
+        next->incubate(i);
+        next->statistics.elapsedNSecs += next->sliceTimer.nsecsElapsed();
+        next->sliceTimer.invalidate();
+        ++next->statistics.slices;
+        didWork = true;
+    } while (controller->d && controller->d->incubatorCount != 0 && !i.shouldInterrupt());
+}
+
 /*!
 Incubate objects for \a msecs, or until there are no more objects to incubate.
 */
@@ -423,9 +579,7 @@ void QQmlIncubationController::incubateFor(int msecs)
 
     QDeadlineTimer deadline(msecs);
     QQmlInstantiationInterrupt i(deadline);
-    do {
-        static_cast<QQmlIncubatorPrivate*>(d->incubatorList.first())->incubate(i);
-    } while (d && d->incubatorCount != 0 && !i.shouldInterrupt());
+    QQmlIncubatorPrivate::incubateScheduled(this, i);
 }
 
 /*!
@@ -446,9 +600,7 @@ void QQmlIncubationController::incubateWhile(std::atomic<bool> *flag, int msecs)
         return;
 
     QQmlInstantiationInterrupt i(flag, msecs ? QDeadlineTimer(msecs) : QDeadlineTimer::Forever);
-    do {
-        static_cast<QQmlIncubatorPrivate*>(d->incubatorList.first())->incubate(i);
-    } while (d && d->incubatorCount != 0 && !i.shouldInterrupt());
+    QQmlIncubatorPrivate::incubateScheduled(this, i);
 }
 
 /*!
@@ -12,6 +12,7 @@
 #include <private/qqmlengine_p.h>
 #include <private/qqmlguardedcontextdata_p.h>
 
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qpointer.h>
 
 //
@@ -83,6 +84,43 @@ public:
     void incubateCppBasedComponent(QQmlComponent *component, QQmlContext *context);
     RequiredProperties *requiredProperties();
     bool hadTopLevelRequiredProperties() const;
+
+    // Incubators with a higher priority are run first. Nested incubators inherit the priority
+    // of the incubators waiting on them.
+    enum Priority { LowPriority = -1, NormalPriority = 0, HighPriority = 1 };
+    int priority = NormalPriority;
+    void setPriority(int priority);
+
+    struct Statistics
+    {
+        // Time spent in incubation slices given by the incubation controller.
+        qint64 elapsedNSecs = 0;
+        int slices = 0;
+
+        // Number of objects created, once all of them are.
+        int objectCount = 0;
+
+        // As measured for earlier incubations of the same component, or -1 if there were none.
+        qint64 predictedNSecs = -1;
+        int predictedObjectCount = -1;
+
+        // Completed by forceCompletion() or synchronously. Not used for predictions then.
+        bool forced = false;
+    };
+    Statistics statistics;
+
+    // Between 0 and 1. Creating the objects is the first half, finalizing them the second one.
+    qreal completedFraction() const;
+    qint64 predictedObjectNSecs() const;
+
+    static void incubateScheduled(QQmlIncubationController *controller,
+                                  QQmlInstantiationInterrupt &i);
+
+    void startStatistics();
+    void finishStatistics(QQmlEnginePrivate *engine);
+    QString costKey;
+    QElapsedTimer sliceTimer;
+    int finalizeWork = 0;
 };
 
 QT_END_NAMESPACE
@@ -354,6 +354,14 @@ void QQmlObjectCreator::setPropertyValue(const QQmlPropertyData *property, const
         }
     }
 
+    // Parsed already when the bindings were validated.
+    if (const QVariant *prepared = compilationUnit->literalBindingValue(binding);
+            prepared && prepared->metaType() == propertyType) {
+        QVariant value = *prepared;
+        property->writeProperty(_qobject, value.data(), propertyWriteFlags);
+        return;
+    }
+
     switch (propertyType.id()) {
     case QMetaType::QVariant: {
         if (binding->type() == QV4::CompiledData::Binding::Type_Number) {
@@ -166,6 +166,14 @@ public:
     }
     QFiniteStack<QQmlGuard<QObject> > &allCreatedObjects() { return sharedState->allCreatedObjects; }
 
+    // The bindings and parser status callbacks finalize() still has to process.
+    int pendingFinalizeWork() const
+    {
+        return sharedState->allCreatedBindings.count()
+                + int(sharedState->allQPropertyBindings.size())
+                + sharedState->allParserStatusCallbacks.count();
+    }
+
     RequiredProperties *requiredProperties() {return &sharedState->requiredProperties;}
     bool componentHadTopLevelRequiredProperties() const {return sharedState->hadTopLevelRequiredProperties;}
 
@@ -0,0 +1,417 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qqmlpersistentimportcache_p.h"
+
+#include <QtQml/qqmlfile.h>
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qset.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qtimezone.h>
+#if QT_CONFIG(temporaryfile)
+#include <QtCore/qsavefile.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+Q_STATIC_LOGGING_CATEGORY(lcImportCacheStats, "qt.qml.importcache.statistics")
+
+// Increase whenever the meaning or layout of the entries changes.
+static const quint32 ImportCacheMagic = 0x716d6c69; // "qmli"
+static const quint32 ImportCacheFormatVersion = 2;
+
+static bool isResourcePath(const QString &path)
+{
+    if (path.startsWith(QLatin1Char(':')))
+        return true;
+#if defined(Q_OS_ANDROID)
+    if (path.startsWith(QLatin1String("assets:/")) || path.startsWith(QLatin1String("content:/")))
+        return true;
+#endif
+    return false;
+}
+
+static QString localPath(const QString &path)
+{
+    return QQmlFile::isLocalFile(path) ? QQmlFile::urlToLocalFileOrQrc(path) : path;
+}
+
+static QString directoryOf(const QString &path)
+{
+    const qsizetype lastSlash = path.lastIndexOf(QLatin1Char('/'));
+    return lastSlash > 0 ? path.left(lastSlash) : QString();
+}
+
+static QString joinKey(std::initializer_list<QString> parts, const QStringList &paths)
+{
+    QString key;
+    for (const QString &part : parts) {
+        key += part;
+        key += QLatin1Char('\n');
+    }
+    key += paths.join(QLatin1Char('\n'));
+    return key;
+}
+
+QQmlPersistentImportCache::QQmlPersistentImportCache(const QString &fileName, int mode)
+    : m_fileName(fileName), m_mode(mode)
+{
+}
+
+QQmlPersistentImportCache::~QQmlPersistentImportCache()
+{
+    if (m_dirty && (m_mode & Write)) {
+        QString errorString;
+        if (!save(&errorString)) {
+            qCDebug(lcImportCacheStats) << "Cannot write import cache" << m_fileName
+                                        << errorString;
+        }
+    }
+
+    if (!m_hits && !m_misses)
+        return;
+    qCDebug(lcImportCacheStats) << "Hits:" << m_hits
+                                << "misses:" << m_misses
+                                << "outdated:" << m_outdated;
+}
+
+QString QQmlPersistentImportCache::defaultFileName()
+{
+    const QString envCachePath = qEnvironmentVariable("QML_DISK_CACHE_PATH");
+    const QString directory = envCachePath.isEmpty()
+            ? QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                    + QLatin1String("/qmlcache/")
+            : envCachePath + QLatin1String("/");
+    return directory + QLatin1String("imports.qmlic");
+}
+
+std::optional<QList<QQmlPersistentImportCache::QmldirLocation>>
+QQmlPersistentImportCache::qmldirLocations(
+        const QString &uri, QTypeRevision version, const QStringList &importPaths)
+{
+    const QString key = joinKey(
+            { uri, QString::number(version.toEncodedVersion<quint16>()) }, importPaths);
+
+    QMutexLocker locker(&m_mutex);
+    const std::optional<QStringList> values = lookup(m_qmldirLocations, key);
+    if (!values)
+        return std::nullopt;
+
+    QList<QmldirLocation> locations;
+    for (qsizetype i = 0, end = values->size() - 1; i < end; i += 2)
+        locations.append({ values->at(i), values->at(i + 1) });
+    return locations;
+}
+
+void QQmlPersistentImportCache::insertQmldirLocations(
+        const QString &uri, QTypeRevision version, const QStringList &importPaths,
+        const QList<QmldirLocation> &locations, const QStringList &probedFiles)
+{
+    const QString key = joinKey(
+            { uri, QString::number(version.toEncodedVersion<quint16>()) }, importPaths);
+
+    QStringList values;
+    values.reserve(locations.size() * 2);
+    for (const QmldirLocation &location : locations)
+        values << location.filePath << location.url;
+
+    QMutexLocker locker(&m_mutex);
+    insert(&m_qmldirLocations, key, values, directoryStamps(probedFiles));
+}
+
+std::optional<QString> QQmlPersistentImportCache::qmldirContent(const QString &filePath)
+{
+    // Resources are cheap to read, and we cannot tell whether they have changed.
+    if (isResourcePath(filePath))
+        return std::nullopt;
+
+    QMutexLocker locker(&m_mutex);
+    const std::optional<QStringList> values = lookup(m_qmldirContents, filePath);
+    if (!values || values->size() != 1)
+        return std::nullopt;
+    return values->first();
+}
+
+void QQmlPersistentImportCache::insertQmldirContent(
+        const QString &filePath, const QString &content)
+{
+    if (isResourcePath(filePath))
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    const qint64 modified = modificationTime(filePath);
+    if (modified < 0)
+        return;
+    insert(&m_qmldirContents, filePath, { content }, { Stamp { filePath, modified } });
+}
+
+std::optional<QString> QQmlPersistentImportCache::pluginPath(
+        const QString &qmldirPath, const QString &qmldirPluginPath, const QString &baseName,
+        const QStringList &pluginPaths)
+{
+    const QString key = joinKey({ qmldirPath, qmldirPluginPath, baseName }, pluginPaths);
+
+    QMutexLocker locker(&m_mutex);
+    const std::optional<QStringList> values = lookup(m_pluginPaths, key);
+    if (!values || values->size() != 1)
+        return std::nullopt;
+    return values->first();
+}
+
+void QQmlPersistentImportCache::insertPluginPath(
+        const QString &qmldirPath, const QString &qmldirPluginPath, const QString &baseName,
+        const QStringList &pluginPaths, const QString &resolvedPath,
+        const QStringList &probedFiles)
+{
+    const QString key = joinKey({ qmldirPath, qmldirPluginPath, baseName }, pluginPaths);
+
+    QMutexLocker locker(&m_mutex);
+    insert(&m_pluginPaths, key, { resolvedPath }, directoryStamps(probedFiles));
+}
+
+void QQmlPersistentImportCache::clearModificationTimes()
+{
+    QMutexLocker locker(&m_mutex);
+    m_modificationTimes.clear();
+}
+
+void QQmlPersistentImportCache::setResourceTimeStamp(qint64 modified)
+{
+    QMutexLocker locker(&m_mutex);
+    m_resourceTimeStamp = modified;
+    m_modificationTimes.clear();
+}
+
+int QQmlPersistentImportCache::hits() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+int QQmlPersistentImportCache::misses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+int QQmlPersistentImportCache::outdated() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_outdated;
+}
+
+std::optional<QStringList> QQmlPersistentImportCache::lookup(
+        const Table &table, const QString &key)
+{
+    ensureLoaded();
+
+    const auto it = table.constFind(key);
+    if (it == table.constEnd()) {
+        ++m_misses;
+        return std::nullopt;
+    }
+
+    for (const Stamp &stamp : it->stamps) {
+        if (modificationTime(stamp.path) != stamp.modified) {
+            ++m_outdated;
+            return std::nullopt;
+        }
+    }
+
+    ++m_hits;
+    return it->values;
+}
+
+void QQmlPersistentImportCache::insert(
+        Table *table, const QString &key, const QStringList &values, const QList<Stamp> &stamps)
+{
+    if (!(m_mode & Write))
+        return;
+
+    ensureLoaded();
+    table->insert(key, Entry { values, stamps });
+    m_dirty = true;
+}
+
+void QQmlPersistentImportCache::ensureLoaded()
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    if (!(m_mode & Read))
+        return;
+
+    QString errorString;
+    if (!load(&errorString)) {
+        m_qmldirLocations.clear();
+        m_qmldirContents.clear();
+        m_pluginPaths.clear();
+        qCDebug(lcImportCacheStats) << "Cannot read import cache" << m_fileName << errorString;
+    }
+}
+
+bool QQmlPersistentImportCache::load(QString *errorString)
+{
+    QFile file(m_fileName);
+    if (!file.exists())
+        return true;
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 formatVersion = 0;
+    quint32 qtVersion = 0;
+    stream >> magic >> formatVersion >> qtVersion;
+    if (magic != ImportCacheMagic) {
+        *errorString = QStringLiteral("Magic bytes do not match");
+        return false;
+    }
+
+    if (formatVersion != ImportCacheFormatVersion || qtVersion != quint32(QT_VERSION)) {
+        *errorString = QStringLiteral("Version mismatch");
+        return false;
+    }
+
+    if (!readTable(stream, &m_qmldirLocations) || !readTable(stream, &m_qmldirContents)
+            || !readTable(stream, &m_pluginPaths)) {
+        *errorString = QStringLiteral("Potential file corruption");
+        return false;
+    }
+
+    return true;
+}
+
+bool QQmlPersistentImportCache::save(QString *errorString)
+{
+#if QT_CONFIG(temporaryfile)
+    QMutexLocker locker(&m_mutex);
+
+    QDir::root().mkpath(QFileInfo(m_fileName).absolutePath());
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << ImportCacheMagic << ImportCacheFormatVersion << quint32(QT_VERSION);
+    writeTable(stream, m_qmldirLocations);
+    writeTable(stream, m_qmldirContents);
+    writeTable(stream, m_pluginPaths);
+
+    if (!file.commit()) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+#else
+    *errorString = QStringLiteral("features.temporaryfile is disabled.");
+    return false;
+#endif
+}
+
+void QQmlPersistentImportCache::writeTable(QDataStream &stream, const Table &table)
+{
+    stream << quint32(table.size());
+    for (auto it = table.constBegin(), end = table.constEnd(); it != end; ++it) {
+        stream << it.key() << it->values << quint32(it->stamps.size());
+        for (const Stamp &stamp : it->stamps)
+            stream << stamp.path << stamp.modified;
+    }
+}
+
+bool QQmlPersistentImportCache::readTable(QDataStream &stream, Table *table)
+{
+    quint32 size = 0;
+    stream >> size;
+    for (quint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i) {
+        QString key;
+        Entry entry;
+        quint32 stampCount = 0;
+        stream >> key >> entry.values >> stampCount;
+        for (quint32 j = 0; j < stampCount && stream.status() == QDataStream::Ok; ++j) {
+            Stamp stamp;
+            stream >> stamp.path >> stamp.modified;
+            entry.stamps.append(stamp);
+        }
+        table->insert(key, entry);
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+qint64 QQmlPersistentImportCache::modificationTime(const QString &path)
+{
+    const auto it = m_modificationTimes.constFind(path);
+    if (it != m_modificationTimes.constEnd())
+        return *it;
+
+    const QFileInfo info(path);
+    qint64 modified = -1;
+    if (info.exists()) {
+        modified = isResourcePath(path)
+                ? resourceTimeStamp()
+                : info.lastModified(QTimeZone::UTC).toMSecsSinceEpoch();
+    }
+    m_modificationTimes.insert(path, modified);
+    return modified;
+}
+
+qint64 QQmlPersistentImportCache::resourceTimeStamp()
+{
+    // Resources don't change while the application runs, but they do with each new build of it.
+    // Fall back to the application executable, like the QML disk cache does.
+    if (m_resourceTimeStamp < 0) {
+        const QDateTime modified = QFileInfo(QCoreApplication::applicationFilePath())
+                                           .lastModified(QTimeZone::UTC);
+        m_resourceTimeStamp = modified.isValid() ? modified.toMSecsSinceEpoch() : 0;
+    }
+    return m_resourceTimeStamp;
+}
+
+/*!
+    \internal
+
+    Returns the stamps for the directories of \a probedFiles. A file can only appear in, or
+    disappear from, a directory by changing the directory's modification time. If a directory
+    does not exist, its parents are stamped, up to the first one that exists, because creating
+    the directory would change that one.
+*/
+QList<QQmlPersistentImportCache::Stamp> QQmlPersistentImportCache::directoryStamps(
+        const QStringList &probedFiles)
+{
+    QList<Stamp> stamps;
+    QSet<QString> seen;
+    for (const QString &file : probedFiles) {
+        for (QString directory = directoryOf(localPath(file)); !directory.isEmpty();
+             directory = directoryOf(directory)) {
+            if (seen.contains(directory))
+                break;
+            seen.insert(directory);
+
+            const qint64 modified = modificationTime(directory);
+            stamps.append({ directory, modified });
+            if (modified >= 0)
+                break;
+        }
+    }
+    return stamps;
+}
+
+QT_END_NAMESPACE
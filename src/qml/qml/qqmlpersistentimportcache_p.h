@@ -0,0 +1,145 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQMLPERSISTENTIMPORTCACHE_P_H
+#define QQMLPERSISTENTIMPORTCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qtqmlglobal_p.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qversionnumber.h>
+
+#include <optional>
+
+QT_BEGIN_NAMESPACE
+
+class QDataStream;
+
+// Remembers the results of import resolution across application runs: where the qmldir files
+// of modules are found, what they contain, and where their plugins are. Each entry records the
+// modification times of the files and directories its result depends on, and is only used as
+// long as they are unchanged. Modification times are checked at most once per path and run.
+//
+// The cache is read from and written to a single file next to the QML disk cache files.
+class Q_QML_EXPORT QQmlPersistentImportCache
+{
+    Q_DISABLE_COPY_MOVE(QQmlPersistentImportCache)
+public:
+    struct QmldirLocation
+    {
+        QString filePath;
+        QString url;
+    };
+
+    enum Mode {
+        Read  = 1 << 0,
+        Write = 1 << 1,
+        ReadWrite = Read | Write
+    };
+
+    QQmlPersistentImportCache(const QString &fileName, int mode);
+
+    // Saves the cache if anything was added and writing is enabled.
+    ~QQmlPersistentImportCache();
+
+    // The file in the QML disk cache directory, as given by QML_DISK_CACHE_PATH or
+    // QStandardPaths::CacheLocation.
+    static QString defaultFileName();
+
+    // Returns the qmldir files found for the module, in the order of the import paths. An empty
+    // list means the module was not found. std::nullopt means the cache doesn't know.
+    std::optional<QList<QmldirLocation>> qmldirLocations(
+            const QString &uri, QTypeRevision version, const QStringList &importPaths);
+    void insertQmldirLocations(
+            const QString &uri, QTypeRevision version, const QStringList &importPaths,
+            const QList<QmldirLocation> &locations, const QStringList &probedFiles);
+
+    std::optional<QString> qmldirContent(const QString &filePath);
+    void insertQmldirContent(const QString &filePath, const QString &content);
+
+    // An empty string means the plugin was not found.
+    std::optional<QString> pluginPath(
+            const QString &qmldirPath, const QString &qmldirPluginPath, const QString &baseName,
+            const QStringList &pluginPaths);
+    void insertPluginPath(
+            const QString &qmldirPath, const QString &qmldirPluginPath, const QString &baseName,
+            const QStringList &pluginPaths, const QString &resolvedPath,
+            const QStringList &probedFiles);
+
+    // Forget the modification times checked so far, for example because files are expected to
+    // have changed while the application is running.
+    void clearModificationTimes();
+
+    // Files from the resource system have no modification times. They are stamped with the
+    // modification time of the application executable, unless another one is set here.
+    void setResourceTimeStamp(qint64 modified);
+
+    int hits() const;
+    int misses() const;
+    int outdated() const;
+
+    bool save(QString *errorString);
+
+private:
+    struct Stamp
+    {
+        QString path;
+        qint64 modified = -1;
+    };
+
+    struct Entry
+    {
+        QStringList values;
+        QList<Stamp> stamps;
+    };
+
+    using Table = QHash<QString, Entry>;
+
+    std::optional<QStringList> lookup(const Table &table, const QString &key);
+    void insert(Table *table, const QString &key, const QStringList &values,
+                const QList<Stamp> &stamps);
+
+    void ensureLoaded();
+    bool load(QString *errorString);
+    qint64 modificationTime(const QString &path);
+    qint64 resourceTimeStamp();
+    QList<Stamp> directoryStamps(const QStringList &probedFiles);
+
+    static void writeTable(QDataStream &stream, const Table &table);
+    static bool readTable(QDataStream &stream, Table *table);
+
+    mutable QMutex m_mutex;
+    QString m_fileName;
+    int m_mode = 0;
+    bool m_loaded = false;
+    bool m_dirty = false;
+
+    Table m_qmldirLocations;
+    Table m_qmldirContents;
+    Table m_pluginPaths;
+
+    // Modification times of files and directories, as checked in this run. -1 for missing ones.
+    QHash<QString, qint64> m_modificationTimes;
+    qint64 m_resourceTimeStamp = -1;
+
+    int m_hits = 0;
+    int m_misses = 0;
+    int m_outdated = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLPERSISTENTIMPORTCACHE_P_H
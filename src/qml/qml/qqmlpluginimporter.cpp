@@ -388,6 +388,25 @@ QString QQmlPluginImporter::resolvePlugin(const QString &qmldirPluginPath, const
     };
 #endif
 
+    QQmlPersistentImportCache *persistentCache = typeLoader->persistentImportCache();
+    if (persistentCache) {
+        if (const auto cached = persistentCache->pluginPath(
+                    qmldirPath, qmldirPluginPath, baseName, database->filePluginPath)) {
+            return *cached;
+        }
+    }
+
+    // The directories searched so far. Together they determine the result.
+    QStringList probedPaths;
+    const auto resolved = [&](const QString &absolutePath) {
+        if (persistentCache) {
+            persistentCache->insertPluginPath(
+                    qmldirPath, qmldirPluginPath, baseName, database->filePluginPath,
+                    absolutePath, probedPaths);
+        }
+        return absolutePath;
+    };
+
     QStringList searchPaths = database->filePluginPath;
     bool qmldirPluginPathIsRelative = QDir::isRelativePath(qmldirPluginPath);
     if (!qmldirPluginPathIsRelative)
@@ -417,10 +436,11 @@ QString QQmlPluginImporter::resolvePlugin(const QString &qmldirPluginPath, const
             resolvedBasePath += u'/';
 
         QString resolvedPath = resolvedBasePath + prefix + baseName;
+        probedPaths.append(resolvedPath);
         for (const QString &suffix : suffixes) {
             QString absolutePath = typeLoader->absoluteFilePath(resolvedPath + suffix);
             if (!absolutePath.isEmpty())
-                return absolutePath;
+                return resolved(absolutePath);
         }
 
 #if defined(Q_OS_ANDROID)
@@ -440,7 +460,7 @@ QString QQmlPluginImporter::resolvePlugin(const QString &qmldirPluginPath, const
                              "QML plugin in qmldir file, that matches the name of plugin "
                              "on file system. The correct plugin name is '%s'.",
                              qPrintable(pluginName));
-                    return absolutePath;
+                    return resolved(absolutePath);
                 }
             }
         }
@@ -451,7 +471,7 @@ QString QQmlPluginImporter::resolvePlugin(const QString &qmldirPluginPath, const
                          << baseName << "in" << qmldirPath
                          << " file does not exist";
 
-    return QString();
+    return resolved(QString());
 }
 
 /*
@@ -42,7 +42,10 @@ QQmlPropertyValidator::QQmlPropertyValidator(QQmlEnginePrivate *enginePrivate, c
 
 QVector<QQmlError> QQmlPropertyValidator::validate()
 {
-    return validateObject(/*root object*/0, /*instantiatingBinding*/nullptr);
+    QVector<QQmlError> errors = validateObject(/*root object*/0, /*instantiatingBinding*/nullptr);
+    if (errors.isEmpty())
+        compilationUnit->setLiteralBindingValues(std::move(literalBindingValues));
+    return errors;
 }
 
 typedef QVarLengthArray<const QV4::CompiledData::Binding *, 8> GroupPropertyVector;
@@ -412,6 +415,11 @@ QQmlError QQmlPropertyValidator::validateLiteralBinding(
         return bindingType == QV4::CompiledData::Binding::Type_String;
     };
 
+    // Keep the parsed value, so that QQmlObjectCreator doesn't have to parse it again.
+    const auto prepare = [&](const QVariant &value) {
+        literalBindingValues.insert(binding, value);
+    };
+
     switch (property->propType().id()) {
     case QMetaType::QVariant:
     break;
@@ -468,94 +476,120 @@ QQmlError QQmlPropertyValidator::validateLiteralBinding(
     break;
     case QMetaType::QColor: {
         bool ok = false;
-        if (isStringBinding())
-            QQmlStringConverters::rgbaFromString(compilationUnit->bindingValueAsString(binding), &ok);
+        QString string;
+        if (isStringBinding()) {
+            string = compilationUnit->bindingValueAsString(binding);
+            QQmlStringConverters::rgbaFromString(string, &ok);
+        }
         if (!ok) {
             return warnOrError(tr("Invalid property assignment: color expected"));
         }
+
+        // QColor is only known to QtGui.
+        const QVariant value = QQmlValueTypeProvider::createValueType(string, property->propType());
+        if (value.isValid())
+            prepare(value);
     }
     break;
 #if QT_CONFIG(datestring)
     case QMetaType::QDate: {
         bool ok = false;
+        QDate value;
         if (isStringBinding())
-            QQmlStringConverters::dateFromString(compilationUnit->bindingValueAsString(binding), &ok);
+            value = QQmlStringConverters::dateFromString(compilationUnit->bindingValueAsString(binding), &ok);
         if (!ok) {
             return warnOrError(tr("Invalid property assignment: date expected"));
         }
+        prepare(QVariant::fromValue(value));
     }
     break;
     case QMetaType::QTime: {
         bool ok = false;
+        QTime value;
         if (isStringBinding())
-            QQmlStringConverters::timeFromString(compilationUnit->bindingValueAsString(binding), &ok);
+            value = QQmlStringConverters::timeFromString(compilationUnit->bindingValueAsString(binding), &ok);
         if (!ok) {
             return warnOrError(tr("Invalid property assignment: time expected"));
         }
+        prepare(QVariant::fromValue(value));
     }
     break;
     case QMetaType::QDateTime: {
         bool ok = false;
+        QDateTime value;
         if (isStringBinding())
-            QQmlStringConverters::dateTimeFromString(compilationUnit->bindingValueAsString(binding), &ok);
+            value = QQmlStringConverters::dateTimeFromString(compilationUnit->bindingValueAsString(binding), &ok);
         if (!ok) {
             return warnOrError(tr("Invalid property assignment: datetime expected"));
         }
+        prepare(QVariant::fromValue(value));
     }
     break;
 #endif // datestring
     case QMetaType::QPoint: {
         bool ok = false;
+        QPointF value;
         if (isStringBinding())
-            QQmlStringConverters::pointFFromString(compilationUnit->bindingValueAsString(binding), &ok);
+            value = QQmlStringConverters::pointFFromString(compilationUnit->bindingValueAsString(binding), &ok);
         if (!ok) {
             return warnOrError(tr("Invalid property assignment: point expected"));
         }
+        prepare(QVariant::fromValue(value.toPoint()));
     }
     break;
     case QMetaType::QPointF: {
         bool ok = false;
+        QPointF value;
         if (isStringBinding())
-            QQmlStringConverters::pointFFromString(compilationUnit->bindingValueAsString(binding), &ok);
+            value = QQmlStringConverters::pointFFromString(compilationUnit->bindingValueAsString(binding), &ok);
         if (!ok) {
             return warnOrError(tr("Invalid property assignment: point expected"));
         }
+        prepare(QVariant::fromValue(value));
     }
     break;
     case QMetaType::QSize: {
         bool ok = false;
+        QSizeF value;
         if (isStringBinding())
-            QQmlStringConverters::sizeFFromString(compilationUnit->bindingValueAsString(binding), &ok);
+            value = QQmlStringConverters::sizeFFromString(compilationUnit->bindingValueAsString(binding), &ok);
         if (!ok) {
             return warnOrError(tr("Invalid property assignment: size expected"));
         }
+        prepare(QVariant::fromValue(value.toSize()));
     }
     break;
     case QMetaType::QSizeF: {
         bool ok = false;
+        QSizeF value;
         if (isStringBinding())
-            QQmlStringConverters::sizeFFromString(compilationUnit->bindingValueAsString(binding), &ok);
+            value = QQmlStringConverters::sizeFFromString(compilationUnit->bindingValueAsString(binding), &ok);
         if (!ok) {
             return warnOrError(tr("Invalid property assignment: size expected"));
         }
+        prepare(QVariant::fromValue(value));
     }
     break;
     case QMetaType::QRect: {
         bool ok = false;
+        QRectF value;
         if (isStringBinding())
-            QQmlStringConverters::rectFFromString(compilationUnit->bindingValueAsString(binding), &ok);
+            value = QQmlStringConverters::rectFFromString(compilationUnit->bindingValueAsString(binding), &ok);
         if (!ok) {
             return warnOrError(tr("Invalid property assignment: rect expected"));
         }
+        prepare(QVariant::fromValue(value.toRect()));
     }
     break;
     case QMetaType::QRectF: {
         bool ok = false;
+        QRectF value;
         if (isStringBinding())
-            QQmlStringConverters::rectFFromString(compilationUnit->bindingValueAsString(binding), &ok);
+            value = QQmlStringConverters::rectFFromString(compilationUnit->bindingValueAsString(binding), &ok);
         if (!ok) {
             return warnOrError(tr("Invalid property assignment: point expected"));
         }
+        prepare(QVariant::fromValue(value));
     }
     break;
     case QMetaType::Bool: {
@@ -584,6 +618,7 @@ QQmlError QQmlPropertyValidator::validateLiteralBinding(
             return warnOrError(tr("Invalid property assignment: %1 expected")
                                .arg(typeName()));
         }
+        prepare(result);
     }
     break;
     case QMetaType::QRegularExpression:
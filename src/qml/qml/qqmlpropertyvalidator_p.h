@@ -66,6 +66,8 @@ private:
     const QQmlPropertyCacheVector &propertyCaches;
 
     QVector<QV4::CompiledData::BindingPropertyData> * const bindingPropertyDataPerObject;
+
+    mutable QV4::CompiledData::CompilationUnit::LiteralBindingValues literalBindingValues;
 };
 
 QT_END_NAMESPACE
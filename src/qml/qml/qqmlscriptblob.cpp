@@ -12,6 +12,8 @@
 
 #include <QtCore/qloggingcategory.h>
 
+#include <utility>
+
 QT_BEGIN_NAMESPACE
 
 Q_LOGGING_CATEGORY(DBG_DISK_CACHE, "qt.qml.diskcache")
@@ -64,46 +66,62 @@ void QQmlScriptBlob::dataReceived(const SourceCodeData &data)
         return;
     }
 
+    m_source = data;
+    m_isDebugging = isDebugging();
+    if (typeLoader()->parseInParallel(this))
+        return;
+
+    parseSource();
+    sourceParsed();
+}
+
+void QQmlScriptBlob::parseSource()
+{
     QString error;
-    QString source = data.readAll(&error);
+    QString source = m_source.readAll(&error);
     if (!error.isEmpty()) {
-        setError(error);
+        QQmlError e;
+        e.setUrl(url());
+        e.setDescription(error);
+        m_parseErrors << e;
         return;
     }
 
-    QQmlRefPointer<QV4::CompiledData::CompilationUnit> unit;
-
     if (m_isModule) {
         QList<QQmlJS::DiagnosticMessage> diagnostics;
-        unit = QV4::Compiler::Codegen::compileModule(isDebugging(), urlString(), source,
-                                                     data.sourceTimeStamp(), &diagnostics);
-        QList<QQmlError> errors = QQmlEnginePrivate::qmlErrorFromDiagnostics(urlString(), diagnostics);
-        if (!errors.isEmpty()) {
-            setError(errors);
-            return;
-        }
+        m_parsedUnit = QV4::Compiler::Codegen::compileModule(
+                m_isDebugging, urlString(), source, m_source.sourceTimeStamp(), &diagnostics);
+        m_parseErrors = QQmlEnginePrivate::qmlErrorFromDiagnostics(urlString(), diagnostics);
     } else {
-        QmlIR::Document irUnit(isDebugging());
+        QmlIR::Document irUnit(m_isDebugging);
 
-        irUnit.jsModule.sourceTimeStamp = data.sourceTimeStamp();
+        irUnit.jsModule.sourceTimeStamp = m_source.sourceTimeStamp();
 
         QmlIR::ScriptDirectivesCollector collector(&irUnit);
         irUnit.jsParserEngine.setDirectives(&collector);
 
-        QList<QQmlError> errors;
         irUnit.javaScriptCompilationUnit = QV4::Script::precompile(
                      &irUnit.jsModule, &irUnit.jsParserEngine, &irUnit.jsGenerator, urlString(), finalUrlString(),
-                     source, &errors, QV4::Compiler::ContextType::ScriptImportedByQML);
+                     source, &m_parseErrors, QV4::Compiler::ContextType::ScriptImportedByQML);
 
         source.clear();
-        if (!errors.isEmpty()) {
-            setError(errors);
+        if (!m_parseErrors.isEmpty())
             return;
-        }
 
         QmlIR::QmlUnitGenerator qmlGenerator;
         qmlGenerator.generate(irUnit);
-        unit = std::move(irUnit.javaScriptCompilationUnit);
+        m_parsedUnit = std::move(irUnit.javaScriptCompilationUnit);
+    }
+}
+
+void QQmlScriptBlob::sourceParsed()
+{
+    const SourceCodeData data = std::exchange(m_source, {});
+    QQmlRefPointer<QV4::CompiledData::CompilationUnit> unit = std::exchange(m_parsedUnit, {});
+
+    if (!m_parseErrors.isEmpty()) {
+        setError(std::exchange(m_parseErrors, {}));
+        return;
     }
 
     if (writeCacheFile()) {
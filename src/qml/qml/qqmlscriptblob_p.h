@@ -44,6 +44,8 @@ public:
 protected:
     void dataReceived(const SourceCodeData &) override;
     void initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit) override;
+    void parseSource() override;
+    void sourceParsed() override;
     void done() override;
 
     QString stringAt(int index) const override;
@@ -55,6 +57,12 @@ private:
 
     QList<ScriptReference> m_scripts;
     QQmlRefPointer<QQmlScriptData> m_scriptData;
+
+    // Only valid between dataReceived() and sourceParsed()
+    SourceCodeData m_source;
+    QQmlRefPointer<QV4::CompiledData::CompilationUnit> m_parsedUnit;
+    bool m_isDebugging = false;
+
     const bool m_isModule;
 };
 
@@ -17,6 +17,7 @@
 #include <QtCore/qcryptographichash.h>
 
 #include <memory>
+#include <utility>
 
 QT_BEGIN_NAMESPACE
 
@@ -658,10 +659,13 @@ void QQmlTypeData::dataReceived(const SourceCodeData &data)
         return;
     }
 
-    if (!loadFromSource())
+    m_document.reset(new QmlIR::Document(isDebugging()));
+    m_document->jsModule.sourceTimeStamp = m_backupSourceCode.sourceTimeStamp();
+    if (typeLoader()->parseInParallel(this))
         return;
 
-    continueLoadFromIR();
+    parseSource();
+    sourceParsed();
 }
 
 void QQmlTypeData::initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit)
@@ -687,31 +691,50 @@ bool QQmlTypeData::loadFromSource()
 {
     m_document.reset(new QmlIR::Document(isDebugging()));
     m_document->jsModule.sourceTimeStamp = m_backupSourceCode.sourceTimeStamp();
+    parseSource();
+    if (!m_parseErrors.isEmpty()) {
+        setError(std::exchange(m_parseErrors, {}));
+        return false;
+    }
+    return true;
+}
+
+void QQmlTypeData::parseSource()
+{
     QQmlEngine *qmlEngine = typeLoader()->engine();
     QmlIR::IRBuilder compiler(qmlEngine->handle()->illegalNames());
 
     QString sourceError;
     const QString source = m_backupSourceCode.readAll(&sourceError);
     if (!sourceError.isEmpty()) {
-        setError(sourceError);
-        return false;
+        QQmlError e;
+        e.setUrl(url());
+        e.setDescription(sourceError);
+        m_parseErrors << e;
+        return;
     }
 
     if (!compiler.generateFromQml(source, finalUrlString(), m_document.data())) {
-        QList<QQmlError> errors;
-        errors.reserve(compiler.errors.size());
+        m_parseErrors.reserve(compiler.errors.size());
         for (const QQmlJS::DiagnosticMessage &msg : std::as_const(compiler.errors)) {
             QQmlError e;
             e.setUrl(url());
             e.setLine(qmlConvertSourceCoordinate<quint32, int>(msg.loc.startLine));
             e.setColumn(qmlConvertSourceCoordinate<quint32, int>(msg.loc.startColumn));
             e.setDescription(msg.message);
-            errors << e;
+            m_parseErrors << e;
         }
-        setError(errors);
-        return false;
     }
-    return true;
+}
+
+void QQmlTypeData::sourceParsed()
+{
+    if (!m_parseErrors.isEmpty()) {
+        setError(std::exchange(m_parseErrors, {}));
+        return;
+    }
+
+    continueLoadFromIR();
 }
 
 void QQmlTypeData::restoreIR(const QQmlRefPointer<QV4::CompiledData::CompilationUnit> &unit)
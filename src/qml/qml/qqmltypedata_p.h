@@ -79,6 +79,8 @@ protected:
     void dataReceived(const SourceCodeData &) override;
     void initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit) override;
     void allDependenciesDone() override;
+    void parseSource() override;
+    void sourceParsed() override;
     void downloadProgressChanged(qreal) override;
 
     QString stringAt(int index) const override;
@@ -21,7 +21,9 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qdiriterator.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qsemaphore.h>
 #include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
 
 #include <functional>
 
@@ -77,8 +79,22 @@ one of these three preconditions are met.
 \endlist
 
 Thus QQmlDataBlob::done() will always eventually be called, even if the blob has an error set.
+
+Blobs loaded while another blob is being processed can hand the parsing of their source to a
+pool of parser threads, see parseInParallel(). Everything else, including the order in which
+blobs are processed and completed, stays on the load thread.
 */
 
+static int parserThreadCount()
+{
+    static const int count = [] {
+        bool ok = false;
+        const int threads = qEnvironmentVariableIntValue("QML_TYPELOADER_PARSER_THREADS", &ok);
+        return ok ? threads : QThread::idealThreadCount() - 1;
+    }();
+    return count;
+}
+
 void QQmlTypeLoader::invalidate()
 {
     if (m_thread) {
@@ -87,6 +103,12 @@ void QQmlTypeLoader::invalidate()
         m_thread = nullptr;
     }
 
+    // The load thread has drained all parse jobs before shutting down, unless it was
+    // interrupted. Don't leave any parser running on a blob we're about to release.
+    if (m_parserPool)
+        m_parserPool->waitForDone();
+    m_parseJobs.clear();
+
 #if QT_CONFIG(qml_network)
     // Need to delete the network replies after
     // the loader thread is shutdown as it could be
@@ -409,19 +431,19 @@ void QQmlTypeLoader::setData(const QQmlDataBlob::Ptr &blob, const QQmlDataBlob::
     Q_TRACE_SCOPE(QQmlCompiling, blob->url());
     QQmlCompilingProfiler prof(profiler(), blob.data());
 
+    ++m_loadDepth;
     blob->m_inCallback = true;
 
     blob->dataReceived(d);
 
-    if (!blob->isError() && !blob->isWaiting())
-        blob->allDependenciesDone();
-
-    if (blob->status() != QQmlDataBlob::Error)
-        blob->m_data.setStatus(QQmlDataBlob::WaitingForDependencies);
-
-    blob->m_inCallback = false;
+    // If the blob is being parsed, setParsedData() continues where we left off.
+    if (blob->m_isParsing)
+        blob->m_inCallback = false;
+    else
+        finishCallback(blob);
 
-    blob->tryDone();
+    if (--m_loadDepth == 0)
+        finishParsing();
 }
 
 void QQmlTypeLoader::setCachedUnit(const QQmlDataBlob::Ptr &blob, const QQmlPrivate::CachedQmlUnit *unit)
@@ -429,10 +451,32 @@ void QQmlTypeLoader::setCachedUnit(const QQmlDataBlob::Ptr &blob, const QQmlPriv
     Q_TRACE_SCOPE(QQmlCompiling, blob->url());
     QQmlCompilingProfiler prof(profiler(), blob.data());
 
+    ++m_loadDepth;
     blob->m_inCallback = true;
 
     blob->initializeFromCachedUnit(unit);
 
+    finishCallback(blob);
+
+    if (--m_loadDepth == 0)
+        finishParsing();
+}
+
+void QQmlTypeLoader::setParsedData(const QQmlDataBlob::Ptr &blob)
+{
+    Q_TRACE_SCOPE(QQmlCompiling, blob->url());
+    QQmlCompilingProfiler prof(profiler(), blob.data());
+
+    blob->m_isParsing = false;
+    blob->m_inCallback = true;
+
+    blob->sourceParsed();
+
+    finishCallback(blob);
+}
+
+void QQmlTypeLoader::finishCallback(const QQmlDataBlob::Ptr &blob)
+{
     if (!blob->isError() && !blob->isWaiting())
         blob->allDependenciesDone();
 
@@ -444,6 +488,55 @@ void QQmlTypeLoader::setCachedUnit(const QQmlDataBlob::Ptr &blob, const QQmlPriv
     blob->tryDone();
 }
 
+/*!
+Hands the parsing of \a blob's source to a parser thread. Can only be called from within
+QQmlDataBlob::dataReceived(). If this returns \c true, QQmlDataBlob::parseSource() is
+invoked on a parser thread, followed by QQmlDataBlob::sourceParsed() in the load thread.
+Otherwise the blob has to parse its source right away.
+
+Only blobs received while another blob is being processed are parsed in parallel. Those are
+the dependencies of the other blob, and typically there are several of them. The blobs are
+finished in the order they were received, before the outermost load returns. Therefore
+synchronous loading still completes synchronously.
+*/
+bool QQmlTypeLoader::parseInParallel(QQmlDataBlob *blob)
+{
+    ASSERT_LOADTHREAD();
+
+    if (!m_parserPool || m_loadDepth < 2)
+        return false;
+
+    // The URL strings are created lazily. Make sure the parser thread only reads them.
+    blob->urlString();
+    blob->finalUrlString();
+    blob->m_isParsing = true;
+
+    // The job keeps the blob alive, so that it's never released on the parser thread.
+    auto finished = std::make_shared<QSemaphore>();
+    m_parseJobs.append({ QQmlDataBlob::Ptr(blob), finished });
+    ++m_parseJobCount;
+    m_parserPool->start([blob, finished]() {
+        blob->parseSource();
+        finished->release();
+    });
+    return true;
+}
+
+void QQmlTypeLoader::finishParsing()
+{
+    ASSERT_LOADTHREAD();
+
+    // Blobs handed to the parser threads from within setParsedData() are appended and
+    // finished in the same loop.
+    ++m_loadDepth;
+    while (!m_parseJobs.isEmpty()) {
+        const ParseJob job = m_parseJobs.takeFirst();
+        job.finished->acquire();
+        setParsedData(job.blob);
+    }
+    --m_loadDepth;
+}
+
 void QQmlTypeLoader::shutdownThread()
 {
     if (m_thread && !m_thread->isShutdown())
@@ -921,6 +1014,13 @@ QQmlTypeLoader::QQmlTypeLoader(QQmlEngine *engine)
     , m_mutex(m_thread->mutex())
     , m_typeCacheTrimThreshold(TYPELOADER_MINIMUM_TRIM_THRESHOLD)
 {
+    if (const int threads = parserThreadCount(); threads > 0) {
+        m_parserPool = std::make_unique<QThreadPool>();
+        m_parserPool->setMaxThreadCount(threads);
+        // The parsers check their recursion depth against the stack. Give them as much
+        // stack as the load thread has.
+        m_parserPool->setStackSize(8 * 1024 * 1024);
+    }
 }
 
 /*!
@@ -1301,12 +1401,21 @@ const QQmlTypeLoaderQmldirContent QQmlTypeLoader::qmldirContent(const QString &f
 #define NOT_READABLE_ERROR QString(QLatin1String("module \"$$URI$$\" definition \"%1\" not readable"))
 #define CASE_MISMATCH_ERROR QString(QLatin1String("cannot load module \"$$URI$$\": File name case mismatch for \"%1\""))
 
+    QQmlPersistentImportCache *persistentCache = persistentImportCache();
+    std::optional<QString> cachedContent;
+    if (persistentCache)
+        cachedContent = persistentCache->qmldirContent(filePath);
+
     QFile file(filePath);
     if (!QQml_isFileCaseCorrect(filePath)) {
         ERROR(CASE_MISMATCH_ERROR.arg(filePath));
+    } else if (cachedContent) {
+        qmldir->setContent(filePath, *cachedContent);
     } else if (file.open(QFile::ReadOnly)) {
-        QByteArray data = file.readAll();
-        qmldir->setContent(filePath, QString::fromUtf8(data));
+        const QString content = QString::fromUtf8(file.readAll());
+        qmldir->setContent(filePath, content);
+        if (persistentCache)
+            persistentCache->insertQmldirContent(filePath, content);
     } else {
         ERROR(NOT_READABLE_ERROR.arg(filePath));
     }
@@ -1334,6 +1443,31 @@ void QQmlTypeLoader::setQmldirContent(const QString &url, const QString &content
         qmldir->setContent(url, content);
 }
 
+/*!
+Returns the cache of import resolution results that persists across application
+runs, or nullptr if the disk cache is disabled.
+
+The cache is read if cache files may be read, and written when the type loader is
+destroyed if cache files may be written.
+*/
+QQmlPersistentImportCache *QQmlTypeLoader::persistentImportCache()
+{
+    std::call_once(m_persistentImportCacheInit, [this]() {
+        const QV4::ExecutionEngine::DiskCacheOptions options
+                = m_engine->handle()->diskCacheOptions();
+        int mode = 0;
+        if (options & QV4::ExecutionEngine::DiskCache::QmlcRead)
+            mode |= QQmlPersistentImportCache::Read;
+        if (options & QV4::ExecutionEngine::DiskCache::QmlcWrite)
+            mode |= QQmlPersistentImportCache::Write;
+        if (mode) {
+            m_persistentImportCache = std::make_unique<QQmlPersistentImportCache>(
+                    QQmlPersistentImportCache::defaultFileName(), mode);
+        }
+    });
+    return m_persistentImportCache.get();
+}
+
 /*!
 Clears cached information about loaded files, including any type data, scripts
 and qmldir information.
@@ -1354,6 +1488,10 @@ void QQmlTypeLoader::clearCache()
     m_importDirCache.clear();
     m_importQmlDirCache.clear();
     m_checksumCache.clear();
+
+    // Files may have changed since they were last checked.
+    if (m_persistentImportCache)
+        m_persistentImportCache->clearModificationTimes();
 }
 
 void QQmlTypeLoader::updateTypeCacheTrimThreshold()
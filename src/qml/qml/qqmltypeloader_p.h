@@ -27,6 +27,7 @@
 #include <QtCore/qmutex.h>
 
 #include <memory>
+#include <mutex>
 
 QT_BEGIN_NAMESPACE
 
@@ -38,6 +39,8 @@ class QQmlExtensionInterface;
 class QQmlProfiler;
 class QQmlTypeLoaderThread;
 class QQmlEngine;
+class QSemaphore;
+class QThreadPool;
 
 class Q_QML_EXPORT QQmlTypeLoader
 {
@@ -120,6 +123,9 @@ public:
         QVector<PendingImportPtr> m_unresolvedImports;
         QVector<QQmlRefPointer<QQmlQmldirData>> m_qmldirs;
         QQmlMetaType::CachedUnitLookupError m_cachedUnitStatus = QQmlMetaType::CachedUnitLookupError::NoError;
+
+        // Written by parseSource(), reported by sourceParsed()
+        QList<QQmlError> m_parseErrors;
     };
 
     QQmlTypeLoader(QQmlEngine *);
@@ -164,12 +170,17 @@ public:
     const QQmlTypeLoaderQmldirContent qmldirContent(const QString &filePath);
     void setQmldirContent(const QString &filePath, const QString &content);
 
+    QQmlPersistentImportCache *persistentImportCache();
+
     void clearCache();
     void trimCache();
 
     bool isTypeLoaded(const QUrl &url) const;
     bool isScriptLoaded(const QUrl &url) const;
 
+    // The number of blobs that have been handed to the parser threads so far.
+    int parseJobCount() const { return m_parseJobCount; }
+
     void lock() { m_mutex.lock(); }
     void unlock() { m_mutex.unlock(); }
 
@@ -177,6 +188,7 @@ public:
     void loadWithStaticData(const QQmlDataBlob::Ptr &blob, const QByteArray &, Mode = PreferSynchronous);
     void loadWithCachedUnit(const QQmlDataBlob::Ptr &blob, const QQmlPrivate::CachedQmlUnit *unit, Mode mode = PreferSynchronous);
     void drop(const QQmlDataBlob::Ptr &blob);
+    bool parseInParallel(QQmlDataBlob *blob);
 
     QQmlEngine *engine() const;
     void initializeEngine(QQmlEngineExtensionInterface *, const char *);
@@ -215,6 +227,9 @@ private:
     void setData(const QQmlDataBlob::Ptr &, const QString &fileName);
     void setData(const QQmlDataBlob::Ptr &, const QQmlDataBlob::SourceCodeData &);
     void setCachedUnit(const QQmlDataBlob::Ptr &blob, const QQmlPrivate::CachedQmlUnit *unit);
+    void setParsedData(const QQmlDataBlob::Ptr &blob);
+    void finishCallback(const QQmlDataBlob::Ptr &blob);
+    void finishParsing();
 
     typedef QHash<QUrl, QQmlRefPointer<QQmlTypeData>> TypeCache;
     typedef QHash<QUrl, QQmlRefPointer<QQmlScriptBlob>> ScriptCache;
@@ -241,6 +256,23 @@ private:
     ImportQmlDirCache m_importQmlDirCache;
     ChecksumCache m_checksumCache;
 
+    // Created on first use, as the disk cache options are only known once the engine is set up.
+    std::once_flag m_persistentImportCacheInit;
+    std::unique_ptr<QQmlPersistentImportCache> m_persistentImportCache;
+
+    struct ParseJob
+    {
+        QQmlDataBlob::Ptr blob;
+        std::shared_ptr<QSemaphore> finished;
+    };
+
+    // Blobs handed to the parser threads, in the order they were received. They are
+    // finished when the outermost setData() or setCachedUnit() returns.
+    QList<ParseJob> m_parseJobs;
+    std::unique_ptr<QThreadPool> m_parserPool;
+    int m_loadDepth = 0;
+    int m_parseJobCount = 0;
+
     template<typename Loader>
     void doLoad(const Loader &loader, const QQmlDataBlob::Ptr &blob, Mode mode);
     void updateTypeCacheTrimThreshold();
@@ -41,6 +41,7 @@ public:
     inline QQmlInstantiationInterrupt(QDeadlineTimer deadline);
 
     inline bool shouldInterrupt() const;
+    inline qint64 remainingTimeNSecs() const;
 private:
     enum Mode { None, Time, Flag };
     Mode mode;
@@ -112,6 +113,12 @@ bool QQmlInstantiationInterrupt::shouldInterrupt() const
     Q_UNREACHABLE_RETURN(false);
 }
 
+// Returns -1 if there is no deadline.
+qint64 QQmlInstantiationInterrupt::remainingTimeNSecs() const
+{
+    return mode == None ? -1 : deadline.remainingTimeNSecs();
+}
+
 QT_END_NAMESPACE
 
 #endif // QQMLVME_P_H
@@ -26,6 +26,11 @@
 #include <QtCore/qstack.h>
 #include <QtCore/qdebug.h>
 #include <QtCore/qbuffer.h>
+#if QT_CONFIG(future)
+#include <QtCore/qfuture.h>
+#include <QtCore/qpromise.h>
+#include <QtCore/qthreadpool.h>
+#endif
 
 #include <private/qv4objectproto_p.h>
 #include <private/qv4scopedvalue_p.h>
@@ -45,6 +50,7 @@ QT_BEGIN_NAMESPACE
 DEFINE_BOOL_CONFIG_OPTION(xhrDump, QML_XHR_DUMP);
 DEFINE_BOOL_CONFIG_OPTION(xhrFileWrite, QML_XHR_ALLOW_FILE_WRITE);
 DEFINE_BOOL_CONFIG_OPTION(xhrFileRead, QML_XHR_ALLOW_FILE_READ);
+DEFINE_BOOL_CONFIG_OPTION(xhrThreadedJson, QML_XHR_THREADED_JSON);
 
 struct QQmlXMLHttpRequestData {
     QQmlXMLHttpRequestData();
@@ -1013,6 +1019,7 @@ public:
 
     QV4::ReturnedValue jsonResponseBody(QV4::ExecutionEngine*);
     QV4::ReturnedValue xmlResponseBody(QV4::ExecutionEngine*);
+    QV4::ReturnedValue arrayBufferResponseBody(QV4::ExecutionEngine*);
 private slots:
     void readyRead();
     void error(QNetworkReply::NetworkError);
@@ -1020,6 +1027,10 @@ private slots:
 
 private:
     void requestFromUrl(const QUrl &url);
+    void completeResponse();
+#if QT_CONFIG(future)
+    void parseJsonInBackground();
+#endif
 
     State m_state;
     bool m_errorFlag;
@@ -1051,6 +1062,8 @@ private:
     void dispatchCallbackNow(Object *thisObj);
     static void dispatchCallbackNow(Object *thisObj, bool done, bool error);
     void dispatchCallbackSafely();
+    void dispatchProgressSafely(const QByteArray &chunk, qint64 total);
+    qint64 expectedResponseSize() const;
 
     int m_status;
     QString m_statusText;
@@ -1064,6 +1077,10 @@ private:
 
     QString m_responseType;
     QV4::PersistentValue m_parsedDocument;
+
+    // Incremented whenever the request is reopened or aborted, so that the
+    // results of background work for an earlier response can be told apart.
+    quint32 m_requestSerial = 0;
 };
 
 QQmlXMLHttpRequest::QQmlXMLHttpRequest(QNetworkAccessManager *manager, QV4::ExecutionEngine *v4)
@@ -1109,6 +1126,8 @@ ReturnedValue QQmlXMLHttpRequest::open(Object *thisObject, const QString &method
     m_sendFlag = false;
     m_errorFlag = false;
     m_responseEntityBody = QByteArray();
+    m_parsedDocument.clear();
+    ++m_requestSerial;
     m_method = method;
     m_url = url;
     m_request.setAttribute(QNetworkRequest::SynchronousRequestAttribute, loadType == SynchronousLoad);
@@ -1296,6 +1315,7 @@ ReturnedValue QQmlXMLHttpRequest::abort(Object *thisObject)
     m_responseEntityBody = QByteArray();
     m_errorFlag = true;
     m_request = QNetworkRequest();
+    ++m_requestSerial;
 
     if (!(m_state == Unsent ||
           (m_state == Opened && !m_sendFlag) ||
@@ -1325,12 +1345,17 @@ void QQmlXMLHttpRequest::readyRead()
         dispatchCallbackSafely();
     }
 
+    const QByteArray chunk = m_network->readAll();
+    const qint64 total = expectedResponseSize();
     bool wasEmpty = m_responseEntityBody.isEmpty();
-    m_responseEntityBody.append(m_network->readAll());
+    // Copy the bytes instead of sharing the chunk, which onprogress can write to.
+    m_responseEntityBody.append(QByteArrayView(chunk));
     if (wasEmpty && !m_responseEntityBody.isEmpty())
         m_state = Loading;
 
     dispatchCallbackSafely();
+    if (!chunk.isEmpty() && m_state == Loading)
+        dispatchProgressSafely(chunk, total);
 }
 
 static const char *errorToString(QNetworkReply::NetworkError error)
@@ -1418,7 +1443,9 @@ void QQmlXMLHttpRequest::finished()
         fillHeadersList ();
         dispatchCallbackSafely();
     }
-    m_responseEntityBody.append(m_network->readAll());
+    const QByteArray chunk = m_network->readAll();
+    const qint64 total = expectedResponseSize();
+    m_responseEntityBody.append(QByteArrayView(chunk));
     readEncoding();
 
     if (xhrDump()) {
@@ -1435,6 +1462,23 @@ void QQmlXMLHttpRequest::finished()
         m_state = Loading;
         dispatchCallbackSafely();
     }
+    if (!chunk.isEmpty() && m_state == Loading)
+        dispatchProgressSafely(chunk, total);
+
+#if QT_CONFIG(future)
+    if (xhrThreadedJson()
+            && m_responseType.compare(QLatin1String("json"), Qt::CaseInsensitive) == 0
+            && !m_request.attribute(QNetworkRequest::SynchronousRequestAttribute).toBool()) {
+        parseJsonInBackground();
+        return;
+    }
+#endif
+
+    completeResponse();
+}
+
+void QQmlXMLHttpRequest::completeResponse()
+{
     m_state = Done;
 
     dispatchCallbackSafely();
@@ -1443,6 +1487,53 @@ void QQmlXMLHttpRequest::finished()
     m_qmlContext.reset();
 }
 
+#if QT_CONFIG(future)
+static JsonTape tokenizeJson(const QByteArray &body, QStringDecoder &toUtf16)
+{
+    if (qstrcmp(toUtf16.name(), "UTF-8") == 0) {
+        QByteArrayView jtext(body);
+        if (jtext.startsWith("\xef\xbb\xbf"))
+            jtext = jtext.sliced(3);
+        return JsonTape::tokenize(jtext);
+    }
+
+    const QString jtext = toUtf16(body);
+    return JsonTape::tokenize(QStringView(jtext));
+}
+
+// Decoding and tokenizing a large JSON response takes most of the time needed to
+// parse it. Do that on a worker thread, and only create the JS values on the
+// engine's thread. The request is DONE once the result is available.
+void QQmlXMLHttpRequest::parseJsonInBackground()
+{
+    QPromise<JsonTape> promise;
+    QFuture<JsonTape> tape = promise.future();
+    QThreadPool::globalInstance()->start(
+            [promise = std::move(promise), body = m_responseEntityBody,
+             toUtf16 = findTextDecoder()]() mutable {
+        promise.start();
+        promise.addResult(tokenizeJson(body, toUtf16));
+        promise.finish();
+    });
+
+    tape.then(this, [this, serial = m_requestSerial](const JsonTape &tape) {
+        // Reopened or aborted in the mean time
+        if (serial != m_requestSerial)
+            return;
+
+        // On errors, leave it to jsonResponseBody() to throw.
+        ExecutionEngine *engine = m_thisObject.engine();
+        if (engine && tape.error().error == QJsonParseError::NoError) {
+            Scope scope(engine);
+            ScopedValue value(scope, tape.materialize(engine));
+            m_parsedDocument.set(engine, value);
+        }
+
+        completeResponse();
+    });
+}
+#endif
+
 
 void QQmlXMLHttpRequest::readEncoding()
 {
@@ -1509,9 +1600,20 @@ QV4::ReturnedValue QQmlXMLHttpRequest::jsonResponseBody(QV4::ExecutionEngine* en
         Scope scope(engine);
 
         QJsonParseError error;
-        const QString& jtext = responseBody();
-        JsonParser parser(scope.engine, jtext.constData(), jtext.size());
-        ScopedValue jsonObject(scope, parser.parse(&error));
+        ScopedValue jsonObject(scope);
+        QStringDecoder toUtf16 = findTextDecoder();
+        if (qstrcmp(toUtf16.name(), "UTF-8") == 0) {
+            // Parse the bytes directly, there is no need to widen them first.
+            QByteArrayView jtext(m_responseEntityBody);
+            if (jtext.startsWith("\xef\xbb\xbf"))
+                jtext = jtext.sliced(3);
+            JsonParser parser(scope.engine, jtext.constData(), jtext.size());
+            jsonObject = parser.parse(&error);
+        } else {
+            const QString jtext = toUtf16(m_responseEntityBody);
+            JsonParser parser(scope.engine, jtext.constData(), jtext.size());
+            jsonObject = parser.parse(&error);
+        }
         if (error.error != QJsonParseError::NoError)
             return engine->throwSyntaxError(QStringLiteral("JSON.parse: Parse error"));
 
@@ -1521,6 +1623,19 @@ QV4::ReturnedValue QQmlXMLHttpRequest::jsonResponseBody(QV4::ExecutionEngine* en
     return m_parsedDocument.value();
 }
 
+QV4::ReturnedValue QQmlXMLHttpRequest::arrayBufferResponseBody(QV4::ExecutionEngine *engine)
+{
+    // The buffer refers to the received bytes rather than copying them. Once
+    // the response is complete, it is created only once.
+    if (m_state != Done)
+        return engine->newArrayBuffer(m_responseEntityBody)->asReturnedValue();
+
+    if (m_parsedDocument.isEmpty())
+        m_parsedDocument.set(engine, engine->newArrayBuffer(m_responseEntityBody));
+
+    return m_parsedDocument.value();
+}
+
 QV4::ReturnedValue QQmlXMLHttpRequest::xmlResponseBody(QV4::ExecutionEngine* engine)
 {
     if (m_parsedDocument.isEmpty()) {
@@ -1574,35 +1689,38 @@ void QQmlXMLHttpRequest::dispatchCallbackNow(Object *thisObj)
     dispatchCallbackNow(thisObj, m_state == Done, m_errorFlag);
 }
 
-void QQmlXMLHttpRequest::dispatchCallbackNow(Object *thisObj, bool done, bool error)
+static void dispatchEvent(Object *thisObj, const QString &eventName, const Value *event = nullptr)
 {
-    Q_ASSERT(thisObj);
+    QV4::Scope scope(thisObj->engine());
+    ScopedString s(scope, scope.engine->newString(eventName));
+    ScopedFunctionObject callback(scope, thisObj->get(s));
+    // not an error, but no event handler to call.
+    if (!callback)
+        return;
 
-    const auto dispatch = [thisObj](const QString &eventName) {
-        QV4::Scope scope(thisObj->engine());
-        ScopedString s(scope, scope.engine->newString(eventName));
-        ScopedFunctionObject callback(scope, thisObj->get(s));
-        // not an error, but no event handler to call.
-        if (!callback)
-            return;
+    QV4::JSCallArguments jsCallData(scope, event ? 1 : 0);
+    if (event)
+        jsCallData.args[0] = *event;
+    callback->call(jsCallData);
 
-        QV4::JSCallArguments jsCallData(scope);
-        callback->call(jsCallData);
+    if (scope.hasException()) {
+        QQmlError error = scope.engine->catchExceptionAsQmlError();
+        QQmlEnginePrivate *qmlEnginePrivate = scope.engine->qmlEngine() ? QQmlEnginePrivate::get(scope.engine->qmlEngine()) : nullptr;
+        QQmlEnginePrivate::warning(qmlEnginePrivate, error);
+    }
+}
 
-        if (scope.hasException()) {
-            QQmlError error = scope.engine->catchExceptionAsQmlError();
-            QQmlEnginePrivate *qmlEnginePrivate = scope.engine->qmlEngine() ? QQmlEnginePrivate::get(scope.engine->qmlEngine()) : nullptr;
-            QQmlEnginePrivate::warning(qmlEnginePrivate, error);
-        }
-    };
+void QQmlXMLHttpRequest::dispatchCallbackNow(Object *thisObj, bool done, bool error)
+{
+    Q_ASSERT(thisObj);
 
-    dispatch(QStringLiteral("onreadystatechange"));
+    dispatchEvent(thisObj, QStringLiteral("onreadystatechange"));
     if (done) {
         if (error)
-            dispatch(QStringLiteral("onerror"));
+            dispatchEvent(thisObj, QStringLiteral("onerror"));
         else
-            dispatch(QStringLiteral("onload"));
-        dispatch(QStringLiteral("onloadend"));
+            dispatchEvent(thisObj, QStringLiteral("onload"));
+        dispatchEvent(thisObj, QStringLiteral("onloadend"));
     }
 }
 
@@ -1619,6 +1737,50 @@ void QQmlXMLHttpRequest::dispatchCallbackSafely()
     dispatchCallbackNow(m_thisObject.as<Object>());
 }
 
+// Besides the standard ProgressEvent properties, the event passed to onprogress
+// holds the bytes received since the previous one as an ArrayBuffer in "chunk".
+// This way large responses can be processed as they arrive.
+void QQmlXMLHttpRequest::dispatchProgressSafely(const QByteArray &chunk, qint64 total)
+{
+    if (m_wasConstructedWithQmlContext && m_qmlContext.isNull())
+        return;
+
+    Object *thisObj = m_thisObject.as<Object>();
+    Q_ASSERT(thisObj);
+
+    Scope scope(thisObj->engine());
+    ScopedString s(scope, scope.engine->newString(QStringLiteral("onprogress")));
+    ScopedValue v(scope, thisObj->get(s));
+    // Don't create an event if nobody listens.
+    if (!v->isFunctionObject())
+        return;
+
+    ScopedObject event(scope, scope.engine->newObject());
+    s = scope.engine->newString(QStringLiteral("type"));
+    v = scope.engine->newString(QStringLiteral("progress"));
+    event->put(s, v);
+    s = scope.engine->newString(QStringLiteral("lengthComputable"));
+    v = Value::fromBoolean(total >= 0);
+    event->put(s, v);
+    s = scope.engine->newString(QStringLiteral("loaded"));
+    v = Value::fromDouble(m_responseEntityBody.size());
+    event->put(s, v);
+    s = scope.engine->newString(QStringLiteral("total"));
+    v = Value::fromDouble(total >= 0 ? total : 0);
+    event->put(s, v);
+    s = scope.engine->newString(QStringLiteral("chunk"));
+    v = scope.engine->newArrayBuffer(chunk);
+    event->put(s, v);
+
+    dispatchEvent(thisObj, QStringLiteral("onprogress"), event.getRef());
+}
+
+qint64 QQmlXMLHttpRequest::expectedResponseSize() const
+{
+    const QVariant length = m_network->header(QNetworkRequest::ContentLengthHeader);
+    return length.isValid() ? length.toLongLong() : -1;
+}
+
 void QQmlXMLHttpRequest::destroyNetwork()
 {
     if (m_network) {
@@ -2037,7 +2199,7 @@ ReturnedValue QQmlXMLHttpRequestCtor::method_get_response(const FunctionObject *
     if (responseType.compare(QLatin1String("text"), Qt::CaseInsensitive) == 0 || responseType.isEmpty()) {
         RETURN_RESULT(scope.engine->newString(r->responseBody()));
     } else if (responseType.compare(QLatin1String("arraybuffer"), Qt::CaseInsensitive) == 0) {
-        RETURN_RESULT(scope.engine->newArrayBuffer(r->rawResponseBody()));
+        RETURN_RESULT(r->arrayBufferResponseBody(scope.engine));
     } else if (responseType.compare(QLatin1String("json"), Qt::CaseInsensitive) == 0) {
         RETURN_RESULT(r->jsonResponseBody(scope.engine));
     } else if (responseType.compare(QLatin1String("document"), Qt::CaseInsensitive) == 0) {
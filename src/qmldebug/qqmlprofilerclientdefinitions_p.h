@@ -87,7 +87,8 @@ enum SceneGraphFrameType {
 enum MemoryType {
     HeapPage,
     LargeItem,
-    SmallItem
+    SmallItem,
+    SampledAllocation
 };
 
 enum ProfileFeature {
@@ -122,6 +122,21 @@ QDataStream &operator>>(QDataStream &stream, QQmlProfilerTypedEvent &event)
         qint64 delta;
         stream >> delta;
 
+        if (subtype == SampledAllocation) {
+            // The bytes and number of allocations sampled at a location since the last report
+            qint64 count;
+            QString filename;
+            qint32 line, column;
+            QString name;
+            stream >> count >> filename >> line >> column >> name;
+            event.type = QQmlProfilerEventType(
+                        static_cast<Message>(messageType),
+                        MaximumRangeType, subtype,
+                        QQmlProfilerEventLocation(filename, line, column), name);
+            event.event.setNumbers<qint64>({delta, count});
+            break;
+        }
+
         event.type = QQmlProfilerEventType(
                     static_cast<Message>(messageType),
                     MaximumRangeType, subtype);
@@ -37,15 +37,15 @@ class WorkerDataEvent : public QEvent
 public:
     enum Type { WorkerData = QEvent::User };
 
-    WorkerDataEvent(int workerId, const QByteArray &data);
+    WorkerDataEvent(int workerId, QV4::Serialize::Message message);
     virtual ~WorkerDataEvent();
 
     int workerId() const;
-    QByteArray data() const;
+    QV4::Serialize::Message takeMessage();
 
 private:
     int m_id;
-    QByteArray m_data;
+    QV4::Serialize::Message m_message;
 };
 
 class WorkerLoadEvent : public QEvent
@@ -125,6 +125,14 @@ public:
     // the worker script.
     QHash<int, QBiPointer<QV4::ExecutionEngine, QQuickWorkerScript>> workers;
 
+    // Messages sent to each worker that it has not processed yet. Protected by m_lock.
+    struct MessageQueueDepth
+    {
+        int pending = 0;
+        int peak = 0;
+    };
+    QHash<int, MessageQueueDepth> queueDepths;
+
     int m_nextId;
 
     static QV4::ReturnedValue method_sendMessage(const QV4::FunctionObject *, const QV4::Value *thisObject, const QV4::Value *argv, int argc);
@@ -137,7 +145,7 @@ protected:
     bool event(QEvent *) override;
 
 private:
-    void processMessage(int, const QByteArray &);
+    void processMessage(int, QV4::Serialize::Message);
     void processLoad(int, const QUrl &);
     void reportScriptException(WorkerScript *, const QQmlError &error);
 };
@@ -155,11 +163,14 @@ QV4::ReturnedValue QQuickWorkerScriptEnginePrivate::method_sendMessage(const QV4
     Q_ASSERT(script);
 
     QV4::ScopedValue v(scope, argc > 0 ? argv[0] : QV4::Value::undefinedValue());
-    QByteArray data = QV4::Serialize::serialize(v, scope.engine);
+    QV4::ScopedValue transferList(scope, argc > 1 ? argv[1] : QV4::Value::undefinedValue());
+    QV4::Serialize::Message message = QV4::Serialize::serialize(v, transferList, scope.engine);
+    if (scope.hasException())
+        return QV4::Encode::undefined();
 
     QMutexLocker locker(&script->p->m_lock);
     if (script->owner)
-        QCoreApplication::postEvent(script->owner, new WorkerDataEvent(0, data));
+        QCoreApplication::postEvent(script->owner, new WorkerDataEvent(0, std::move(message)));
 
     return QV4::Encode::undefined();
 }
@@ -168,7 +179,7 @@ bool QQuickWorkerScriptEnginePrivate::event(QEvent *event)
 {
     if (event->type() == (QEvent::Type)WorkerDataEvent::WorkerData) {
         WorkerDataEvent *workerEvent = static_cast<WorkerDataEvent *>(event);
-        processMessage(workerEvent->workerId(), workerEvent->data());
+        processMessage(workerEvent->workerId(), workerEvent->takeMessage());
         return true;
     } else if (event->type() == (QEvent::Type)WorkerLoadEvent::WorkerLoad) {
         WorkerLoadEvent *workerEvent = static_cast<WorkerLoadEvent *>(event);
@@ -186,6 +197,7 @@ bool QQuickWorkerScriptEnginePrivate::event(QEvent *event)
                 delete itr->asT1();
             workers.erase(itr);
         }
+        queueDepths.remove(workerEvent->workerId());
         return true;
     } else {
         return QObject::event(event);
@@ -209,8 +221,15 @@ QV4::ExecutionEngine *QQuickWorkerScriptEnginePrivate::workerEngine(int id)
     return engine;
 }
 
-void QQuickWorkerScriptEnginePrivate::processMessage(int id, const QByteArray &data)
+void QQuickWorkerScriptEnginePrivate::processMessage(int id, QV4::Serialize::Message message)
 {
+    {
+        QMutexLocker locker(&m_lock);
+        const auto depth = queueDepths.find(id);
+        if (depth != queueDepths.end())
+            --depth->pending;
+    }
+
     QV4::ExecutionEngine *engine = workerEngine(id);
     if (!engine)
         return;
@@ -225,7 +244,7 @@ void QQuickWorkerScriptEnginePrivate::processMessage(int id, const QByteArray &d
     if (!onmessage)
         return;
 
-    QV4::ScopedValue value(scope, QV4::Serialize::deserialize(data, engine));
+    QV4::ScopedValue value(scope, QV4::Serialize::deserialize(std::move(message), engine));
 
     QV4::JSCallArguments jsCallData(scope, 1);
     *jsCallData.thisObject = engine->global();
@@ -290,8 +309,8 @@ void QQuickWorkerScriptEnginePrivate::reportScriptException(WorkerScript *script
         QCoreApplication::postEvent(script->owner, new WorkerErrorEvent(error));
 }
 
-WorkerDataEvent::WorkerDataEvent(int workerId, const QByteArray &data)
-: QEvent((QEvent::Type)WorkerData), m_id(workerId), m_data(data)
+WorkerDataEvent::WorkerDataEvent(int workerId, QV4::Serialize::Message message)
+: QEvent((QEvent::Type)WorkerData), m_id(workerId), m_message(std::move(message))
 {
 }
 
@@ -304,9 +323,9 @@ int WorkerDataEvent::workerId() const
     return m_id;
 }
 
-QByteArray WorkerDataEvent::data() const
+QV4::Serialize::Message WorkerDataEvent::takeMessage()
 {
-    return m_data;
+    return std::move(m_message);
 }
 
 WorkerLoadEvent::WorkerLoadEvent(int workerId, const QUrl &url)
@@ -412,6 +431,7 @@ int QQuickWorkerScriptEngine::registerWorkerScript(QQuickWorkerScript *owner)
     d->workers.insert(id, owner);
     d->m_lock.unlock();
 
+    ++m_workerCount;
     return id;
 }
 
@@ -425,6 +445,7 @@ void QQuickWorkerScriptEngine::removeWorkerScript(int id)
         QV4::ExecutionEngine *engine = it->asT1();
         workerScriptExtension(engine)->owner = nullptr;
     }
+    --m_workerCount;
     QCoreApplication::postEvent(d, new WorkerRemoveEvent(id));
 }
 
@@ -433,9 +454,26 @@ void QQuickWorkerScriptEngine::executeUrl(int id, const QUrl &url)
     QCoreApplication::postEvent(d, new WorkerLoadEvent(id, url));
 }
 
-void QQuickWorkerScriptEngine::sendMessage(int id, const QByteArray &data)
+void QQuickWorkerScriptEngine::sendMessage(int id, QV4::Serialize::Message message)
+{
+    d->m_lock.lock();
+    auto &depth = d->queueDepths[id];
+    depth.peak = std::max(depth.peak, ++depth.pending);
+    d->m_lock.unlock();
+
+    QCoreApplication::postEvent(d, new WorkerDataEvent(id, std::move(message)));
+}
+
+int QQuickWorkerScriptEngine::pendingMessageCount(int id) const
+{
+    QMutexLocker locker(&d->m_lock);
+    return d->queueDepths.value(id).pending;
+}
+
+int QQuickWorkerScriptEngine::peakPendingMessageCount(int id) const
 {
-    QCoreApplication::postEvent(d, new WorkerDataEvent(id, data));
+    QMutexLocker locker(&d->m_lock);
+    return d->queueDepths.value(id).peak;
 }
 
 void QQuickWorkerScriptEngine::run()
@@ -454,6 +492,51 @@ void QQuickWorkerScriptEngine::run()
     d->workers.clear();
 }
 
+QQuickWorkerScriptEnginePool::QQuickWorkerScriptEnginePool(QQmlEngine *parent)
+    : QObject(parent), m_qmlEngine(parent)
+{
+    bool ok = false;
+    m_maxThreadCount = qEnvironmentVariableIntValue("QML_WORKERSCRIPT_THREAD_COUNT", &ok);
+    if (!ok || m_maxThreadCount <= 0)
+        m_maxThreadCount = std::max(1, QThread::idealThreadCount());
+}
+
+QQuickWorkerScriptEnginePool::~QQuickWorkerScriptEnginePool() = default;
+
+/*
+    Returns the engine a new WorkerScript should run on. Shared engines are created lazily until
+    the pool is full. After that, new workers go to the shared engine with the fewest workers.
+    Engines are children of the QQmlEngine, so that they are shut down along with it.
+*/
+QQuickWorkerScriptEngine *QQuickWorkerScriptEnginePool::acquire(bool dedicatedThread)
+{
+    if (dedicatedThread) {
+        QQuickWorkerScriptEngine *engine = new QQuickWorkerScriptEngine(m_qmlEngine);
+        m_dedicatedEngines.append(engine);
+        return engine;
+    }
+
+    QQuickWorkerScriptEngine *leastBusy = nullptr;
+    for (QQuickWorkerScriptEngine *engine : std::as_const(m_sharedEngines)) {
+        if (!leastBusy || engine->workerCount() < leastBusy->workerCount())
+            leastBusy = engine;
+    }
+
+    if (leastBusy && (leastBusy->workerCount() == 0 || m_sharedEngines.size() >= m_maxThreadCount))
+        return leastBusy;
+
+    QQuickWorkerScriptEngine *engine = new QQuickWorkerScriptEngine(m_qmlEngine);
+    m_sharedEngines.append(engine);
+    return engine;
+}
+
+void QQuickWorkerScriptEnginePool::release(QQuickWorkerScriptEngine *engine)
+{
+    // Shared threads stay around for later workers. Dedicated ones are done once their worker is.
+    if (engine->workerCount() == 0 && m_dedicatedEngines.removeOne(engine))
+        engine->deleteLater();
+}
+
 
 /*!
     \qmltype WorkerScript
@@ -516,7 +599,17 @@ QQuickWorkerScript::QQuickWorkerScript(QObject *parent)
 
 QQuickWorkerScript::~QQuickWorkerScript()
 {
-    if (m_scriptId != -1) m_engine->removeWorkerScript(m_scriptId);
+    if (m_scriptId == -1)
+        return;
+
+    m_engine->removeWorkerScript(m_scriptId);
+    if (const QQmlEngine *engine = qmlEngine(this)) {
+        const QQmlEnginePrivate *enginePrivate = QQmlEnginePrivate::get(engine);
+        if (auto *pool = qobject_cast<QQuickWorkerScriptEnginePool *>(
+                    enginePrivate->workerScriptEnginePool)) {
+            pool->release(m_engine);
+        }
+    }
 }
 
 /*!
@@ -561,7 +654,62 @@ bool QQuickWorkerScript::ready() const
 }
 
 /*!
-    \qmlmethod WorkerScript::sendMessage(jsobject message)
+    \qmlproperty bool WorkerScript::dedicatedThread
+    \since 6.9
+
+    This property holds whether the worker script gets a thread of its own.
+
+    By default, worker scripts share a pool of threads owned by the QML engine. The pool grows up
+    to one thread per CPU core, and each new worker script is assigned to the thread that runs the
+    fewest worker scripts. Set the \c QML_WORKERSCRIPT_THREAD_COUNT environment variable to limit
+    the size of the pool. A value of 1 runs all shared worker scripts on a single thread.
+
+    Set this property to \c true for long-running workers that would otherwise hold up the
+    other worker scripts on their thread. The thread is stopped when the worker script is
+    destroyed.
+
+    The property has to be set before the worker script is started. Changing it later has no
+    effect.
+*/
+bool QQuickWorkerScript::dedicatedThread() const
+{
+    return m_dedicatedThread;
+}
+
+void QQuickWorkerScript::setDedicatedThread(bool dedicatedThread)
+{
+    if (m_dedicatedThread == dedicatedThread)
+        return;
+
+    if (m_engine) {
+        qmlWarning(this) << "dedicatedThread cannot be changed after the WorkerScript has started";
+        return;
+    }
+
+    m_dedicatedThread = dedicatedThread;
+    emit dedicatedThreadChanged();
+}
+
+/*!
+    \internal
+    Returns the number of messages sent to the worker script that it has not handled yet.
+*/
+int QQuickWorkerScript::pendingMessageCount() const
+{
+    return m_engine ? m_engine->pendingMessageCount(m_scriptId) : 0;
+}
+
+/*!
+    \internal
+    Returns the highest number of messages that were waiting for the worker script at any time.
+*/
+int QQuickWorkerScript::peakPendingMessageCount() const
+{
+    return m_engine ? m_engine->peakPendingMessageCount(m_scriptId) : 0;
+}
+
+/*!
+    \qmlmethod WorkerScript::sendMessage(jsobject message, list transfer)
 
     Sends the given \a message to a worker script handler in another
     thread. The other worker script handler can receive this message
@@ -573,12 +721,24 @@ bool QQuickWorkerScript::ready() const
     \list
     \li boolean, number, string
     \li JavaScript objects and arrays
+    \li ArrayBuffer, SharedArrayBuffer and typed arrays
     \li ListModel objects (any other type of QObject* is not allowed)
     \endlist
 
     All objects and arrays are copied to the \c message. With the exception
-    of ListModel objects, any modifications by the other thread to an object
-    passed in \c message will not be reflected in the original object.
+    of ListModel objects and SharedArrayBuffers, any modifications by the other
+    thread to an object passed in \c message will not be reflected in the
+    original object. A SharedArrayBuffer refers to the same memory on both
+    sides, so that the threads can coordinate through the \c Atomics object.
+
+    Since Qt 6.9, the optional \a transfer array can list ArrayBuffers contained
+    in \a message. Their contents are moved to the other thread rather than
+    copied, which is much cheaper for large buffers. The transferred buffers
+    become detached on the sending side: their length is 0 afterwards, and
+    typed arrays using them can no longer be accessed.
+
+    The worker script can pass a transfer array as the second argument of
+    \c WorkerScript.sendMessage(), too.
 */
 void QQuickWorkerScript::sendMessage(QQmlV4FunctionPtr args)
 {
@@ -591,8 +751,16 @@ void QQuickWorkerScript::sendMessage(QQmlV4FunctionPtr args)
     QV4::ScopedValue argument(scope, QV4::Value::undefinedValue());
     if (args->length() != 0)
         argument = (*args)[0];
+    QV4::ScopedValue transferList(scope, QV4::Value::undefinedValue());
+    if (args->length() > 1)
+        transferList = (*args)[1];
+
+    QV4::Serialize::Message message
+            = QV4::Serialize::serialize(argument, transferList, scope.engine);
+    if (scope.hasException())
+        return;
 
-    m_engine->sendMessage(m_scriptId, QV4::Serialize::serialize(argument, scope.engine));
+    m_engine->sendMessage(m_scriptId, std::move(message));
 }
 
 void QQuickWorkerScript::classBegin()
@@ -612,10 +780,12 @@ QQuickWorkerScriptEngine *QQuickWorkerScript::engine()
         }
 
         QQmlEnginePrivate *enginePrivate = QQmlEnginePrivate::get(engine);
-        if (enginePrivate->workerScriptEngine == nullptr)
-            enginePrivate->workerScriptEngine = new QQuickWorkerScriptEngine(engine);
-        m_engine = qobject_cast<QQuickWorkerScriptEngine *>(enginePrivate->workerScriptEngine);
-        Q_ASSERT(m_engine);
+        if (enginePrivate->workerScriptEnginePool == nullptr)
+            enginePrivate->workerScriptEnginePool = new QQuickWorkerScriptEnginePool(engine);
+        auto *pool = qobject_cast<QQuickWorkerScriptEnginePool *>(
+                enginePrivate->workerScriptEnginePool);
+        Q_ASSERT(pool);
+        m_engine = pool->acquire(m_dedicatedThread);
         m_scriptId = m_engine->registerWorkerScript(this);
 
         if (m_source.isValid())
@@ -648,7 +818,7 @@ bool QQuickWorkerScript::event(QEvent *event)
             QV4::ExecutionEngine *v4 = engine->handle();
             WorkerDataEvent *workerEvent = static_cast<WorkerDataEvent *>(event);
             emit message(QJSValuePrivate::fromReturnedValue(
-                             QV4::Serialize::deserialize(workerEvent->data(), v4)));
+                             QV4::Serialize::deserialize(workerEvent->takeMessage(), v4)));
         }
         return true;
     } else if (event->type() == (QEvent::Type)WorkerErrorEvent::WorkerError) {
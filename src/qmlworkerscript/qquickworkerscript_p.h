@@ -18,6 +18,7 @@
 #include <qqml.h>
 
 #include <QtQmlWorkerScript/private/qtqmlworkerscriptglobal_p.h>
+#include <QtQmlWorkerScript/private/qv4serialize_p.h>
 #include <QtQml/qqmlparserstatus.h>
 #include <QtCore/qthread.h>
 #include <QtQml/qjsvalue.h>
@@ -38,13 +39,38 @@ public:
     int registerWorkerScript(QQuickWorkerScript *);
     void removeWorkerScript(int);
     void executeUrl(int, const QUrl &);
-    void sendMessage(int, const QByteArray &);
+    void sendMessage(int, QV4::Serialize::Message);
+
+    int workerCount() const { return m_workerCount; }
+    int pendingMessageCount(int) const;
+    int peakPendingMessageCount(int) const;
 
 protected:
     void run() override;
 
 private:
     QQuickWorkerScriptEnginePrivate *d;
+    int m_workerCount = 0;
+};
+
+class Q_QMLWORKERSCRIPT_EXPORT QQuickWorkerScriptEnginePool : public QObject
+{
+    Q_OBJECT
+public:
+    QQuickWorkerScriptEnginePool(QQmlEngine *parent);
+    ~QQuickWorkerScriptEnginePool();
+
+    QQuickWorkerScriptEngine *acquire(bool dedicatedThread);
+    void release(QQuickWorkerScriptEngine *);
+
+    int maxThreadCount() const { return m_maxThreadCount; }
+    int threadCount() const { return m_sharedEngines.size() + m_dedicatedEngines.size(); }
+
+private:
+    QQmlEngine *m_qmlEngine;
+    QList<QQuickWorkerScriptEngine *> m_sharedEngines;
+    QList<QQuickWorkerScriptEngine *> m_dedicatedEngines;
+    int m_maxThreadCount;
 };
 
 class Q_QMLWORKERSCRIPT_EXPORT QQuickWorkerScript : public QObject, public QQmlParserStatus
@@ -53,6 +79,8 @@ class Q_QMLWORKERSCRIPT_EXPORT QQuickWorkerScript : public QObject, public QQmlP
     Q_DISABLE_COPY_MOVE(QQuickWorkerScript)
     Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
     Q_PROPERTY(bool ready READ ready NOTIFY readyChanged REVISION(2, 15))
+    Q_PROPERTY(bool dedicatedThread READ dedicatedThread WRITE setDedicatedThread
+               NOTIFY dedicatedThreadChanged REVISION(6, 9) FINAL)
 
     QML_NAMED_ELEMENT(WorkerScript);
     QML_ADDED_IN_VERSION(2, 0)
@@ -67,12 +95,19 @@ public:
 
     bool ready() const;
 
+    bool dedicatedThread() const;
+    void setDedicatedThread(bool dedicatedThread);
+
+    int pendingMessageCount() const;
+    int peakPendingMessageCount() const;
+
 public Q_SLOTS:
     void sendMessage(QQmlV4FunctionPtr);
 
 Q_SIGNALS:
     void sourceChanged();
     Q_REVISION(2, 15) void readyChanged();
+    Q_REVISION(6, 9) void dedicatedThreadChanged();
     void message(const QJSValue &messageObject);
 
 protected:
@@ -86,6 +121,7 @@ private:
     int m_scriptId;
     QUrl m_source;
     bool m_componentComplete;
+    bool m_dedicatedThread = false;
 };
 
 QT_END_NAMESPACE
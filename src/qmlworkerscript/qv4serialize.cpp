@@ -3,12 +3,14 @@
 
 #include "qv4serialize_p.h"
 
+#include <private/qv4arraybuffer_p.h>
 #include <private/qv4dateobject_p.h>
 #include <private/qv4objectproto_p.h>
 #include <private/qv4qobjectwrapper_p.h>
 #include <private/qv4regexp_p.h>
 #include <private/qv4regexpobject_p.h>
 #include <private/qv4sequenceobject_p.h>
+#include <private/qv4typedarray_p.h>
 #include <private/qv4value_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -27,6 +29,9 @@ using namespace QV4;
 //    + Number
 //    + Date
 //    + RegExp
+//    + ArrayBuffer (copied, or moved if it is in the transfer list)
+//    + SharedArrayBuffer (shared, never copied)
+//    + Typed arrays
 // <quint8 type><quint24 size><data>
 
 enum Type {
@@ -45,7 +50,11 @@ enum Type {
     WorkerRegexp,
     WorkerListModel,
     WorkerUrl,
-    WorkerSequence
+    WorkerSequence,
+    WorkerArrayBuffer,
+    WorkerTransferredArrayBuffer,
+    WorkerSharedArrayBuffer,
+    WorkerTypedArray
 };
 
 static inline quint32 valueheader(Type type, quint32 size = 0)
@@ -127,9 +136,11 @@ static inline void serializeString(QByteArray &data, const QString &str, Type ty
 // XXX TODO: Check that worker script is exception safe in the case of
 // serialization/deserialization failures
 
-void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine *engine)
+void Serialize::serialize(Message &message, const QV4::Value &v, ExecutionEngine *engine,
+                          const TransferList &transferList)
 {
     QV4::Scope scope(engine);
+    QByteArray &data = message.data;
 
     if (v.isEmpty()) {
         Q_ASSERT(!"Serialize: got empty value");
@@ -155,7 +166,7 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
         push(data, valueheader(WorkerArray, length));
         ScopedValue val(scope);
         for (uint ii = 0; ii < length; ++ii)
-            serialize(data, (val = array->get(ii)), engine);
+            serialize(message, (val = array->get(ii)), engine, transferList);
     } else if (v.isInteger()) {
         reserve(data, 2 * sizeof(quint32));
         push(data, valueheader(WorkerInt32));
@@ -191,6 +202,39 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
         char *buffer = data.data() + offset;
 
         memcpy(buffer, pattern.constData(), length*sizeof(QChar));
+    } else if (const SharedArrayBuffer *arrayBuffer = v.as<SharedArrayBuffer>()) {
+        Heap::SharedArrayBuffer *heap = arrayBuffer->d();
+        if (heap->hasDetachedArrayData()) {
+            push(data, valueheader(WorkerUndefined));
+        } else if (arrayBuffer->isSharedArrayBuffer()) {
+            // Both engines refer to the same memory from now on. The message holds a reference
+            // until it is deserialized or dropped.
+            push(data, valueheader(WorkerSharedArrayBuffer));
+            push(data, quint32(message.buffers.size()));
+            message.buffers.append(heap->sharedArrayData());
+        } else if (transferList.contains(static_cast<Heap::ArrayBuffer *>(heap))) {
+            // The memory is moved to the receiving engine. The caller detaches the buffer
+            // once the whole message is serialized.
+            push(data, valueheader(WorkerTransferredArrayBuffer));
+            push(data, quint32(message.buffers.size()));
+            message.buffers.append(heap->sharedArrayData());
+        } else {
+            const quint32 length = heap->arrayDataLength();
+            const quint32 alignedLength = ALIGN(length);
+            reserve(data, 2 * sizeof(quint32) + alignedLength);
+            push(data, valueheader(WorkerArrayBuffer));
+            push(data, length);
+            const int offset = data.size();
+            data.resize(data.size() + alignedLength);
+            memcpy(data.data() + offset, heap->constArrayData(), length);
+        }
+    } else if (const TypedArray *typedArray = v.as<TypedArray>()) {
+        reserve(data, 3 * sizeof(quint32));
+        push(data, valueheader(WorkerTypedArray, typedArray->d()->arrayType));
+        push(data, quint32(typedArray->byteOffset()));
+        push(data, quint32(typedArray->byteLength()));
+        ScopedValue buffer(scope, typedArray->d()->buffer);
+        serialize(message, buffer, engine, transferList);
     } else if (const QObjectWrapper *qobjectWrapper = v.as<QV4::QObjectWrapper>()) {
         // XXX TODO: Generalize passing objects between the main thread and worker scripts so
         // that others can trivially plug in their elements.
@@ -217,12 +261,13 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
         push(data, valueheader(WorkerSequence, length));
 
         // sequence type
-        serialize(data, QV4::Value::fromInt32(
-                                QV4::SequencePrototype::metaTypeForSequence(s).id()), engine);
+        serialize(message, QV4::Value::fromInt32(
+                                QV4::SequencePrototype::metaTypeForSequence(s).id()), engine,
+                  transferList);
 
         ScopedValue val(scope);
         for (uint ii = 0; ii < seqLength; ++ii)
-            serialize(data, (val = s->get(ii)), engine); // sequence elements
+            serialize(message, (val = s->get(ii)), engine, transferList); // sequence elements
 
         return;
     } else if (const Object *o = v.as<Object>()) {
@@ -246,14 +291,14 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
         QV4::ScopedValue s(scope);
         for (quint32 ii = 0; ii < length; ++ii) {
             s = properties->get(ii);
-            serialize(data, s, engine);
+            serialize(message, s, engine, transferList);
 
             QV4::String *str = s->as<String>();
             val = o->get(str);
             if (scope.hasException())
                 scope.engine->catchException();
 
-            serialize(data, val, engine);
+            serialize(message, val, engine, transferList);
         }
         return;
     } else {
@@ -296,7 +341,7 @@ Q_DECLARE_METATYPE(VariantRef)
 Q_DECLARE_METATYPE(QV4::ExecutionEngine *)
 QT_BEGIN_NAMESPACE
 
-ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
+ReturnedValue Serialize::deserialize(const char *&data, Message &message, ExecutionEngine *engine)
 {
     quint32 header = popUint32(data);
     Type type = headertype(header);
@@ -331,7 +376,7 @@ ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
         ScopedArrayObject a(scope, engine->newArrayObject());
         ScopedValue v(scope);
         for (quint32 ii = 0; ii < size; ++ii) {
-            v = deserialize(data, engine);
+            v = deserialize(data, message, engine);
             a->put(ii, v);
         }
         return a.asReturnedValue();
@@ -344,8 +389,8 @@ ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
         ScopedString n(scope);
         ScopedValue value(scope);
         for (quint32 ii = 0; ii < size; ++ii) {
-            name = deserialize(data, engine);
-            value = deserialize(data, engine);
+            name = deserialize(data, message, engine);
+            value = deserialize(data, message, engine);
             n = name->asReturnedValue();
             o->put(n, value);
         }
@@ -387,34 +432,120 @@ ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
         ScopedValue value(scope);
         quint32 length = headersize(header);
         quint32 seqLength = length - 1;
-        value = deserialize(data, engine);
+        value = deserialize(data, message, engine);
         int sequenceType = value->integerValue();
         ScopedArrayObject array(scope, engine->newArrayObject());
         array->arrayReserve(seqLength);
         for (quint32 ii = 0; ii < seqLength; ++ii) {
-            value = deserialize(data, engine);
+            value = deserialize(data, message, engine);
             array->arrayPut(ii, value);
         }
         array->setArrayLengthUnchecked(seqLength);
         QVariant seqVariant = QV4::SequencePrototype::toVariant(array, QMetaType(sequenceType));
         return QV4::SequencePrototype::fromVariant(engine, seqVariant);
     }
+    case WorkerArrayBuffer:
+    {
+        const quint32 length = popUint32(data);
+        Heap::ArrayBuffer *buffer = engine->newArrayBuffer(length);
+        memcpy(buffer->arrayData(), data, length);
+        data += ALIGN(length);
+        return Encode(buffer);
+    }
+    case WorkerTransferredArrayBuffer:
+    case WorkerSharedArrayBuffer:
+    {
+        // Take the reference out of the message, so that a transferred buffer is not shared
+        // with it and can be written without detaching.
+        const QByteArray bytes = std::exchange(message.buffers[popUint32(data)], QByteArray());
+        return type == WorkerSharedArrayBuffer
+                ? Encode(engine->newSharedArrayBuffer(bytes))
+                : Encode(engine->newArrayBuffer(bytes));
+    }
+    case WorkerTypedArray:
+    {
+        const auto arrayType = Heap::TypedArray::Type(headersize(header));
+        const quint32 byteOffset = popUint32(data);
+        const quint32 byteLength = popUint32(data);
+        Scoped<SharedArrayBuffer> buffer(scope, deserialize(data, message, engine));
+        if (!buffer || buffer->hasDetachedArrayData()
+                || quint64(byteOffset) + byteLength > buffer->arrayDataLength()) {
+            return QV4::Encode::undefined();
+        }
+        Scoped<TypedArray> array(scope, TypedArray::create(engine, arrayType));
+        array->d()->buffer.set(engine, buffer->d());
+        array->d()->byteOffset = byteOffset;
+        array->d()->byteLength = byteLength;
+        return array.asReturnedValue();
+    }
     }
     Q_ASSERT(!"Unreachable");
     return QV4::Encode::undefined();
 }
 
-QByteArray Serialize::serialize(const QV4::Value &value, ExecutionEngine *engine)
+Serialize::Message Serialize::serialize(const QV4::Value &value, ExecutionEngine *engine)
 {
-    QByteArray rv;
-    serialize(rv, value, engine);
+    Message rv;
+    serialize(rv, value, engine, TransferList());
+    return rv;
+}
+
+/*!
+    \internal
+    Serializes \a value like serialize(), except that the ArrayBuffers in \a transferList are
+    moved into the message rather than copied. They are detached afterwards, as the receiving
+    engine owns their memory from then on. Throws a TypeError if \a transferList contains
+    anything other than ArrayBuffers.
+*/
+Serialize::Message Serialize::serialize(const QV4::Value &value, const QV4::Value &transferList,
+                                        ExecutionEngine *engine)
+{
+    if (transferList.isUndefined())
+        return serialize(value, engine);
+
+    QV4::Scope scope(engine);
+    QV4::ScopedObject list(scope, transferList);
+    if (!list) {
+        engine->throwTypeError(QStringLiteral("The transfer list has to be an array"));
+        return Message();
+    }
+
+    TransferList buffers;
+    TransferList detached;
+    const qint64 length = list->getLength();
+    QV4::ScopedValue element(scope);
+    for (qint64 ii = 0; ii < length; ++ii) {
+        element = list->get(ii);
+        const ArrayBuffer *buffer = element->as<ArrayBuffer>();
+        if (!buffer || buffer->isSharedArrayBuffer() || buffer->hasDetachedArrayData()) {
+            engine->throwTypeError(QStringLiteral("Only ArrayBuffers can be transferred"));
+            return Message();
+        }
+        if (detached.contains(buffer->d()))
+            continue;
+        detached.append(buffer->d());
+
+        // Memory that is also referenced from C++ cannot be handed over. It is copied instead.
+        if (!buffer->d()->hasSharedArrayData())
+            buffers.append(buffer->d());
+    }
+
+    Message rv;
+    serialize(rv, value, engine, buffers);
+    for (Heap::ArrayBuffer *buffer : std::as_const(detached))
+        buffer->detachArrayData();
     return rv;
 }
 
-ReturnedValue Serialize::deserialize(const QByteArray &data, ExecutionEngine *engine)
+/*!
+    \internal
+    Deserializes \a message into \a engine. The ArrayBuffer memory held by \a message is
+    handed over to \a engine.
+*/
+ReturnedValue Serialize::deserialize(Message message, ExecutionEngine *engine)
 {
-    const char *stream = data.constData();
-    return deserialize(stream, engine);
+    const char *stream = message.data.constData();
+    return deserialize(stream, message, engine);
 }
 
 QT_END_NAMESPACE
@@ -16,6 +16,7 @@
 //
 
 #include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
 #include <private/qv4value_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -24,13 +25,23 @@ namespace QV4 {
 
 class Serialize {
 public:
+    struct Message
+    {
+        QByteArray data;
 
-    static QByteArray serialize(const Value &, ExecutionEngine *);
-    static ReturnedValue deserialize(const QByteArray &, ExecutionEngine *);
+        // The memory of shared and transferred ArrayBuffers. It is released together with the
+        // message if the message is dropped without being deserialized.
+        QList<QByteArray> buffers;
+    };
+
+    static Message serialize(const Value &, ExecutionEngine *);
+    static Message serialize(const Value &, const Value &transferList, ExecutionEngine *);
+    static ReturnedValue deserialize(Message, ExecutionEngine *);
 
 private:
-    static void serialize(QByteArray &, const Value &, ExecutionEngine *);
-    static ReturnedValue deserialize(const char *&, ExecutionEngine *);
+    using TransferList = QList<Heap::ArrayBuffer *>;
+    static void serialize(Message &, const Value &, ExecutionEngine *, const TransferList &);
+    static ReturnedValue deserialize(const char *&, Message &, ExecutionEngine *);
 };
 
 }
@@ -729,6 +729,7 @@ void QQuickLoaderPrivate::_q_sourceLoaded()
 
     delete incubator;
     incubator = new QQuickLoaderIncubator(this, asynchronous ? QQmlIncubator::Asynchronous : QQmlIncubator::AsynchronousIfNested);
+    updateIncubationPriority();
 
     component->create(*incubator, context);
 
@@ -736,6 +737,17 @@ void QQuickLoaderPrivate::_q_sourceLoaded()
         updateStatus();
 }
 
+void QQuickLoaderPrivate::updateIncubationPriority()
+{
+    Q_Q(QQuickLoader);
+    // Items that are visible are needed first.
+    if (incubator) {
+        QQmlIncubatorPrivate::get(incubator)->setPriority(
+                q->isVisible() ? QQmlIncubatorPrivate::HighPriority
+                               : QQmlIncubatorPrivate::LowPriority);
+    }
+}
+
 /*!
     \qmlproperty enumeration QtQuick::Loader::status
 
@@ -803,6 +815,11 @@ void QQuickLoader::itemChange(QQuickItem::ItemChange change, const QQuickItem::I
             // Re-trigger the parent traversal to get subtreeTransformChangedEnabled turned on
             value.item->setFlag(QQuickItem::ItemObservesViewport);
         break;
+    case ItemVisibleHasChanged: {
+        Q_D(QQuickLoader);
+        d->updateIncubationPriority();
+        break;
+    }
     default:
         break;
     }
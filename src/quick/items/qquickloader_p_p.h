@@ -62,6 +62,7 @@ public:
     QQuickLoader::Status computeStatus() const;
     void updateStatus();
     void createComponent();
+    void updateIncubationPriority();
 
     qreal getImplicitWidth() const override;
     qreal getImplicitHeight() const override;
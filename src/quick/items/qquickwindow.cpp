@@ -51,6 +51,7 @@
 #ifndef QT_NO_DEBUG_STREAM
 #include <private/qdebug_p.h>
 #endif
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qpointer.h>
 
 #include <rhi/qrhi.h>
@@ -76,11 +77,15 @@ class QQuickWindowIncubationController : public QObject, public QQmlIncubationCo
     Q_OBJECT
 
 public:
-    QQuickWindowIncubationController(QSGRenderLoop *loop)
+    QQuickWindowIncubationController(const QQuickWindow *window, QSGRenderLoop *loop)
         : m_renderLoop(loop), m_timer(0)
     {
         // Allow incubation for 1/3 of a frame.
-        m_incubation_time = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()) / 3);
+        m_frame_time = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()));
+        m_incubation_time = qMax(1, m_frame_time / 3);
+
+        // Remember when the last frame started, so that incubation can use what is left of it.
+        connect(window, &QQuickWindow::afterAnimating, this, [this]() { m_frameStart.start(); });
 
         QAnimationDriver *animationDriver = m_renderLoop->animationDriver();
         if (animationDriver) {
@@ -109,7 +114,7 @@ public slots:
     void incubate() {
         if (m_renderLoop && incubatingObjectCount()) {
             if (m_renderLoop->interleaveIncubation()) {
-                incubateFor(m_incubation_time);
+                incubateFor(interleavedIncubationTime());
             } else {
                 incubateFor(m_incubation_time * 2);
                 if (incubatingObjectCount())
@@ -128,7 +133,21 @@ protected:
     }
 
 private:
+    int interleavedIncubationTime() const
+    {
+        // No frame in progress, for example because nothing is animating.
+        if (!m_frameStart.isValid() || m_frameStart.hasExpired(m_frame_time))
+            return m_incubation_time;
+
+        // Use what is left of the current frame, but leave 1/3 of it for event processing
+        // and animating the next one.
+        const int remaining = m_frame_time - int(m_frameStart.elapsed());
+        return qBound(1, remaining - m_frame_time / 3, 2 * m_frame_time / 3);
+    }
+
     QPointer<QSGRenderLoop> m_renderLoop;
+    QElapsedTimer m_frameStart;
+    int m_frame_time;
     int m_incubation_time;
     int m_timer;
 };
@@ -2717,7 +2736,7 @@ QQmlIncubationController *QQuickWindow::incubationController() const
         return nullptr; // TODO: make sure that this is safe
 
     if (!d->incubationController)
-        d->incubationController = new QQuickWindowIncubationController(d->windowManager);
+        d->incubationController = new QQuickWindowIncubationController(this, d->windowManager);
     return d->incubationController;
 }
 
@@ -11,6 +11,7 @@
 #include <QtTest/qtest.h>
 #include <QtTest/qsignalspy.h>
 #include <QtCore/qlibraryinfo.h>
+#include <QtCore/qscopeguard.h>
 
 #include <QtGui/private/qguiapplication_p.h>
 #include <QtGui/qpa/qplatformintegration.h>
@@ -306,6 +307,8 @@ void tst_QQmlProfilerService::checkJsHeap()
             used += amount;
             seen_large = true;
             break;
+        case SampledAllocation:
+            break;
         }
 
         QVERIFY(message.timestamp() >= lastTimestamp);
@@ -706,6 +709,12 @@ void tst_QQmlProfilerService::translationBinding()
 
 void tst_QQmlProfilerService::memory()
 {
+    // Sample every allocation
+    qputenv("QV4_PROFILE_ALLOCATION_SAMPLING_INTERVAL", "1");
+    const auto guard = qScopeGuard([]() {
+        qunsetenv("QV4_PROFILE_ALLOCATION_SAMPLING_INTERVAL");
+    });
+
     QCOMPARE(connectTo(true, "memory.qml"), ConnectSuccess);
     checkProcessTerminated();
 
@@ -714,13 +723,23 @@ void tst_QQmlProfilerService::memory()
 
     QVERIFY(m_client);
     int smallItems = 0;
+    bool seenRecurseSite = false;
     for (const auto& message : m_client->jsHeapMessages) {
         const QQmlProfilerEventType &type = m_client->types[message.typeIndex()];
         if (type.detailType() == SmallItem)
             ++smallItems;
+        if (type.detailType() == SampledAllocation) {
+            QVERIFY(message.number<qint64>(0) > 0);
+            QVERIFY(message.number<qint64>(1) > 0);
+            if (type.data() == QLatin1String("recurse")) {
+                QVERIFY(type.location().filename().endsWith(QLatin1String("memory.qml")));
+                seenRecurseSite = true;
+            }
+        }
     }
 
     QVERIFY(smallItems > 5);
+    QVERIFY(seenRecurseSite);
 }
 
 static bool hasCompileEvents(const QVector<QQmlProfilerEventType> &types)
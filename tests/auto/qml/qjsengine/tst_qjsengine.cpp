@@ -19,6 +19,7 @@
 #include <QModelIndex>
 #include <QtQml/qqmllist.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
+#include <private/qv4engine_p.h>
 #include <private/qv4functionobject_p.h>
 
 #ifdef Q_CC_MSVC
@@ -142,6 +143,7 @@ private slots:
     void reentrancy_objectCreation();
     void jsIncDecNonObjectProperty();
     void JSON_Parse();
+    void JSON_Parse_repeatedShapes();
     void JSON_Stringify_data();
     void JSON_Stringify();
     void JSON_Stringify_WithReplacer_QTBUG_95324();
@@ -271,6 +273,10 @@ private slots:
 
     void interrupt_data();
     void interrupt();
+    void executionBudget_data();
+    void executionBudget();
+    void executionBudgetCallback();
+    void executionBudgetKeepsInterrupt();
 
     void triggerBackwardJumpWithDestructuring();
     void arrayConcatOnSparseArray();
@@ -336,6 +342,10 @@ private slots:
 
     void multiMatchingRegularExpression();
 
+    void megamorphicPropertyLookup();
+    void appendToFlattenedString();
+    void appendToStringSharedWithCpp();
+
 public:
     Q_INVOKABLE QJSValue throwingCppMethod1();
     Q_INVOKABLE void throwingCppMethod2();
@@ -3460,6 +3470,29 @@ void tst_QJSEngine::JSON_Parse()
     QVERIFY(ret.isObject());
 }
 
+void tst_QJSEngine::JSON_Parse_repeatedShapes()
+{
+    QJSEngine eng;
+    QJSValue ret = eng.evaluate(R"(
+        var list = JSON.parse('[{"a": 1, "b": "x"}, {"a": 2, "b": "y\\u00e9"},'
+                              + ' {"b": 3, "a": 4}, {"a": 5, "a": 6}, {"0": 7, "a": 8},'
+                              + ' {"a": -0, "__proto__": 9}, {"a": 1234567890, "b": -12}]');
+        [
+            list.map(o => Object.keys(o).join()).join("|"),
+            list.map(o => o.a).join(),
+            list[1].b,
+            list[4][0],
+            1 / list[5].a,
+            Object.getPrototypeOf(list[5]) === Object.prototype,
+            list[5].__proto__,
+            list[6].b
+        ].join(";");
+    )");
+    QCOMPARE(ret.toString(),
+             QString::fromUtf8("a,b|a,b|b,a|a|0,a|a,__proto__|a,b;1,2,4,6,8,0,1234567890;"
+                               "y\u00e9;7;-Infinity;true;9;-12"));
+}
+
 void tst_QJSEngine::JSON_Stringify_data()
 {
     QTest::addColumn<QString>("object");
@@ -3475,6 +3508,21 @@ void tst_QJSEngine::JSON_Stringify_data()
     QTest::newRow("boolean")        << "({d: true})"        << "{\"d\":true}";
     QTest::newRow("key is array")   << "({[[12, 34]]: 56})" << "{\"12,34\":56}";
     QTest::newRow("value is date")  << "({d: new Date('2000-01-20T12:00:00.000Z')})"  << "{\"d\":\"2000-01-20T12:00:00.000Z\"}";
+
+    // Objects sharing an internal class are serialized from a cached plan, in
+    // insertion order. Make sure that it matches the generic path.
+    QTest::newRow("same shape")
+            << "[{a: 1, b: 'x'}, {a: 2.5, b: 'y'}, {a: -3, b: null}]"
+            << "[{\"a\":1,\"b\":\"x\"},{\"a\":2.5,\"b\":\"y\"},{\"a\":-3,\"b\":null}]";
+    QTest::newRow("reshaped by toJSON")
+            << "(list = [{a: 0, b: {toJSON() { delete list[0].c; return 1; }}, c: 2}, {a: 3, b: 4, c: 5}])"
+            << "[{\"a\":0,\"b\":1},{\"a\":3,\"b\":4,\"c\":5}]";
+    QTest::newRow("getter")
+            << "({get a() { return 1; }, b: 2})"
+            << "{\"a\":1,\"b\":2}";
+    QTest::newRow("escapes")
+            << "({s: 'quote\" backslash\\\\ tab\\t nl\\n ctl\\u0001 long text without escapes'})"
+            << "{\"s\":\"quote\\\" backslash\\\\ tab\\t nl\\n ctl\\u0001 long text without escapes\"}";
 }
 
 void tst_QJSEngine::JSON_Stringify()
@@ -5436,6 +5484,85 @@ void tst_QJSEngine::interrupt()
 #endif
 }
 
+void tst_QJSEngine::executionBudget_data()
+{
+    QTest::addColumn<int>("jitThreshold");
+    QTest::addColumn<QString>("code");
+
+    const int big = (1 << 24);
+    for (int i = 0; i <= big; i += big) {
+        const char *mode = i ? "interpret" : "jit";
+        QTest::addRow("for with content / %s", mode)   << i << "var a = 0; for (;;) { a += 2; }";
+        QTest::addRow("while empty / %s", mode)        << i << "while (true) {}";
+        QTest::addRow("do with content / %s", mode)    << i << "var a = 0; do { a += 2; } while (true);";
+        QTest::addRow("caught / %s", mode)             << i << "for (;;) { try { for (;;) {} } catch (e) {} }";
+        QTest::addRow("calls / %s", mode)              << i << "function f() { return 1; } for (;;) f();";
+    }
+}
+
+void tst_QJSEngine::executionBudget()
+{
+    QFETCH(int, jitThreshold);
+    QFETCH(QString, code);
+
+    TemporaryJitThreshold threshold(jitThreshold);
+    Q_UNUSED(threshold);
+
+    QJSEngine engine;
+    engine.handle()->setExecutionBudget(10);
+
+    const QJSValue result = engine.evaluate(code);
+    QVERIFY(result.isError());
+    QCOMPARE(result.toString(), QLatin1String("Error: Execution time budget of 10 ms exceeded"));
+    QVERIFY(!engine.isInterrupted());
+
+    // The next call gets its own budget.
+    QCOMPARE(engine.evaluate(QStringLiteral("1 + 1")).toInt(), 2);
+    QCOMPARE(engine.handle()->executionBudgetOverruns().size(), 1);
+}
+
+void tst_QJSEngine::executionBudgetCallback()
+{
+    QJSEngine engine;
+    int calls = 0;
+    engine.handle()->setExecutionBudget(5, [&](QV4::Function *function, qint64 elapsed) {
+        [&]() {
+            QVERIFY(function);
+            QCOMPARE(function->name()->toQString(), QLatin1String("spin"));
+            QVERIFY(elapsed >= 5);
+        }();
+        return ++calls < 3;
+    });
+
+    const QJSValue result = engine.evaluate(
+            QStringLiteral("function spin() { for (;;) {} }\nspin();"));
+    QVERIFY(result.isError());
+    QCOMPARE(calls, 3);
+
+    const QHash<QString, int> overruns = engine.handle()->executionBudgetOverruns();
+    QCOMPARE(overruns.size(), 1);
+    QVERIFY(overruns.constBegin().key().startsWith(QLatin1String("spin (")));
+    QCOMPARE(overruns.constBegin().value(), 3);
+}
+
+void tst_QJSEngine::executionBudgetKeepsInterrupt()
+{
+    QJSEngine engine;
+    engine.handle()->setExecutionBudget(5, [&](QV4::Function *, qint64) {
+        // Someone else interrupts the engine before the budget aborts the call.
+        engine.setInterrupted(true);
+        return false;
+    });
+
+    const QJSValue result = engine.evaluate(QStringLiteral("for (;;) {}"));
+    QVERIFY(result.isError());
+
+    // The budget only clears interrupts it has set itself.
+    QVERIFY(engine.isInterrupted());
+    engine.setInterrupted(false);
+    QCOMPARE(engine.evaluate(QStringLiteral("1 + 1")).toInt(), 2);
+}
+
 void tst_QJSEngine::triggerBackwardJumpWithDestructuring()
 {
     QJSEngine engine;
@@ -6615,6 +6742,101 @@ void tst_QJSEngine::multiMatchingRegularExpression()
     QCOMPARE(result.toString(), "33.312.345,897"_L1);
 }
 
+void tst_QJSEngine::megamorphicPropertyLookup()
+{
+    QJSEngine engine;
+    const QJSValue result = engine.evaluate(R"((function() {
+        function read(o) { return o.x; }
+        var proto = { x: 1 };
+        var accessorProto = { get x() { return 2; } };
+        var shapes = [];
+        for (var i = 0; i < 8; ++i) {
+            var o = {};
+            o["p" + i] = i;
+            o.x = 10 + i;
+            shapes.push(o);
+        }
+        var wide = {};
+        for (var i = 0; i < 20; ++i)
+            wide["w" + i] = i;
+        wide.x = 30;
+        shapes.push(wide);
+        shapes.push({ get x() { return 40; } });
+        shapes.push(Object.create(proto));
+        shapes.push(Object.create(accessorProto));
+        shapes.push({ y: 1 });
+        shapes.push("string");
+
+        var results = [];
+        results.push(shapes.map(read).join());
+        proto.x = 3;
+        shapes[0].x = 50;
+        accessorProto.y = 1;
+        gc();
+        results.push(shapes.map(read).join());
+        Object.defineProperty(accessorProto, "x", { value: 4 });
+        results.push(shapes.map(read).join());
+        return results;
+    })())"_L1);
+
+    QVERIFY(result.isArray());
+    QCOMPARE(result.property(0).toString(), "10,11,12,13,14,15,16,17,30,40,1,2,,"_L1);
+    QCOMPARE(result.property(1).toString(), "50,11,12,13,14,15,16,17,30,40,3,2,,"_L1);
+    QCOMPARE(result.property(2).toString(), "50,11,12,13,14,15,16,17,30,40,3,4,,"_L1);
+}
+
+void tst_QJSEngine::appendToFlattenedString()
+{
+    QJSEngine engine;
+    const QJSValue result = engine.evaluate(R"((function() {
+        var s = "";
+        var checksum = 0;
+        for (var i = 0; i < 1000; ++i) {
+            s += String.fromCharCode(97 + i % 26);
+            checksum += s.charCodeAt(i);
+        }
+        // Only one of these may grow s in place.
+        var t = s + "1";
+        var u = s + "2";
+        return [s.length, checksum, t.slice(-3), u.slice(-3), s.slice(-2)].join();
+    })())"_L1);
+
+    QCOMPARE(result.toString(), "1000,109416,kl1,kl2,kl"_L1);
+
+    // s is flattened once and then grows in place, with a logarithmic
+    // number of reallocations.
+    const QV4::StringStatistics &stats = engine.handle()->stringStatistics;
+    QVERIFY(stats.flattenedStrings < 10);
+    QVERIFY(stats.inPlaceAppends > 900);
+    QVERIFY(stats.reallocatingAppends < 20);
+}
+
+void tst_QJSEngine::appendToStringSharedWithCpp()
+{
+    QJSEngine engine;
+    engine.evaluate(R"(
+        var s = "";
+        for (var i = 0; i < 100; ++i) {
+            s += String.fromCharCode(97 + i % 26);
+            s.charCodeAt(i);
+        }
+    )"_L1);
+
+    // The QString shares the text buffer of s. Appending to s must not write into it.
+    const QString kept = engine.globalObject().property("s"_L1).toString();
+    QCOMPARE(kept.size(), 100);
+
+    const QV4::StringStatistics &stats = engine.handle()->stringStatistics;
+    const quint64 inPlaceAppends = stats.inPlaceAppends;
+    const QJSValue appended = engine.evaluate(R"(s += "xyz"; s.slice(-5))"_L1);
+    QCOMPARE(appended.toString(), "uvxyz"_L1);
+    QCOMPARE(stats.inPlaceAppends, inPlaceAppends);
+
+    QCOMPARE(kept.size(), 100);
+    QVERIFY(kept.endsWith("tuv"_L1));
+    QCOMPARE(kept.constData()[kept.size()], QChar());
+}
+
 QTEST_MAIN(tst_QJSEngine)
 
 #include "tst_qjsengine.moc"
@@ -3,6 +3,7 @@
 
 #include <qtest.h>
 
+#include <QCryptographicHash>
 #include <QJsonDocument>
 #include <QQmlComponent>
 #include <QQmlEngine>
@@ -73,6 +74,8 @@ private slots:
     void aotstatsSerialization();
     void aotstatsGeneration_data();
     void aotstatsGeneration();
+
+    void cacheBundle();
 };
 
 // A wrapper around QQmlComponent to ensure the temporary reference counts
@@ -97,6 +100,31 @@ public:
     }
 };
 
+// Runs the qml tool on qmlFileName, with the disk cache in cacheDirectory and the given bundle.
+static bool runWithCacheBundle(const QString &qmlFileName, const QString &cacheDirectory,
+                               const QString &bundleFileName, QByteArray *capturedStderr)
+{
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.remove(QLatin1String("QML_DISABLE_DISK_CACHE"));
+    environment.remove(QLatin1String("QML_DISK_CACHE"));
+    environment.insert(QLatin1String("QML_DISK_CACHE_PATH"), cacheDirectory);
+    if (bundleFileName.isEmpty())
+        environment.remove(QLatin1String("QML_DISK_CACHE_BUNDLE"));
+    else
+        environment.insert(QLatin1String("QML_DISK_CACHE_BUNDLE"), bundleFileName);
+
+    QProcess proc;
+    proc.setProcessEnvironment(environment);
+    proc.setProgram(QLibraryInfo::path(QLibraryInfo::BinariesPath) + QLatin1String("/qml"));
+    proc.setArguments({ QLatin1String("--apptype"), QLatin1String("core"), qmlFileName });
+    proc.start();
+    if (!proc.waitForFinished())
+        return false;
+
+    *capturedStderr = proc.readAllStandardError();
+    return proc.exitStatus() == QProcess::NormalExit && proc.exitCode() == 0;
+}
+
 static bool generateCache(const QString &qmlFileName, QByteArray *capturedStderr = nullptr)
 {
 #if defined(QTEST_CROSS_COMPILED)
@@ -1029,6 +1057,60 @@ void tst_qmlcachegen::aotstatsGeneration()
     }
 }
 
+void tst_qmlcachegen::cacheBundle()
+{
+#if defined(QTEST_CROSS_COMPILED)
+    QSKIP("Cannot call qmlcachegen on cross-compiled target.");
+#endif
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+
+    {
+        QFile qml(tempDir.filePath("main.qml"));
+        QVERIFY(qml.open(QIODevice::WriteOnly));
+        qml.write("import QtQml\n"
+                  "QtObject {\n"
+                  "    Component.onCompleted: {\n"
+                  "        console.log(\"bundled\", 6 * 7);\n"
+                  "        Qt.exit(0);\n"
+                  "    }\n"
+                  "}\n");
+    }
+    const QString qmlFile = QFileInfo(tempDir.filePath("main.qml")).canonicalFilePath();
+    QVERIFY(!qmlFile.isEmpty());
+
+    const QString bundleFile = tempDir.filePath("cache.qmlbundle");
+    QProcess proc;
+    proc.setProgram(QLibraryInfo::path(QLibraryInfo::LibraryExecutablesPath) + "/qmlcachegen"_L1);
+    proc.setArguments({ "--bundle"_L1, "-o"_L1, bundleFile, qmlFile + u'=' + qmlFile });
+    proc.start();
+    QVERIFY(proc.waitForFinished());
+    QVERIFY2(proc.exitStatus() == QProcess::NormalExit && proc.exitCode() == 0,
+             proc.readAllStandardError().constData());
+    QVERIFY(QFileInfo::exists(bundleFile));
+
+    // The per-file cache, as the engine would write it for main.qml
+    const QString cacheFile = cacheDir.filePath(
+            QString::fromLatin1(QCryptographicHash::hash(qmlFile.toUtf8(),
+                                                         QCryptographicHash::Sha1).toHex())
+            + ".qmlc"_L1);
+
+    // The bundle provides the compilation unit. Nothing is compiled, so nothing is cached.
+    QByteArray output;
+    QVERIFY2(runWithCacheBundle(qmlFile, cacheDir.path(), bundleFile, &output),
+             output.constData());
+    QVERIFY2(output.contains("bundled 42"), output.constData());
+    QVERIFY(!QFileInfo::exists(cacheFile));
+
+    // Without the bundle, the document is compiled and cached.
+    QVERIFY2(runWithCacheBundle(qmlFile, cacheDir.path(), QString(), &output),
+             output.constData());
+    QVERIFY2(output.contains("bundled 42"), output.constData());
+    QVERIFY(QFileInfo::exists(cacheFile));
+}
+
 const QQmlScriptString &ScriptStringProps::undef() const
 {
     return m_undef;
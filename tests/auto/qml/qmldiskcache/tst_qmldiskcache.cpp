@@ -3,6 +3,7 @@
 
 #include <qtest.h>
 
+#include <private/qv4compilationunitbundle_p.h>
 #include <private/qv4compileddata_p.h>
 #include <private/qv4compiler_p.h>
 #include <private/qv4engine_p.h>
@@ -42,6 +43,7 @@ private slots:
     void cacheModuleScripts();
     void reuseStaticMappings();
     void invalidateSaveLoadCache();
+    void cacheBundle();
     void duplicateIdsInInlineComponents();
 
     void inlineComponentDoesNotCauseConstantInvalidation_data();
@@ -1187,6 +1189,48 @@ void tst_qmldiskcache::invalidateSaveLoadCache()
     QVERIFY(unit->unitData() != oldUnit->unitData());
 }
 
+void tst_qmldiskcache::cacheBundle()
+{
+    QQmlEngine engine;
+    TestCompiler testCompiler(&engine);
+    QVERIFY(testCompiler.tempDir.isValid());
+
+    const QByteArray contents = QByteArrayLiteral("import QtQml 2.0\n"
+                                                  "QtObject {\n"
+                                                  "    property int a: 5\n"
+                                                  "    property QtObject b: QtObject {}\n"
+                                                  "}");
+    QVERIFY2(testCompiler.compile(contents), qPrintable(testCompiler.lastErrorString));
+
+    QFile cacheFile(testCompiler.cacheFilePath);
+    QVERIFY(cacheFile.open(QIODevice::ReadOnly));
+    const QByteArray unitData = cacheFile.readAll();
+
+    const QString otherPath = testCompiler.tempDir.path() + QStringLiteral("/other.qml");
+    const QString bundlePath = testCompiler.tempDir.path() + QStringLiteral("/cache.qmlbundle");
+    QString errorString;
+    QVERIFY2(QV4::CompilationUnitBundle::write(
+                     bundlePath, { { testCompiler.testFilePath, unitData },
+                                   { otherPath, unitData } }, &errorString),
+             qPrintable(errorString));
+
+    QV4::CompilationUnitBundle bundle;
+    QVERIFY2(bundle.open(bundlePath, &errorString), qPrintable(errorString));
+
+    const QDateTime timeStamp = QFileInfo(testCompiler.testFilePath).lastModified();
+    const QV4::CompiledData::Unit *unit
+            = bundle.get(testCompiler.testFilePath, timeStamp, &errorString);
+    QVERIFY2(unit, qPrintable(errorString));
+    QCOMPARE(unit->unitSize, quint32(unitData.size()));
+    QCOMPARE(unit->qmlUnit()->nObjects, 2u);
+    QCOMPARE(quintptr(unit) % QV4::CompilationUnitBundle::UnitAlignment, quintptr(0));
+
+    QVERIFY(bundle.get(otherPath, timeStamp, &errorString));
+    QVERIFY(!bundle.get(testCompiler.tempDir.path() + QStringLiteral("/missing.qml"),
+                        timeStamp, &errorString));
+    QVERIFY(!bundle.get(testCompiler.testFilePath, timeStamp.addSecs(10), &errorString));
+}
+
 void tst_qmldiskcache::duplicateIdsInInlineComponents()
 {
     // Exercise the case of loading strange generalized group properties from .qmlc.
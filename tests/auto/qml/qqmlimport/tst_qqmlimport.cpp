@@ -4,6 +4,7 @@
 #include <private/qmlutils_p.h>
 #include <private/qqmlengine_p.h>
 #include <private/qqmlimport_p.h>
+#include <private/qqmlpersistentimportcache_p.h>
 
 #include <QtQuick/qquickview.h>
 #include <QtQuick/qquickitem.h>
@@ -16,6 +17,7 @@
 #include <QtQml/qqmlmoduleregistration.h>
 
 #include <QtCore/qscopeguard.h>
+#include <QtCore/qtemporarydir.h>
 #include <QtCore/qlibraryinfo.h>
 #include <QtCore/private/qlibraryinfo_p.h>
 
@@ -59,6 +61,8 @@ private slots:
     void partialImportVersions();
     void registerModuleImport();
     void importDependenciesPrecedence();
+    void persistentImportCache();
+    void persistentImportCacheResourceStamp();
     void cleanup();
     void envResourceImportPath();
     void preferResourcePath_data();
@@ -645,6 +649,124 @@ void tst_QQmlImport::importDependenciesPrecedence()
     QCOMPARE(instance->property("b").toString(), QString::fromLatin1("b"));
 }
 
+void tst_QQmlImport::persistentImportCache()
+{
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    QTemporaryDir importDir;
+    QVERIFY(importDir.isValid());
+
+    const bool hadEnv = qEnvironmentVariableIsSet("QML_DISK_CACHE_PATH");
+    const QByteArray oldEnv = hadEnv ? qgetenv("QML_DISK_CACHE_PATH") : QByteArray();
+    auto guard = qScopeGuard([&] {
+        if (hadEnv)
+            qputenv("QML_DISK_CACHE_PATH", oldEnv);
+        else
+            qunsetenv("QML_DISK_CACHE_PATH");
+    });
+    qputenv("QML_DISK_CACHE_PATH", cacheDir.path().toLocal8Bit());
+
+    {
+        QQmlEngine engine;
+        if (!QQmlEnginePrivate::get(&engine)->typeLoader.persistentImportCache())
+            QSKIP("The disk cache is disabled");
+    }
+
+    const auto writeFile = [](const QString &path, const QByteArray &contents) {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+                && file.write(contents) == contents.size();
+    };
+
+    const auto objectNameOf = [&](const QByteArray &source, int *hits = nullptr) {
+        QQmlEngine engine;
+        engine.addImportPath(importDir.path());
+        QQmlComponent component(&engine);
+        component.setData(source, QUrl::fromLocalFile(importDir.filePath("main.qml")));
+        if (!component.isReady())
+            return component.errorString();
+        if (hits)
+            *hits = QQmlEnginePrivate::get(&engine)->typeLoader.persistentImportCache()->hits();
+        std::unique_ptr<QObject> object(component.create());
+        return object ? object->objectName() : QStringLiteral("no object");
+    };
+
+    QVERIFY(writeFile(importDir.filePath("Cached/qmldir"),
+                      "module Cached\nThing 1.0 First.qml\n"));
+    QVERIFY(writeFile(importDir.filePath("Cached/First.qml"),
+                      "import QtQml\nQtObject { objectName: \"first\" }\n"));
+    QVERIFY(writeFile(importDir.filePath("Cached/Second.qml"),
+                      "import QtQml\nQtObject { objectName: \"second\" }\n"));
+
+    QCOMPARE(objectNameOf("import Cached\nThing {}\n"), QStringLiteral("first"));
+    QVERIFY(QFile::exists(cacheDir.filePath("imports.qmlic")));
+
+    // Resolved from the cache
+    int hits = 0;
+    QCOMPARE(objectNameOf("import Cached\nThing {}\n", &hits), QStringLiteral("first"));
+    QVERIFY(hits > 0);
+
+    // A changed qmldir file is read again
+    QVERIFY(writeFile(importDir.filePath("Cached/qmldir"),
+                      "module Cached\nThing 1.0 Second.qml\n"));
+    {
+        QFile qmldir(importDir.filePath("Cached/qmldir"));
+        QVERIFY(qmldir.open(QIODevice::ReadWrite));
+        QVERIFY(qmldir.setFileTime(QDateTime::currentDateTime().addSecs(10),
+                                   QFileDevice::FileModificationTime));
+    }
+    QCOMPARE(objectNameOf("import Cached\nThing {}\n"), QStringLiteral("second"));
+
+    // A module installed after it was found missing is found
+    QVERIFY(objectNameOf("import Later\nThing {}\n").contains(
+                    QStringLiteral("module \"Later\" is not installed")));
+    QVERIFY(writeFile(importDir.filePath("Later/qmldir"), "module Later\nThing 1.0 First.qml\n"));
+    QVERIFY(writeFile(importDir.filePath("Later/First.qml"),
+                      "import QtQml\nQtObject { objectName: \"later\" }\n"));
+    QCOMPARE(objectNameOf("import Later\nThing {}\n"), QStringLiteral("later"));
+}
+
+void tst_QQmlImport::persistentImportCacheResourceStamp()
+{
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    const QString fileName = cacheDir.filePath("imports.qmlic");
+
+    const QString uri = QStringLiteral("ModuleWithPrefer2");
+    const QTypeRevision version = QTypeRevision::fromVersion(1, 0);
+    const QStringList importPaths = { QStringLiteral("qrc:/qqmlimport") };
+    const QString qmldir = QStringLiteral(":/qqmlimport/ModuleWithPrefer2/qmldir");
+    QVERIFY(QFile::exists(qmldir));
+
+    {
+        QQmlPersistentImportCache cache(fileName, QQmlPersistentImportCache::ReadWrite);
+        cache.setResourceTimeStamp(1000);
+        cache.insertQmldirLocations(
+                uri, version, importPaths,
+                { { qmldir, QStringLiteral("qrc:/qqmlimport/ModuleWithPrefer2/") } }, { qmldir });
+    }
+    QVERIFY(QFile::exists(fileName));
+
+    {
+        QQmlPersistentImportCache cache(fileName, QQmlPersistentImportCache::Read);
+        cache.setResourceTimeStamp(1000);
+        const auto locations = cache.qmldirLocations(uri, version, importPaths);
+        QVERIFY(locations.has_value());
+        QCOMPARE(locations->size(), 1);
+        QCOMPARE(locations->first().filePath, qmldir);
+        QCOMPARE(cache.hits(), 1);
+    }
+
+    {
+        // A new build of the application may come with different resources.
+        QQmlPersistentImportCache cache(fileName, QQmlPersistentImportCache::Read);
+        cache.setResourceTimeStamp(2000);
+        QVERIFY(!cache.qmldirLocations(uri, version, importPaths).has_value());
+        QCOMPARE(cache.hits(), 0);
+        QCOMPARE(cache.outdated(), 1);
+    }
+}
 
 QTEST_MAIN(tst_QQmlImport)
 
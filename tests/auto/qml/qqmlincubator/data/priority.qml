@@ -0,0 +1,6 @@
+import QtQml
+
+QtObject {
+    property QtObject a: QtObject {}
+    property QtObject b: QtObject {}
+}
@@ -47,6 +47,7 @@ private slots:
     void garbageCollection();
     void requiredProperties();
     void deleteInSetInitialState();
+    void priority();
 
 private:
     QQmlIncubationController controller;
@@ -1246,6 +1247,69 @@ void tst_qqmlincubator::deleteInSetInitialState()
     QCOMPARE(incubator.object(), nullptr); // object was deleted
 }
 
+void tst_qqmlincubator::priority()
+{
+    QQmlComponent component(&engine, testFileUrl("priority.qml"));
+    QVERIFY(component.isReady());
+
+    QList<int> completed;
+    class MyIncubator : public QQmlIncubator
+    {
+    public:
+        MyIncubator(QList<int> *completed, int id) : completed(completed), id(id) {}
+    protected:
+        void statusChanged(Status s) override
+        {
+            if (s == Ready)
+                completed->append(id);
+        }
+    private:
+        QList<int> *completed;
+        int id;
+    };
+
+    MyIncubator high(&completed, 1);
+    MyIncubator low(&completed, 2);
+    QQmlIncubatorPrivate::get(&high)->setPriority(QQmlIncubatorPrivate::HighPriority);
+    QQmlIncubatorPrivate::get(&low)->setPriority(QQmlIncubatorPrivate::LowPriority);
+
+    // The incubator started last would run first if they had the same priority.
+    component.create(high);
+    component.create(low);
+    QVERIFY(high.isLoading());
+    QVERIFY(low.isLoading());
+    QCOMPARE(QQmlIncubatorPrivate::get(&high)->completedFraction(), qreal(0));
+
+    while (controller.incubatingObjectCount() > 0)
+        controller.incubateFor(1000);
+
+    QVERIFY(high.isReady());
+    QVERIFY(low.isReady());
+    QCOMPARE(completed, QList<int>({ 1, 2 }));
+
+    const QQmlIncubatorPrivate::Statistics &statistics
+            = QQmlIncubatorPrivate::get(&high)->statistics;
+    QCOMPARE(statistics.objectCount, 3);
+    QVERIFY(statistics.slices >= 1);
+    QCOMPARE(statistics.predictedObjectCount, -1);
+    QVERIFY(!statistics.forced);
+    QCOMPARE(QQmlIncubatorPrivate::get(&high)->completedFraction(), qreal(1));
+
+    delete high.object();
+    delete low.object();
+
+    // The next incubation of the same component uses the earlier ones as prediction.
+    QQmlIncubator again;
+    component.create(again);
+    QVERIFY(again.isLoading());
+    QCOMPARE(QQmlIncubatorPrivate::get(&again)->statistics.predictedObjectCount, 3);
+    QVERIFY(QQmlIncubatorPrivate::get(&again)->predictedObjectNSecs() >= 0);
+    again.forceCompletion();
+    QVERIFY(again.isReady());
+    QVERIFY(QQmlIncubatorPrivate::get(&again)->statistics.forced);
+    delete again.object();
+}
+
 QTEST_MAIN(tst_qqmlincubator)
 
 #include "tst_qqmlincubator.moc"
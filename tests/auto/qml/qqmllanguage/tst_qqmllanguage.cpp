@@ -962,6 +962,15 @@ void tst_qqmllanguage::assignValueTypes()
     //these used to go via script. Ensure they no longer do
     QCOMPARE(object->property("qtEnumTriggeredChange").toBool(), false);
     QCOMPARE(object->property("mirroredEnumTriggeredChange").toBool(), false);
+
+    // Values parsed from strings are prepared when loading the component, not when creating it.
+    const auto *prepared = QQmlComponentPrivate::get(&component)->compilationUnit
+            ->baseCompilationUnit()->literalBindingValues.loadAcquire();
+    QVERIFY(prepared);
+    const QList<QVariant> preparedValues = prepared->values();
+    QVERIFY(preparedValues.contains(QVariant::fromValue(QColor("red"))));
+    QVERIFY(preparedValues.contains(QVariant(QRect(9, 7, 100, 200))));
+    QVERIFY(preparedValues.contains(QVariant::fromValue(QVector3D(10, 1, 2.2f))));
 }
 
 // Test edge case type assignments
@@ -0,0 +1,6 @@
+import QtQml
+import "b.js" as Logic
+
+QtObject {
+    property int value: Logic.value()
+}
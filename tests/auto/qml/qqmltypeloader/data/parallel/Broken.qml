@@ -0,0 +1,6 @@
+import QtQml
+
+QtObject {
+    property int value: 1
+    property int other: (
+}
@@ -0,0 +1,6 @@
+import QtQml
+import "c.js" as Logic
+
+QtObject {
+    property int value: Logic.value()
+}
@@ -0,0 +1,6 @@
+import QtQml
+
+QtObject {
+    property A a: A {}
+    property Broken broken: Broken {}
+}
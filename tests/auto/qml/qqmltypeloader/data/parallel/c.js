@@ -0,0 +1 @@
+function value() { return 3; }
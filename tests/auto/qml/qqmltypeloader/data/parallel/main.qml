@@ -0,0 +1,8 @@
+import QtQml
+
+QtObject {
+    property A a: A {}
+    property B b: B {}
+    property C c: C {}
+    property int sum: a.value + b.value + c.value
+}
@@ -51,6 +51,7 @@ private slots:
     void signalHandlersAreCompatible();
     void loadTypeOnShutdown();
     void floodTypeLoaderEventQueue();
+    void parallelParsing();
 
 private:
     void checkSingleton(const QString & dataDirectory);
@@ -843,6 +844,64 @@ void tst_QQMLTypeLoader::floodTypeLoaderEventQueue()
     }
 }
 
+void tst_QQMLTypeLoader::parallelParsing()
+{
+#ifdef Q_OS_ANDROID
+    QSKIP("Android seems to have problems with QProcess");
+#endif
+
+#if QT_CONFIG(process)
+    // The number of parser threads and the disk cache settings are read only once per process.
+    // Run the actual test in a child process with an empty disk cache, so that the documents
+    // are really parsed, and with parser threads even on machines with a single core.
+    const char *childKey = "QT_TST_QQMLTYPELOADER_PARALLEL_PARSING";
+    if (!qEnvironmentVariableIsSet(childKey)) {
+        QTemporaryDir dir;
+        QProcess child;
+        child.setProgram(QCoreApplication::applicationFilePath());
+        child.setArguments(QStringList(QLatin1String("parallelParsing")));
+        child.setProcessChannelMode(QProcess::ForwardedChannels);
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert(QLatin1String(childKey), QLatin1String("1"));
+        env.insert(QLatin1String("QML_DISK_CACHE_PATH"), dir.path());
+        env.insert(QLatin1String("QML_TYPELOADER_PARSER_THREADS"), QLatin1String("2"));
+        env.remove(QLatin1String("QML_DISABLE_DISK_CACHE"));
+        env.remove(QLatin1String("QML_FORCE_DISK_CACHE"));
+        child.setProcessEnvironment(env);
+        child.start();
+        QVERIFY(child.waitForFinished());
+        QCOMPARE(child.exitStatus(), QProcess::NormalExit);
+        QCOMPARE(child.exitCode(), 0);
+        return;
+    }
+#else
+    QSKIP("Depends on QProcess");
+#endif
+
+    QQmlEngine engine;
+    QQmlTypeLoader &loader = QQmlEnginePrivate::get(&engine)->typeLoader;
+
+    // The dependencies of main.qml, and their scripts, are parsed on the parser threads.
+    {
+        QQmlComponent component(&engine, testFileUrl("parallel/main.qml"));
+        QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+        QScopedPointer<QObject> obj(component.create());
+        QVERIFY(!obj.isNull());
+        QCOMPARE(obj->property("sum").toInt(), 6);
+        QVERIFY(loader.parseJobCount() > 0);
+    }
+
+    // Errors found on a parser thread are reported just like any other.
+    {
+        QQmlComponent component(&engine, testFileUrl("parallel/brokenuser.qml"));
+        QVERIFY(component.isError());
+        const QList<QQmlError> errors = component.errors();
+        QVERIFY(std::any_of(errors.begin(), errors.end(), [&](const QQmlError &error) {
+            return error.url() == testFileUrl("parallel/Broken.qml");
+        }));
+    }
+}
+
 QTEST_MAIN(tst_QQMLTypeLoader)
 
 #include "tst_qqmltypeloader.moc"
@@ -0,0 +1,31 @@
+import QtQml
+
+QtObject {
+    property string url
+    property int chunks: 0
+    property int chunkBytes: 0
+    property int loaded: -1
+    property int total: -1
+    property int responseSize: -1
+    property bool sameResponse: false
+
+    Component.onCompleted: {
+        var request = new XMLHttpRequest();
+        request.open("GET", url);
+        request.responseType = "arraybuffer";
+
+        request.onprogress = function(event) {
+            ++chunks;
+            chunkBytes += event.chunk.byteLength;
+            loaded = event.loaded;
+            total = event.lengthComputable ? event.total : -1;
+        }
+
+        request.onload = function() {
+            sameResponse = request.response === request.response;
+            responseSize = request.response.byteLength;
+        }
+
+        request.send();
+    }
+}
@@ -69,6 +69,8 @@ private slots:
     void getAllResponseHeaders_args();
     void getBinaryData();
     void getJsonData();
+    void getJsonDataThreaded();
+    void progress();
     void status();
     void status_data();
     void statusText();
@@ -898,6 +900,56 @@ void tst_qqmlxmlhttprequest::getJsonData()
     QTRY_VERIFY(object->property("result").toBool());
 }
 
+void tst_qqmlxmlhttprequest::getJsonDataThreaded()
+{
+    if (qEnvironmentVariableIsSet("QML_XHR_THREADED_JSON")) {
+        QQmlComponent component(engine.get(), testFileUrl("receiveJsonData.qml"));
+        QScopedPointer<QObject> object(component.createWithInitialProperties(
+                {{"url", testFileUrl("json.data").toString()}}));
+        QVERIFY2(!object.isNull(), qPrintable(component.errorString()));
+        QTRY_VERIFY(object->property("result").toBool());
+        return;
+    }
+
+#if QT_CONFIG(process)
+#ifdef Q_OS_ANDROID
+    QSKIP("Trying to run the main app .so lib crashes on Android (QTBUG-99214)");
+#endif
+    // The option is cached, so run the test again in a process that has it set.
+    QProcess child;
+    child.setProgram(QCoreApplication::applicationFilePath());
+    child.setArguments(QStringList(QLatin1String("getJsonDataThreaded")));
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert(QLatin1String("QML_XHR_THREADED_JSON"), QLatin1String("1"));
+    child.setProcessEnvironment(env);
+    child.start();
+    QVERIFY(child.waitForFinished());
+    QCOMPARE(child.exitCode(), 0);
+#else
+    QSKIP("This test needs to start a process with QML_XHR_THREADED_JSON set.");
+#endif
+}
+
+void tst_qqmlxmlhttprequest::progress()
+{
+    const QUrl url = testFileUrl("qml_logo.png");
+    if (!url.isLocalFile())
+        QSKIP("The test data needs to be a local file.");
+
+    QQmlComponent component(engine.get(), testFileUrl("progress.qml"));
+    QScopedPointer<QObject> object(component.createWithInitialProperties(
+            {{"url", url.toString()}}));
+    QVERIFY2(!object.isNull(), qPrintable(component.errorString()));
+
+    const int size = QFileInfo(testFile("qml_logo.png")).size();
+    QTRY_COMPARE(object->property("responseSize").toInt(), size);
+    QVERIFY(object->property("sameResponse").toBool());
+    QVERIFY(object->property("chunks").toInt() > 0);
+    QCOMPARE(object->property("chunkBytes").toInt(), size);
+    QCOMPARE(object->property("loaded").toInt(), size);
+    QCOMPARE(object->property("total").toInt(), size);
+}
+
 void tst_qqmlxmlhttprequest::status()
 {
     QFETCH(QUrl, replyUrl);
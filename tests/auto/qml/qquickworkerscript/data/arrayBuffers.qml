@@ -0,0 +1,29 @@
+import QtQml
+import QtQml.WorkerScript
+
+WorkerScript {
+    id: worker
+    source: "script_arrayBuffers.js"
+
+    property var shared: new SharedArrayBuffer(16)
+    property int lengthAfterTransfer: -1
+    property bool received: false
+    property int sharedValue: 0
+
+    signal done()
+
+    function transfer() {
+        const bytes = new Uint8Array(1024 * 1024);
+        for (let i = 0; i < bytes.length; ++i)
+            bytes[i] = i % 251;
+        worker.sendMessage({ bytes: bytes, shared: new Int32Array(shared) }, [bytes.buffer]);
+        lengthAfterTransfer = bytes.buffer.byteLength;
+    }
+
+    onMessage: (messageObject) => {
+        received = messageObject.ok && messageObject.buffer instanceof ArrayBuffer
+                && messageObject.buffer.byteLength === 1024 * 1024;
+        sharedValue = Atomics.load(new Int32Array(shared), 0);
+        worker.done();
+    }
+}
@@ -0,0 +1,45 @@
+import QtQml
+import QtQml.WorkerScript
+
+WorkerScript {
+    id: worker
+    source: "script_atomicsWait.js"
+
+    // [0] is waited on, [1] is set by the worker right before its final wait.
+    property var view: new Int32Array(new SharedArrayBuffer(8))
+    property string result
+    property string mainThreadError
+    property int woken: 0
+
+    property Timer notifier: Timer {
+        interval: 10
+        repeat: true
+        onTriggered: {
+            // The worker may not have entered the wait yet, even though it has set the flag.
+            // Notifying nobody has no effect, so keep trying until the worker is woken.
+            if (Atomics.load(worker.view, 1) === 1) {
+                worker.woken += Atomics.notify(worker.view, 0);
+                if (worker.woken > 0)
+                    worker.notifier.stop();
+            }
+        }
+    }
+
+    signal done()
+
+    function start() {
+        try {
+            Atomics.wait(view, 0, 0, 0);
+        } catch (e) {
+            mainThreadError = e.name;
+        }
+        worker.sendMessage(view);
+        notifier.start();
+    }
+
+    onMessage: (messageObject) => {
+        notifier.stop();
+        result = messageObject;
+        worker.done();
+    }
+}
@@ -0,0 +1,9 @@
+WorkerScript.onMessage = function(message) {
+    const bytes = message.bytes;
+    let ok = bytes instanceof Uint8Array && bytes.length === 1024 * 1024;
+    for (let i = 0; ok && i < bytes.length; ++i)
+        ok = bytes[i] === i % 251;
+
+    Atomics.store(message.shared, 0, 42);
+    WorkerScript.sendMessage({ ok: ok, buffer: bytes.buffer }, [bytes.buffer]);
+}
@@ -0,0 +1,9 @@
+WorkerScript.onMessage = function(view) {
+    const notEqual = Atomics.wait(view, 0, 1, 0);
+    const timedOut = Atomics.wait(view, 0, 0, 10);
+    // Tell the GUI thread that we are about to block, then block until it calls
+    // Atomics.notify().
+    Atomics.store(view, 1, 1);
+    const woken = Atomics.wait(view, 0, 0);
+    WorkerScript.sendMessage([notEqual, timedOut, woken].join());
+}
@@ -0,0 +1,27 @@
+import QtQml
+import QtQml.WorkerScript
+
+QtObject {
+    id: root
+
+    property int responses: 0
+
+    property list<QtObject> workers: [
+        WorkerScript { source: "script.js"; onMessage: ++root.responses },
+        WorkerScript { source: "script.js"; onMessage: ++root.responses },
+        WorkerScript { source: "script.js"; onMessage: ++root.responses },
+        WorkerScript {
+            objectName: "dedicated"
+            dedicatedThread: true
+            source: "script.js"
+            onMessage: ++root.responses
+        }
+    ]
+
+    function sendToAll(count) {
+        for (let i = 0; i < count; ++i) {
+            for (let j = 0; j < workers.length; ++j)
+                workers[j].sendMessage(i)
+        }
+    }
+}
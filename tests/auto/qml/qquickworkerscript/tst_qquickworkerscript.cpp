@@ -15,6 +15,8 @@
 #include <private/qqmlengine_p.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 
+using namespace Qt::StringLiterals;
+
 class tst_QQuickWorkerScript : public QQmlDataTest
 {
     Q_OBJECT
@@ -28,6 +30,8 @@ private slots:
     void messaging_sendQObjectList();
     void messaging_sendJsObject();
     void messaging_sendExternalObject();
+    void messaging_arrayBuffers();
+    void atomicsWait();
     void script_with_pragma();
     void script_included();
     void scriptError_onLoad();
@@ -36,6 +40,7 @@ private slots:
     void script_var();
     void stressDispose();
     void xmlHttpRequest();
+    void threadPool();
 
 private:
     void waitForEchoMessage(QQuickWorkerScript *worker) {
@@ -193,6 +198,37 @@ void tst_QQuickWorkerScript::messaging_sendExternalObject()
     QTest::qWait(100); // shouldn't crash.
 }
 
+void tst_QQuickWorkerScript::messaging_arrayBuffers()
+{
+    QQmlComponent component(&m_engine, testFileUrl("arrayBuffers.qml"));
+    std::unique_ptr<QQuickWorkerScript> worker { qobject_cast<QQuickWorkerScript*>(component.create()) };
+    QVERIFY2(worker, qPrintable(component.errorString()));
+
+    QVERIFY(QMetaObject::invokeMethod(worker.get(), "transfer"));
+    // The transferred buffer is detached on the sending side.
+    QCOMPARE(worker->property("lengthAfterTransfer").toInt(), 0);
+
+    waitForEchoMessage(worker.get());
+    QVERIFY(worker->property("received").toBool());
+    // The worker wrote to the SharedArrayBuffer we sent. We see it in our copy.
+    QCOMPARE(worker->property("sharedValue").toInt(), 42);
+}
+
+void tst_QQuickWorkerScript::atomicsWait()
+{
+    QQmlComponent component(&m_engine, testFileUrl("atomicsWait.qml"));
+    std::unique_ptr<QQuickWorkerScript> worker { qobject_cast<QQuickWorkerScript*>(component.create()) };
+    QVERIFY2(worker, qPrintable(component.errorString()));
+
+    QVERIFY(QMetaObject::invokeMethod(worker.get(), "start"));
+    // The GUI thread must not block.
+    QCOMPARE(worker->property("mainThreadError").toString(), u"TypeError"_s);
+
+    waitForEchoMessage(worker.get());
+    QCOMPARE(worker->property("result").toString(), u"not-equal,timed-out,ok"_s);
+    QCOMPARE(worker->property("woken").toInt(), 1);
+}
+
 void tst_QQuickWorkerScript::script_with_pragma()
 {
     QVariant value(100);
@@ -319,6 +355,44 @@ void tst_QQuickWorkerScript::xmlHttpRequest()
     QVERIFY(root);
 }
 
+void tst_QQuickWorkerScript::threadPool()
+{
+    // The pool size is read when the first WorkerScript of an engine starts.
+    qputenv("QML_WORKERSCRIPT_THREAD_COUNT", "2");
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("workerPool.qml"));
+    std::unique_ptr<QObject> root { component.create() };
+    qunsetenv("QML_WORKERSCRIPT_THREAD_COUNT");
+    QVERIFY2(root, qPrintable(component.errorString()));
+
+    auto *pool = qobject_cast<QQuickWorkerScriptEnginePool *>(
+            QQmlEnginePrivate::get(&engine)->workerScriptEnginePool);
+    QVERIFY(pool);
+    QCOMPARE(pool->maxThreadCount(), 2);
+    // Three shared workers on two threads, plus the dedicated one.
+    QCOMPARE(pool->threadCount(), 3);
+
+    const QList<QQuickWorkerScript *> workers = root->findChildren<QQuickWorkerScript *>();
+    QCOMPARE(workers.size(), 4);
+    for (QQuickWorkerScript *worker : workers)
+        QTRY_VERIFY(worker->ready());
+
+    QVERIFY(QMetaObject::invokeMethod(root.get(), "sendToAll", Q_ARG(QVariant, 10)));
+    QTRY_COMPARE(root->property("responses").toInt(), 40);
+    for (QQuickWorkerScript *worker : workers) {
+        QCOMPARE(worker->pendingMessageCount(), 0);
+        QVERIFY(worker->peakPendingMessageCount() >= 1);
+        QVERIFY(worker->peakPendingMessageCount() <= 10);
+    }
+
+    // The dedicated thread goes away with its worker. Shared ones are kept for later workers.
+    QQuickWorkerScript *dedicated = root->findChild<QQuickWorkerScript *>(u"dedicated"_s);
+    QVERIFY(dedicated);
+    QVERIFY(dedicated->dedicatedThread());
+    delete dedicated;
+    QCOMPARE(pool->threadCount(), 2);
+}
+
 QTEST_MAIN(tst_QQuickWorkerScript)
 
 #include "tst_qquickworkerscript.moc"
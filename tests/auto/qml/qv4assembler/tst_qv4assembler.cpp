@@ -5,17 +5,24 @@
 #if QT_CONFIG(process)
 #include <QtCore/qprocess.h>
 #endif
+#include <QtCore/qtemporarydir.h>
 #include <QtCore/qtemporaryfile.h>
+#include <QtQml/qjsengine.h>
 #include <QtQml/qqml.h>
 #include <QtQml/qqmlapplicationengine.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 
+#include <private/qjsvalue_p.h>
+#include <private/qv4function_p.h>
+#include <private/qv4functionobject_p.h>
 #include <private/qv4global_p.h>
 
 #ifdef Q_OS_WIN
 #include <qt_windows.h>
 #endif
 
+using namespace Qt::StringLiterals;
+
 class tst_QV4Assembler : public QQmlDataTest
 {
     Q_OBJECT
@@ -26,8 +33,11 @@ public:
 private slots:
     void initTestCase() override;
     void perfMapFile();
+    void jitDumpFile();
     void functionTable();
     void jitEnabled();
+    void optimizingTier();
+    void onStackReplacement();
 };
 
 tst_QV4Assembler::tst_QV4Assembler()
@@ -38,6 +48,7 @@ tst_QV4Assembler::tst_QV4Assembler()
 void tst_QV4Assembler::initTestCase()
 {
     qputenv("QV4_JIT_CALL_THRESHOLD", "0");
+    qputenv("QV4_JIT_OPTIMIZE_CALL_THRESHOLD", "2");
     QQmlDataTest::initTestCase();
 }
 
@@ -90,6 +101,117 @@ void tst_QV4Assembler::perfMapFile()
 #endif
 }
 
+void tst_QV4Assembler::jitDumpFile()
+{
+#if !QT_CONFIG(process)
+    QSKIP("Depends on QProcess");
+#elif !defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
+    QSKIP("jitdump files are only generated on linux");
+#else
+    const QString qmljs = QLibraryInfo::path(QLibraryInfo::BinariesPath) + "/qmljs";
+    QProcess process;
+
+    QTemporaryFile infile;
+    QVERIFY(infile.open());
+    infile.write("'use strict'; function foo() { return 42 }; foo();");
+    infile.close();
+
+    QTemporaryDir dumpDir;
+    QVERIFY(dumpDir.isValid());
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("QV4_PROFILE_WRITE_PERF_JITDUMP", "1");
+    environment.insert("JITDUMPDIR", dumpDir.path());
+    environment.insert("QV4_JIT_CALL_THRESHOLD", "0");
+
+    process.setProcessEnvironment(environment);
+    process.start(qmljs, QStringList({infile.fileName()}));
+    QVERIFY(process.waitForStarted());
+    const qint64 pid = process.processId();
+    QVERIFY(pid != 0);
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(process.exitCode(), 0);
+
+    QFile file(dumpDir.filePath(QString::fromLatin1("jit-%1.dump").arg(pid)));
+    QVERIFY(file.exists());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray contents = file.readAll();
+
+    const auto read32 = [&](qsizetype offset) {
+        quint32 value = 0;
+        memcpy(&value, contents.constData() + offset, sizeof(value));
+        return value;
+    };
+    const auto read64 = [&](qsizetype offset) {
+        quint64 value = 0;
+        memcpy(&value, contents.constData() + offset, sizeof(value));
+        return value;
+    };
+
+    // magic, version, header size, ELF machine, padding, pid, timestamp, flags
+    const qsizetype fileHeaderSize = 6 * sizeof(quint32) + 2 * sizeof(quint64);
+    QVERIFY(contents.size() >= fileHeaderSize);
+    QCOMPARE(read32(0), 0x4A695444u);
+    QCOMPARE(read32(8), quint32(fileHeaderSize));
+    QCOMPARE(read32(20), quint32(pid));
+
+    // Each record starts with its type, its total size and a timestamp. A code load record
+    // (type 0) continues with pid, tid, vma, code address, code size and code index, followed
+    // by the function name. A debug info record (type 2) continues with the code address and
+    // the number of entries. Each entry holds a code address, a line and a discriminator,
+    // followed by the source file name.
+    const qsizetype recordHeaderSize = 2 * sizeof(quint32) + sizeof(quint64);
+    const qsizetype codeLoadSize = recordHeaderSize + 2 * sizeof(quint32) + 4 * sizeof(quint64);
+    const qsizetype debugInfoSize = recordHeaderSize + 2 * sizeof(quint64);
+    const qsizetype debugEntrySize = sizeof(quint64) + 2 * sizeof(quint32);
+    const QByteArray sourceFile = infile.fileName().toUtf8();
+
+    QList<QByteArray> functions;
+    quint64 fooAddress = 0;
+    QHash<quint64, QList<quint32>> debugInfoLines;
+    for (qsizetype offset = fileHeaderSize; offset < contents.size();) {
+        QVERIFY(offset + recordHeaderSize <= contents.size());
+        const quint32 type = read32(offset);
+        const quint32 size = read32(offset + sizeof(quint32));
+        QVERIFY(size >= recordHeaderSize);
+        QVERIFY(offset + size <= contents.size());
+        if (type == 0) {
+            QVERIFY(size > codeLoadSize);
+            const QByteArray name(contents.constData() + offset + codeLoadSize);
+            if (name == "foo") {
+                fooAddress = read64(
+                        offset + recordHeaderSize + 2 * sizeof(quint32) + sizeof(quint64));
+            }
+            functions.append(name);
+        } else if (type == 2) {
+            QVERIFY(size >= debugInfoSize);
+            const quint64 codeAddress = read64(offset + recordHeaderSize);
+            const quint64 entryCount = read64(offset + recordHeaderSize + sizeof(quint64));
+            QList<quint32> &lines = debugInfoLines[codeAddress];
+            qsizetype entry = offset + debugInfoSize;
+            for (quint64 i = 0; i < entryCount; ++i) {
+                QVERIFY(entry + debugEntrySize < offset + size);
+                QVERIFY(read64(entry) >= codeAddress);
+                lines.append(read32(entry + sizeof(quint64)));
+                const QByteArray entryFile(contents.constData() + entry + debugEntrySize);
+                QCOMPARE(entryFile, sourceFile);
+                entry += debugEntrySize + entryFile.size() + 1;
+            }
+            QCOMPARE(entry, offset + size);
+        }
+        offset += size;
+    }
+    QVERIFY(functions.contains("foo"));
+
+    // The line table of foo describes the code loaded for it. All of foo is on line 1.
+    QVERIFY(fooAddress != 0);
+    const QList<quint32> fooLines = debugInfoLines.value(fooAddress);
+    QVERIFY(!fooLines.isEmpty());
+    for (quint32 line : fooLines)
+        QCOMPARE(line, 1u);
+#endif
+}
+
 #ifdef Q_OS_WIN
 class Crash : public QObject
 {
@@ -143,7 +265,117 @@ void tst_QV4Assembler::jitEnabled()
 #endif
 }
 
+static const char numberArithmetic[] = R"(
+    function f(a, b) {
+        return [a + b, a - b, a * b, a / b, Object.is(a * b, -0),
+                a < b, a <= b, a > b, a >= b, a == b, a != b, a === b, a !== b].join();
+    }
+    var results;
+    for (var i = 0; i < 20; ++i) {
+        results = [f(1.5, 0.25), f(7, 2), f(6, 3), f(0.1, 0), f(0, 0), f(-0, 1), f(0, -1),
+                   f(Infinity, Infinity), f(NaN, 1), f(2147483647, 1), f(-2147483648, -1),
+                   f(1, 1.0), f("a", 1.5), f(true, 0.5)].join(";");
+    }
+    results;
+)";
+
+void tst_QV4Assembler::optimizingTier()
+{
+    // QV4_JIT_OPTIMIZE_CALL_THRESHOLD is set in initTestCase(), before the first engine exists.
+    QJSEngine engine;
+    const QStringList results
+            = engine.evaluate(QLatin1String(numberArithmetic)).toString().split(u';');
+    const QStringList expected = {
+        u"1.75,1.25,0.375,6,false,false,false,true,true,false,true,false,true"_s,
+        u"9,5,14,3.5,false,false,false,true,true,false,true,false,true"_s,
+        u"9,3,18,2,false,false,false,true,true,false,true,false,true"_s,
+        u"0.1,0.1,0,Infinity,false,false,false,true,true,false,true,false,true"_s,
+        u"0,0,0,NaN,false,false,true,false,true,true,false,true,false"_s,
+        u"1,-1,0,0,true,true,true,false,false,false,true,false,true"_s,
+        u"-1,1,0,0,true,false,false,true,true,false,true,false,true"_s,
+        u"Infinity,NaN,Infinity,NaN,false,false,true,false,true,true,false,true,false"_s,
+        u"NaN,NaN,NaN,NaN,false,false,false,false,false,false,true,false,true"_s,
+        u"2147483648,2147483646,2147483647,2147483647,false,false,false,true,true,false,true,false,true"_s,
+        u"-2147483649,-2147483647,2147483648,2147483648,false,true,true,false,false,false,true,false,true"_s,
+        u"2,0,1,1,false,false,true,false,true,true,false,true,false"_s,
+        u"a1.5,NaN,NaN,NaN,false,false,false,false,false,false,true,false,true"_s,
+        u"1.5,0.5,0.5,2,false,false,false,true,true,false,true,false,true"_s,
+    };
+    QCOMPARE(results, expected);
+
+#if QT_CONFIG(qml_jit)
+    const QJSValue f = engine.globalObject().property(QStringLiteral("f"));
+    const QV4::JavaScriptFunctionObject *functionObject
+            = QJSValuePrivate::asManagedType<QV4::JavaScriptFunctionObject>(&f);
+    QVERIFY(functionObject);
+    const QV4::Function *function = functionObject->function();
+    QVERIFY(function->arithmeticFeedback > 0);
+    QVERIFY(function->supersededCodeRef);
+    QVERIFY(function->jittedCode);
+#endif
+}
+
+void tst_QV4Assembler::onStackReplacement()
+{
+#if !QT_CONFIG(process)
+    QSKIP("Depends on QProcess");
+#elif !defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
+    QSKIP("perf map files are only generated on linux");
+#elif !QT_CONFIG(qml_jit)
+    QSKIP("Depends on the JIT");
+#else
+    const QString qmljs = QLibraryInfo::path(QLibraryInfo::BinariesPath) + "/qmljs";
+    QProcess process;
+
+    // g() is called only once. It can only end up in the perf map by entering jitted code
+    // from one of its loops. The loops have to produce the same result as in the interpreter.
+    QTemporaryFile infile;
+    QVERIFY(infile.open());
+    infile.write(R"(
+        function g(n) {
+            var sum = 0;
+            var text = "";
+            for (var i = 0; i < n; ++i) {
+                sum += i % 7;
+                var j = 0;
+                while (j < 3)
+                    ++j;
+                do {
+                    sum -= 1;
+                } while (sum % 5 === 0);
+                if (i % 500 === 0)
+                    text += i;
+            }
+            return sum + ":" + text;
+        }
+        var result = g(5000);
+        if (result !== "8924:050010001500200025003000350040004500")
+            throw new Error(result);
+    )");
+    infile.close();
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("QV4_PROFILE_WRITE_PERF_MAP", "1");
+    environment.insert("QV4_JIT_CALL_THRESHOLD", "100");
+    environment.insert("QV4_JIT_LOOP_THRESHOLD", "10");
+
+    process.setProcessEnvironment(environment);
+    process.start(qmljs, QStringList({infile.fileName()}));
+    QVERIFY(process.waitForStarted());
+    const qint64 pid = process.processId();
+    QVERIFY(pid != 0);
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(process.exitCode(), 0);
+
+    QFile file(QString::fromLatin1("/tmp/perf-%1.map").arg(pid));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QList<QByteArray> functions;
+    while (!file.atEnd())
+        functions.append(file.readLine().split(' ').value(2));
+    QVERIFY(functions.contains("g\n"));
+#endif
+}
+
 QTEST_MAIN(tst_QV4Assembler)
 
 #include "tst_qv4assembler.moc"
-
@@ -3,6 +3,8 @@
 
 #include <qtest.h>
 #include <private/qv4estable_p.h>
+#include <private/qv4engine_p.h>
+#include <private/qv4scopedvalue_p.h>
 
 class tst_qv4estable : public QObject
 {
@@ -10,6 +12,8 @@ class tst_qv4estable : public QObject
 
 private slots:
     void checkRemoveAvoidsHeapBufferOverflow();
+    void lookupUsesSameValueZero();
+    void indexSurvivesRemovalAndGrowth();
 };
 
 // QTBUG-123999
@@ -35,6 +39,80 @@ void tst_qv4estable::checkRemoveAvoidsHeapBufferOverflow()
     estable.remove(QV4::Value::fromUInt32(0));
 }
 
+void tst_qv4estable::lookupUsesSameValueZero()
+{
+    QV4::ExecutionEngine engine;
+    QV4::Scope scope(&engine);
+    QV4::ESTable estable;
+
+    estable.set(QV4::Value::fromInt32(1), QV4::Value::fromInt32(10));
+    QVERIFY(estable.has(QV4::Value::fromDouble(1.0)));
+    QCOMPARE(QV4::Value::fromReturnedValue(estable.get(QV4::Value::fromDouble(1.0))).toInt32(), 10);
+
+    estable.set(QV4::Value::fromDouble(-0.0), QV4::Value::fromInt32(20));
+    QVERIFY(estable.has(QV4::Value::fromDouble(0.0)));
+    QVERIFY(estable.has(QV4::Value::fromInt32(0)));
+
+    estable.set(QV4::Value::fromDouble(qQNaN()), QV4::Value::fromInt32(30));
+    QVERIFY(estable.has(QV4::Value::fromDouble(qQNaN())));
+
+    // Distinct string objects with the same content are the same key.
+    QV4::ScopedValue a(scope, engine.newString(QStringLiteral("key")));
+    QV4::ScopedValue b(scope, engine.newString(QStringLiteral("key")));
+    QVERIFY(a->heapObject() != b->heapObject());
+    estable.set(a, QV4::Value::fromInt32(40));
+    QVERIFY(estable.has(b));
+
+    // Objects are compared by identity.
+    QV4::ScopedValue o1(scope, engine.newObject());
+    QV4::ScopedValue o2(scope, engine.newObject());
+    estable.set(o1, QV4::Value::fromInt32(50));
+    QVERIFY(estable.has(o1));
+    QVERIFY(!estable.has(o2));
+
+    QCOMPARE(estable.size(), 5U);
+}
+
+void tst_qv4estable::indexSurvivesRemovalAndGrowth()
+{
+    QV4::ESTable estable;
+
+    const int count = 1000;
+    for (int i = 0; i < count; ++i)
+        estable.set(QV4::Value::fromInt32(i), QV4::Value::fromInt32(i * 2));
+    QCOMPARE(estable.size(), uint(count));
+
+    // Remove every third key, from the front, the middle and the back.
+    for (int i = 0; i < count; i += 3)
+        QVERIFY(estable.remove(QV4::Value::fromInt32(i)));
+    QVERIFY(estable.remove(QV4::Value::fromInt32(count - 1)));
+    QVERIFY(!estable.remove(QV4::Value::fromInt32(count - 1)));
+
+    for (int i = 0; i < count; ++i) {
+        const bool expected = i % 3 != 0 && i != count - 1;
+        bool found = false;
+        const QV4::Value v = QV4::Value::fromReturnedValue(
+                estable.get(QV4::Value::fromInt32(i), &found));
+        QCOMPARE(found, expected);
+        if (expected)
+            QCOMPARE(v.toInt32(), i * 2);
+    }
+
+    // Insertion order is preserved.
+    QV4::Value key;
+    QV4::Value value;
+    int previous = -1;
+    for (uint i = 0; i < estable.size(); ++i) {
+        estable.iterate(i, &key, &value);
+        QVERIFY(key.toInt32() > previous);
+        previous = key.toInt32();
+    }
+
+    estable.clear();
+    QCOMPARE(estable.size(), 0U);
+    QVERIFY(!estable.has(QV4::Value::fromInt32(1)));
+}
+
 QTEST_MAIN(tst_qv4estable)
 
 #include "tst_qv4estable.moc"
@@ -5,9 +5,14 @@
 #include <QQmlEngine>
 #include <QLoggingCategory>
 #include <QQmlComponent>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 #include <private/qv4mm_p.h>
 #include <private/qv4qobjectwrapper_p.h>
+#include <private/qjsengine_p.h>
 #include <private/qjsvalue_p.h>
 #include <private/qqmlengine_p.h>
 #include <private/qv4identifiertable_p.h>
@@ -47,6 +52,8 @@ private slots:
     void forInOnProxyMarksTarget();
     void allocWithMemberDataMidwayDrain();
     void markObjectWrappersAfterMarkWeakValues();
+    void heapSnapshot();
+    void releaseUnusedMemory();
 };
 
 tst_qv4mm::tst_qv4mm()
@@ -834,6 +841,97 @@ void tst_qv4mm::markObjectWrappersAfterMarkWeakValues()
     QCOMPARE(qvariant_cast<QObject *>(retrieved)->objectName(), "yep");
 }
 
+void tst_qv4mm::heapSnapshot()
+{
+    QJSEngine engine;
+    engine.evaluate(QStringLiteral(
+            "var holder = [];"
+            "for (var i = 0; i < 1000; ++i) holder.push({ index: i });"
+            "var marker = 'heap' + 'snapshot' + 'marker';"));
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(engine.handle()->memoryManager->writeHeapSnapshot(&buffer));
+
+    QJsonParseError error;
+    const QJsonObject snapshot = QJsonDocument::fromJson(buffer.data(), &error).object();
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    const QJsonObject meta = snapshot["snapshot"]["meta"].toObject();
+    const QJsonArray nodeFields = meta["node_fields"].toArray();
+    QCOMPARE(nodeFields.last().toString(), QStringLiteral("retained_size"));
+    const int fieldCount = nodeFields.size();
+
+    const QJsonArray nodes = snapshot["nodes"].toArray();
+    const QJsonArray edges = snapshot["edges"].toArray();
+    const QJsonArray strings = snapshot["strings"].toArray();
+    const int nodeCount = snapshot["snapshot"]["node_count"].toInt();
+    QCOMPARE(nodes.size(), nodeCount * fieldCount);
+    QCOMPARE(edges.size(), snapshot["snapshot"]["edge_count"].toInt() * 3);
+    QVERIFY(strings.contains(QStringLiteral("heapsnapshotmarker")));
+
+    // Everything is retained by the root, and the array retains its 1000 objects
+    qint64 totalSize = 0;
+    qint64 totalEdges = 0;
+    bool foundArray = false;
+    for (int i = 0; i < nodeCount; ++i) {
+        const qint64 selfSize = nodes[i * fieldCount + 3].toInteger();
+        const qint64 retainedSize = nodes[i * fieldCount + 5].toInteger();
+        QVERIFY(retainedSize >= selfSize);
+        totalSize += selfSize;
+        totalEdges += nodes[i * fieldCount + 4].toInteger();
+        if (strings[nodes[i * fieldCount + 1].toInt()].toString() == QStringLiteral("ArrayObject")
+                && retainedSize > 1000 * 32) {
+            foundArray = true;
+        }
+    }
+    QCOMPARE(nodes[5].toInteger(), totalSize);
+    QCOMPARE(totalEdges, edges.size() / 3);
+    QVERIFY(foundArray);
+}
+
+void tst_qv4mm::releaseUnusedMemory()
+{
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+
+    // Keep every thousandth object alive, so that some chunks are sparse rather than empty.
+    engine.evaluate(QStringLiteral(
+            "var kept = [];"
+            "var garbage = [];"
+            "for (var i = 0; i < 100000; ++i) {"
+            "    var o = { index: i, name: 'object' + i };"
+            "    if (i % 1000 == 0) kept.push(o); else garbage.push(o);"
+            "}"
+            "garbage = null;"));
+
+    const size_t usedBefore = mm->getUsedMem();
+    const size_t allocatedBefore = mm->getAllocatedMem();
+
+    const size_t released = QJSEnginePrivate::releaseUnusedMemory(&engine);
+    QVERIFY(!engine.handle()->isGCOngoing);
+
+    const size_t usedAfter = mm->getUsedMem();
+    const size_t allocatedAfter = mm->getAllocatedMem();
+    QVERIFY(usedAfter < usedBefore);
+    QVERIFY(allocatedAfter <= allocatedBefore);
+    QVERIFY(released <= allocatedAfter - usedAfter);
+
+    // What is committed afterwards is less than before.
+    QVERIFY(allocatedAfter - released < allocatedBefore);
+
+    // The surviving objects are still intact.
+    QCOMPARE(engine.evaluate(QStringLiteral("kept.length")).toInt(), 100);
+    QCOMPARE(engine.evaluate(QStringLiteral("kept[99].name")).toString(),
+             QStringLiteral("object99000"));
+
+    // The statistics are consistent with the memory manager's view.
+    const QV4::MemoryManager::ReleaseStatistics statistics = mm->releaseUnusedMemory();
+    QCOMPARE(statistics.allocatedAfter, mm->getAllocatedMem());
+    QCOMPARE(statistics.usedAfter, mm->getUsedMem());
+    QVERIFY(statistics.usedAfter <= statistics.usedBefore);
+}
+
 QTEST_MAIN(tst_qv4mm)
 
 #include "tst_qv4mm.moc"
@@ -3,15 +3,104 @@
 
 #include <qtest.h>
 #include <QtQml/qjsengine.h>
+#include <QtQml/private/qv4engine_p.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qregularexpression.h>
 
 class tst_qv4regexp : public QObject
 {
     Q_OBJECT
 
 private slots:
+    void initTestCase();
+    void cleanup();
     void catchJitFail();
+    void cacheStatistics();
+    void cacheSize();
+    void jitThreshold();
+    void jitLongStrings();
+    void jitForceInterpreter();
+
+private:
+    struct Statistics
+    {
+        int hits = 0;
+        int misses = 0;
+        int evictions = 0;
+        int jitCompilations = 0;
+        int peakJitCodeBytes = 0;
+    };
+
+    // Runs the programs in a new engine, collecting garbage in between, and returns the
+    // statistics the engine logs when it is destroyed.
+    static Statistics run(const QStringList &programs);
+
+    int m_jitThreshold = 0;
+    int m_jitStringLength = 0;
+    int m_cacheSize = 0;
 };
 
+static QStringList statisticsMessages;
+
+static void statisticsHandler(QtMsgType, const QMessageLogContext &context, const QString &message)
+{
+    if (qstrcmp(context.category, "qt.qml.regexp.statistics") == 0)
+        statisticsMessages.append(message);
+}
+
+tst_qv4regexp::Statistics tst_qv4regexp::run(const QStringList &programs)
+{
+    statisticsMessages.clear();
+    const QtMessageHandler oldHandler = qInstallMessageHandler(statisticsHandler);
+    {
+        QJSEngine engine;
+        for (const QString &program : programs) {
+            const QJSValue result = engine.evaluate(program);
+            if (result.isError())
+                qWarning() << result.toString();
+            engine.collectGarbage();
+        }
+    }
+    qInstallMessageHandler(oldHandler);
+
+    Statistics statistics;
+    if (statisticsMessages.size() != 1)
+        return statistics;
+
+    // "Cache hits: 1 misses: 2 evictions: 0 JIT compilations: 0 peak JIT code bytes: 0"
+    QList<int> numbers;
+    static const QRegularExpression number(QStringLiteral("\\d+"));
+    for (const QRegularExpressionMatch &match : number.globalMatch(statisticsMessages.first()))
+        numbers.append(match.captured().toInt());
+    if (numbers.size() != 5)
+        return statistics;
+
+    statistics.hits = numbers[0];
+    statistics.misses = numbers[1];
+    statistics.evictions = numbers[2];
+    statistics.jitCompilations = numbers[3];
+    statistics.peakJitCodeBytes = numbers[4];
+    return statistics;
+}
+
+void tst_qv4regexp::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("qt.qml.regexp.statistics.debug=true"));
+
+    // The first engine initializes the settings from the environment.
+    QJSEngine engine;
+    m_jitThreshold = QV4::ExecutionEngine::regExpJitThreshold();
+    m_jitStringLength = QV4::ExecutionEngine::regExpJitStringLength();
+    m_cacheSize = QV4::ExecutionEngine::regExpCacheSize();
+}
+
+void tst_qv4regexp::cleanup()
+{
+    QV4::ExecutionEngine::setRegExpJitThreshold(m_jitThreshold);
+    QV4::ExecutionEngine::setRegExpJitStringLength(m_jitStringLength);
+    QV4::ExecutionEngine::setRegExpCacheSize(m_cacheSize);
+}
+
 void tst_qv4regexp::catchJitFail()
 {
     QJSEngine engine;
@@ -23,6 +112,91 @@ void tst_qv4regexp::catchJitFail()
     QVERIFY(result.toBool());
 }
 
+void tst_qv4regexp::cacheStatistics()
+{
+    const Statistics statistics = run({
+        QStringLiteral("var a = new RegExp('a+'); var b = new RegExp('a+'); new RegExp('b+');")
+    });
+    QCOMPARE(statistics.hits, 1);
+    QCOMPARE(statistics.misses, 2);
+    QCOMPARE(statistics.evictions, 0);
+}
+
+void tst_qv4regexp::cacheSize()
+{
+    QV4::ExecutionEngine::setRegExpCacheSize(2);
+
+    // Nothing references the regular expressions but the cache. Only the two most recently
+    // used ones survive the garbage collection.
+    const Statistics statistics = run({
+        QStringLiteral("for (var i = 0; i < 5; ++i) new RegExp('p' + i);"),
+        QStringLiteral("new RegExp('p4'); new RegExp('p3');")
+    });
+    QCOMPARE(statistics.misses, 5);
+    QCOMPARE(statistics.evictions, 3);
+    QCOMPARE(statistics.hits, 2);
+}
+
+void tst_qv4regexp::jitThreshold()
+{
+    {
+        QJSEngine engine;
+        if (!engine.handle()->canJIT())
+            QSKIP("The JIT is not available");
+    }
+
+    // As with QV4_REGEXP_JIT_THRESHOLD=3
+    QV4::ExecutionEngine::setRegExpJitThreshold(3);
+    QV4::ExecutionEngine::setRegExpJitStringLength(std::numeric_limits<int>::max());
+
+    const QString program = QStringLiteral(
+            "var r = new RegExp('a+b'); for (var i = 0; i < %1; ++i) r.exec('aab');");
+
+    Statistics statistics = run({ program.arg(3) });
+    QCOMPARE(statistics.misses, 1);
+    QCOMPARE(statistics.jitCompilations, 0);
+    QCOMPARE(statistics.peakJitCodeBytes, 0);
+
+    statistics = run({ program.arg(10) });
+    QCOMPARE(statistics.misses, 1);
+    QCOMPARE(statistics.jitCompilations, 1);
+    QVERIFY(statistics.peakJitCodeBytes > 0);
+}
+
+void tst_qv4regexp::jitLongStrings()
+{
+    {
+        QJSEngine engine;
+        if (!engine.handle()->canJIT())
+            QSKIP("The JIT is not available");
+    }
+
+    const QString program = QStringLiteral(
+            "new RegExp('a+b').exec('a'.repeat(2000) + 'b');");
+
+    // By default, a long string is worth compiling right away.
+    QV4::ExecutionEngine::setRegExpJitThreshold(5);
+    QV4::ExecutionEngine::setRegExpJitStringLength(1024);
+    QCOMPARE(run({ program }).jitCompilations, 1);
+
+    // An explicit QV4_REGEXP_JIT_THRESHOLD applies to long strings, too.
+    QV4::ExecutionEngine::setRegExpJitStringLength(std::numeric_limits<int>::max());
+    QCOMPARE(run({ program }).jitCompilations, 0);
+}
+
+void tst_qv4regexp::jitForceInterpreter()
+{
+    // As with QV4_FORCE_INTERPRETER
+    QV4::ExecutionEngine::setRegExpJitThreshold(std::numeric_limits<int>::max());
+    QV4::ExecutionEngine::setRegExpJitStringLength(std::numeric_limits<int>::max());
+
+    const Statistics statistics = run({ QStringLiteral(
+            "var r = new RegExp('a+b'); var s = 'a'.repeat(2000) + 'b';"
+            "for (var i = 0; i < 100; ++i) r.exec(s);") });
+    QCOMPARE(statistics.misses, 1);
+    QCOMPARE(statistics.jitCompilations, 0);
+}
+
 QTEST_MAIN(tst_qv4regexp)
 
 #include "tst_qv4regexp.moc"
@@ -29,6 +29,9 @@ private slots:
     void bigimport_data();
     void bigimport();
 
+    void startup_data();
+    void startup();
+
 private:
     QQmlEngine engine;
 };
@@ -161,6 +164,76 @@ void tst_compilation::bigimport()
     }
 }
 
+void tst_compilation::startup_data()
+{
+    QTest::addColumn<int>("filesToCreate");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("500") << 500;
+    QTest::newRow("2000") << 2000;
+}
+
+// Loads a document that depends on many QML and JavaScript files none of which are
+// cached yet. Run with QML_TYPELOADER_PARSER_THREADS=0 to parse them all on the
+// loader thread, for comparison.
+void tst_compilation::startup()
+{
+    QFETCH(int, filesToCreate);
+
+    // A new directory every time, so that nothing is loaded from the disk cache.
+    QTemporaryDir d;
+    QString p;
+    {
+        for (int i = 0; i < filesToCreate; ++i) {
+            QFile js(d.path() + QDir::separator() + QString::fromLatin1("Type%1.js").arg(i));
+            QVERIFY(js.open(QIODevice::WriteOnly));
+            js.write(".pragma library\n");
+            js.write("function scale(value, factor) {\n");
+            js.write("    var result = 0;\n");
+            js.write("    for (var i = 0; i < factor; ++i)\n");
+            js.write("        result += value;\n");
+            js.write("    return result;\n");
+            js.write("}\n");
+
+            QFile f(d.path() + QDir::separator() + QString::fromLatin1("Type%1.qml").arg(i));
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            f.write("import QtQml\n");
+            f.write(qPrintable(QString::fromLatin1("import \"Type%1.js\" as Logic\n").arg(i)));
+            f.write("QtObject {\n");
+            f.write("    property int base: 3\n");
+            f.write("    property int scaled: Logic.scale(base, 4)\n");
+            f.write("    property string label: \"value: \" + scaled\n");
+            f.write("    property list<QtObject> parts: [\n");
+            f.write("        QtObject { property int value: base * 2 },\n");
+            f.write("        QtObject { property int value: base * 3 }\n");
+            f.write("    ]\n");
+            f.write("    function describe() { return label + \", \" + parts.length; }\n");
+            f.write("}\n");
+        }
+
+        QFile main(d.path() + QDir::separator() + "main.qml");
+        QVERIFY(main.open(QIODevice::WriteOnly));
+        p = QFileInfo(main).absoluteFilePath();
+
+        main.write("import QtQml\n");
+        main.write("\n");
+        main.write("QtObject {\n");
+        main.write("    property list<QtObject> types: [\n");
+        for (int i = 0; i < filesToCreate; ++i) {
+            main.write(qPrintable(QString::fromLatin1("        Type%1 {}%2\n")
+                                  .arg(i).arg(QLatin1String(i + 1 < filesToCreate ? "," : ""))));
+        }
+        main.write("    ]\n");
+        main.write("}\n");
+    }
+
+    QBENCHMARK_ONCE {
+        QQmlEngine e;
+        QQmlComponent c(&e, p);
+        QVERIFY2(c.isReady(), qPrintable(c.errorString()));
+    }
+}
+
 QTEST_MAIN(tst_compilation)
 
 #include "tst_compilation.moc"
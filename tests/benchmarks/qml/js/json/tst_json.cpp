@@ -0,0 +1,177 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <qtest.h>
+#include <QtQml/qjsengine.h>
+#include <QtQml/qjsvalue.h>
+#include <private/qv4engine_p.h>
+#include <private/qv4jsonobject_p.h>
+#include <private/qv4scopedvalue_p.h>
+
+class tst_Json : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseRecords_data() { sizes(); }
+    void parseRecords();
+    void parseRecordsUtf8_data() { sizes(); }
+    void parseRecordsUtf8();
+    void parseDictionary_data() { sizes(); }
+    void parseDictionary();
+    void stringifyRecords_data() { sizes(); }
+    void stringifyRecords();
+    void stringifyIndented_data() { sizes(); }
+    void stringifyIndented();
+    void stringifyLongStrings_data() { sizes(); }
+    void stringifyLongStrings();
+
+private:
+    void sizes();
+    static QByteArray records(int size);
+    void stringify(const QString &setup, const QString &arguments);
+};
+
+void tst_Json::sizes()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("100") << 100;
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+}
+
+// A typical REST payload: an array of identically shaped objects.
+QByteArray tst_Json::records(int size)
+{
+    QByteArray json = "[";
+    for (int i = 0; i < size; ++i) {
+        if (i)
+            json += ',';
+        json += QByteArray(R"({"id": %1, "name": "Item %1", "price": %1.25, "tags": ["a", "b"],)"
+                           R"( "available": true, "owner": {"name": "José", "id": %1}})")
+                        .replace("%1", QByteArray::number(i));
+    }
+    json += ']';
+    return json;
+}
+
+void tst_Json::parseRecords()
+{
+    QFETCH(int, size);
+
+    QJSEngine engine;
+    QJSValue parse = engine.evaluate(QStringLiteral("(function(json) { return JSON.parse(json).length; })"));
+    QVERIFY(parse.isCallable());
+    const QString json = QString::fromUtf8(records(size));
+
+    QJSValue result;
+    QBENCHMARK {
+        result = parse.call({ json });
+    }
+    QCOMPARE(result.toInt(), size);
+}
+
+// This is what XMLHttpRequest does for UTF-8 encoded JSON responses.
+void tst_Json::parseRecordsUtf8()
+{
+    QFETCH(int, size);
+
+    QJSEngine engine;
+    QV4::ExecutionEngine *v4 = engine.handle();
+    const QByteArray json = records(size);
+
+    QV4::Scope scope(v4);
+    QV4::ScopedObject result(scope);
+    QJsonParseError error;
+    QBENCHMARK {
+        QV4::JsonParser parser(v4, json.constData(), json.size());
+        result = parser.parse(&error);
+    }
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QVERIFY(result);
+    QCOMPARE(result->getLength(), qint64(size));
+}
+
+// Every key is different, so there is no shape to reuse.
+void tst_Json::parseDictionary()
+{
+    QFETCH(int, size);
+
+    QJSEngine engine;
+    QJSValue parse = engine.evaluate(QStringLiteral(
+            "(function(json) { return Object.keys(JSON.parse(json)).length; })"));
+    QVERIFY(parse.isCallable());
+
+    QString json = QStringLiteral("{");
+    for (int i = 0; i < size; ++i) {
+        if (i)
+            json += u',';
+        json += QStringLiteral("\"key%1\": %1").arg(i);
+    }
+    json += u'}';
+
+    QJSValue result;
+    QBENCHMARK {
+        result = parse.call({ json });
+    }
+    QCOMPARE(result.toInt(), size);
+}
+
+// Runs \a setup once to build a value from "size", and then benchmarks
+// JSON.stringify() on it with the given extra \a arguments.
+void tst_Json::stringify(const QString &setup, const QString &arguments)
+{
+    QFETCH(int, size);
+
+    QJSEngine engine;
+    QJSValue build = engine.evaluate(QStringLiteral("(function(size) {%1})").arg(setup));
+    QVERIFY(build.isCallable());
+    QJSValue value = build.call({ size });
+    QVERIFY2(!value.isError(), qPrintable(value.toString()));
+
+    QJSValue stringify = engine.evaluate(
+            QStringLiteral("(function(value) { return JSON.stringify(value%1).length; })")
+                    .arg(arguments));
+    QVERIFY(stringify.isCallable());
+
+    QJSValue result;
+    QBENCHMARK {
+        result = stringify.call({ value });
+    }
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QVERIFY(result.toInt() > size);
+}
+
+static const QString recordsSetup = QStringLiteral(R"(
+    const list = [];
+    for (let i = 0; i < size; ++i) {
+        list.push({ id: i, name: "Item " + i, price: i + 0.25, tags: ["a", "b"],
+                    available: true, owner: { name: "José", id: i } });
+    }
+    return list;
+)");
+
+void tst_Json::stringifyRecords()
+{
+    stringify(recordsSetup, QString());
+}
+
+void tst_Json::stringifyIndented()
+{
+    stringify(recordsSetup, QStringLiteral(", null, 2"));
+}
+
+void tst_Json::stringifyLongStrings()
+{
+    stringify(QStringLiteral(R"(
+        const text = "Lorem ipsum dolor sit amet, consectetur adipiscing elit. ".repeat(20);
+        const list = [];
+        for (let i = 0; i < size; ++i)
+            list.push(i % 10 ? text : text + "\"quoted\"\n");
+        return list;
+    )"), QString());
+}
+
+QTEST_MAIN(tst_Json)
+
+#include "tst_json.moc"
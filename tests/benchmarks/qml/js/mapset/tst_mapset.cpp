@@ -0,0 +1,97 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <qtest.h>
+#include <QtQml/qjsengine.h>
+#include <QtQml/qjsvalue.h>
+
+class tst_MapSet : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mapNumberKeys_data() { sizes(); }
+    void mapNumberKeys();
+    void mapStringKeys_data() { sizes(); }
+    void mapStringKeys();
+    void mapObjectKeys_data() { sizes(); }
+    void mapObjectKeys();
+    void setHas_data() { sizes(); }
+    void setHas();
+    void weakMapGet_data() { sizes(); }
+    void weakMapGet();
+
+private:
+    void sizes();
+    void run(const QString &setup, const QString &loop);
+};
+
+void tst_MapSet::sizes()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+// Runs \a setup once, filling a collection with "size" entries, and then
+// benchmarks \a loop, which looks up each of them.
+void tst_MapSet::run(const QString &setup, const QString &loop)
+{
+    QFETCH(int, size);
+
+    QJSEngine engine;
+    QJSValue fill = engine.evaluate(QStringLiteral("(function(size) {%1})").arg(setup));
+    QVERIFY(fill.isCallable());
+    QJSValue collection = fill.call({ size });
+    QVERIFY2(!collection.isError(), qPrintable(collection.toString()));
+
+    QJSValue lookup = engine.evaluate(QStringLiteral("(function(c, size) {%1})").arg(loop));
+    QVERIFY(lookup.isCallable());
+
+    QJSValue result;
+    QBENCHMARK {
+        result = lookup.call({ collection, size });
+    }
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QCOMPARE(result.toInt(), size);
+}
+
+void tst_MapSet::mapNumberKeys()
+{
+    run(QStringLiteral("var m = new Map; for (var i = 0; i < size; ++i) m.set(i, i); return m;"),
+        QStringLiteral("var n = 0; for (var i = 0; i < size; ++i) if (c.get(i) === i) ++n; return n;"));
+}
+
+void tst_MapSet::mapStringKeys()
+{
+    run(QStringLiteral("var m = new Map; for (var i = 0; i < size; ++i) m.set('k' + i, i); return m;"),
+        QStringLiteral("var n = 0; for (var i = 0; i < size; ++i) if (c.get('k' + i) === i) ++n; return n;"));
+}
+
+void tst_MapSet::mapObjectKeys()
+{
+    run(QStringLiteral("var keys = []; var m = new Map;"
+                       "for (var i = 0; i < size; ++i) { var k = {}; keys.push(k); m.set(k, i); }"
+                       "return { map: m, keys: keys };"),
+        QStringLiteral("var n = 0; for (var i = 0; i < size; ++i) if (c.map.get(c.keys[i]) === i) ++n; return n;"));
+}
+
+void tst_MapSet::setHas()
+{
+    run(QStringLiteral("var s = new Set; for (var i = 0; i < size; ++i) s.add(i * 0.5); return s;"),
+        QStringLiteral("var n = 0; for (var i = 0; i < size; ++i) if (c.has(i * 0.5)) ++n; return n;"));
+}
+
+void tst_MapSet::weakMapGet()
+{
+    run(QStringLiteral("var keys = []; var m = new WeakMap;"
+                       "for (var i = 0; i < size; ++i) { var k = {}; keys.push(k); m.set(k, i); }"
+                       "return { map: m, keys: keys };"),
+        QStringLiteral("var n = 0; for (var i = 0; i < size; ++i) if (c.map.get(c.keys[i]) === i) ++n; return n;"));
+}
+
+QTEST_MAIN(tst_MapSet)
+
+#include "tst_mapset.moc"
@@ -5,6 +5,10 @@
 #include <QQmlEngine>
 #include <QQmlComponent>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QScopeGuard>
+#include <QTemporaryDir>
 
 class tst_typeimports : public QObject
 {
@@ -16,6 +20,9 @@ private slots:
     void cpp();
     void qml();
 
+    void modules_data();
+    void modules();
+
 private:
     QQmlEngine engine;
 };
@@ -92,6 +99,79 @@ void tst_typeimports::qml()
     }
 }
 
+void tst_typeimports::modules_data()
+{
+    QTest::addColumn<int>("moduleCount");
+    QTest::addColumn<QString>("cache");
+
+    for (int moduleCount : { 10, 100 }) {
+        for (const char *cache : { "baseline", "cold", "warm" }) {
+            QTest::addRow("%d modules, %s", moduleCount, cache)
+                    << moduleCount << QString::fromLatin1(cache);
+        }
+    }
+}
+
+// Resolves the imports of a document that imports many modules, with a new engine every time.
+// The time is broken down as follows: "baseline" creates the engine and the document without
+// the imports. "cold" additionally resolves the imports from scratch, and records them in the
+// persistent import cache. "warm" finds the imports in the cache recorded before. Enable the
+// qt.qml.importcache.statistics logging category to see how many imports were found.
+void tst_typeimports::modules()
+{
+    QFETCH(int, moduleCount);
+    QFETCH(QString, cache);
+
+    QTemporaryDir importDir;
+    QVERIFY(importDir.isValid());
+
+    QByteArray source = "import QtQml\n";
+    for (int i = 0; i < moduleCount; ++i) {
+        const QString name = QString::fromLatin1("Module%1").arg(i);
+        QVERIFY(QDir(importDir.path()).mkdir(name));
+
+        QFile qmldir(importDir.path() + QLatin1Char('/') + name + QLatin1String("/qmldir"));
+        QVERIFY(qmldir.open(QIODevice::WriteOnly));
+        qmldir.write(QString::fromLatin1("module %1\nType%2 1.0 Type%2.qml\n")
+                             .arg(name).arg(i).toUtf8());
+
+        QFile type(importDir.path() + QLatin1Char('/') + name
+                   + QString::fromLatin1("/Type%1.qml").arg(i));
+        QVERIFY(type.open(QIODevice::WriteOnly));
+        type.write("import QtQml\nQtObject {}\n");
+
+        if (cache != QLatin1String("baseline"))
+            source += "import " + name.toUtf8() + '\n';
+    }
+    source += "QtObject {}\n";
+
+    const QByteArray oldCachePath = qgetenv("QML_DISK_CACHE_PATH");
+    auto guard = qScopeGuard([&] { qputenv("QML_DISK_CACHE_PATH", oldCachePath); });
+
+    const QUrl url = QUrl::fromLocalFile(importDir.path() + QLatin1String("/main.qml"));
+    const auto load = [&]() {
+        QQmlEngine engine;
+        engine.addImportPath(importDir.path());
+        QQmlComponent component(&engine);
+        component.setData(source, url);
+        return component.isReady();
+    };
+
+    QTemporaryDir warmCacheDir;
+    if (cache == QLatin1String("warm")) {
+        qputenv("QML_DISK_CACHE_PATH", warmCacheDir.path().toLocal8Bit());
+        QVERIFY(load());
+    }
+
+    QBENCHMARK {
+        // Created in every case, so that its cost doesn't skew the comparison.
+        QTemporaryDir coldCacheDir;
+        if (cache != QLatin1String("warm"))
+            qputenv("QML_DISK_CACHE_PATH", coldCacheDir.path().toLocal8Bit());
+        QVERIFY(load());
+    }
+}
+
 QTEST_MAIN(tst_typeimports)
 
 #include "tst_typeimports.moc"
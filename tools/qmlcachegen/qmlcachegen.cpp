@@ -22,6 +22,9 @@
 #include <private/qqmljsresourcefilemapper_p.h>
 #include <private/qqmljsutils_p.h>
 #include <private/qresourcerelocater_p.h>
+#include <private/qv4compilationunitbundle_p.h>
+
+#include <QtQml/qqmlfile.h>
 
 #include <algorithm>
 
@@ -56,6 +59,96 @@ static bool argumentsFromCommandLineAndFile(QStringList& allArguments, const QSt
     return true;
 }
 
+// Inputs are QML or JavaScript files, optionally followed by "=" and the path they are loaded
+// from at run time, or cache files written by the QML engine. The latter record their source.
+static bool generateBundle(const QStringList &inputs, const QString &outputFileName)
+{
+    QMap<QString, QByteArray> units;
+    for (const QString &input : inputs) {
+        const qsizetype separator = input.indexOf(u'=');
+        const QString inputFile = separator < 0 ? input : input.left(separator);
+        QString runtimePath = separator < 0
+                ? QFileInfo(inputFile).absoluteFilePath()
+                : input.mid(separator + 1);
+
+        QByteArray unitData;
+        const QQmlJSSaveFunction saveFunction = [&unitData](
+                const QV4::CompiledData::SaveableUnitPointer &unit,
+                const QQmlJSAotFunctionMap &aotFunctions, QString *errorString) {
+            Q_UNUSED(aotFunctions);
+            Q_UNUSED(errorString);
+            return unit.saveToDisk<char>([&unitData](const char *data, quint32 size) {
+                unitData = QByteArray(data, size);
+                return true;
+            });
+        };
+
+        // The engine checks that the recorded source matches the file it loads.
+        const QString runtimeUrl = runtimePath.startsWith(u':')
+                ? u"qrc:"_s + runtimePath.mid(1)
+                : QUrl::fromLocalFile(runtimePath).toString();
+
+        QQmlJSCompileError error;
+        if (inputFile.endsWith(".qml"_L1)) {
+            QFile f(inputFile);
+            if (!f.open(QIODevice::ReadOnly)) {
+                fprintf(stderr, "Error opening %s: %s\n",
+                        qPrintable(inputFile), qPrintable(f.errorString()));
+                return false;
+            }
+            const QString contents = QString::fromUtf8(f.readAll());
+            if (!qCompileQmlFile(runtimeUrl, saveFunction, nullptr, &error,
+                                 /* storeSourceLocation */ false, nullptr, &contents)) {
+                error.augment("Error compiling qml file: "_L1).print();
+                return false;
+            }
+        } else if (inputFile.endsWith(".js"_L1) || inputFile.endsWith(".mjs"_L1)) {
+            if (!qCompileJSFile(inputFile, runtimeUrl, saveFunction, &error)) {
+                error.augment("Error compiling js file: "_L1).print();
+                return false;
+            }
+        } else {
+            QFile f(inputFile);
+            if (!f.open(QIODevice::ReadOnly)) {
+                fprintf(stderr, "Error opening %s: %s\n",
+                        qPrintable(inputFile), qPrintable(f.errorString()));
+                return false;
+            }
+            unitData = f.readAll();
+
+            const auto *unit = reinterpret_cast<const QV4::CompiledData::Unit *>(
+                    unitData.constData());
+            if (unitData.size() < qsizetype(sizeof(QV4::CompiledData::Unit))
+                    || strncmp(unit->magic, QV4::CompiledData::magic_str, sizeof(unit->magic))
+                    || unit->unitSize != quint32(unitData.size())) {
+                fprintf(stderr, "%s is not a QML cache file\n", qPrintable(inputFile));
+                return false;
+            }
+
+            if (separator < 0) {
+                if (unit->sourceFileIndex == 0 || unit->sourceFileIndex >= unit->stringTableSize) {
+                    fprintf(stderr, "%s does not record its source file. "
+                                    "Pass it as <cache file>=<source path>.\n",
+                            qPrintable(inputFile));
+                    return false;
+                }
+                runtimePath = QQmlFile::urlToLocalFileOrQrc(
+                        unit->stringAtInternal(unit->sourceFileIndex));
+            }
+        }
+
+        units.insert(runtimePath, unitData);
+    }
+
+    QString errorString;
+    if (!QV4::CompilationUnitBundle::write(outputFileName, units, &errorString)) {
+        fprintf(stderr, "Error writing %s: %s\n",
+                qPrintable(outputFileName), qPrintable(errorString));
+        return false;
+    }
+    return true;
+}
+
 int main(int argc, char **argv)
 {
     // Produce reliably the same output for the same input by disabling QHash's random seeding.
@@ -106,6 +199,9 @@ int main(int argc, char **argv)
     QCommandLineOption moduleIdOption("module-id"_L1, QCoreApplication::translate("main", "Identifies the module of the qml file being compiled for aot stats"), QCoreApplication::translate("main", "id"));
     parser.addOption(moduleIdOption);
 
+    QCommandLineOption bundleOption("bundle"_L1, QCoreApplication::translate("main", "Write the byte code of all input files into one cache bundle that is loaded through QML_DISK_CACHE_BUNDLE. Inputs are QML or JavaScript files, optionally as <file>=<path at run time>, or cache files written by the QML engine."));
+    parser.addOption(bundleOption);
+
     QCommandLineOption outputFileOption("o"_L1, QCoreApplication::translate("main", "Output file name"), QCoreApplication::translate("main", "file name"));
     parser.addOption(outputFileOption);
 
@@ -164,6 +260,12 @@ int main(int argc, char **argv)
     const QStringList sources = parser.positionalArguments();
     if (sources.isEmpty()){
         parser.showHelp();
+    } else if (parser.isSet(bundleOption)) {
+        if (outputFileName.isEmpty()) {
+            fprintf(stderr, "--bundle requires an output file\n");
+            return EXIT_FAILURE;
+        }
+        return generateBundle(sources, outputFileName) ? EXIT_SUCCESS : EXIT_FAILURE;
     } else if (sources.size() > 1 && (target != GenerateLoader && target != GenerateLoaderStandAlone)) {
         fprintf(stderr, "%s\n", qPrintable("Too many input files specified: '"_L1 + sources.join("' '"_L1) + u'\''));
         return EXIT_FAILURE;
@@ -179,7 +179,13 @@ void QmlProfilerData::addEventType(const QQmlProfilerEventType &type)
         displayName = QString::fromLatin1("SceneGraph:%1").arg(type.detailType());
         break;
     case MemoryAllocation:
-        displayName = QString::fromLatin1("MemoryAllocation:%1").arg(type.detailType());
+        if (type.detailType() == SampledAllocation && !type.location().filename().isEmpty()) {
+            const QString filePath = QUrl(type.location().filename()).path();
+            displayName = QStringView{filePath}.mid(filePath.lastIndexOf(QLatin1Char('/')) + 1)
+                    + QLatin1Char(':') + QString::number(type.location().line());
+        } else {
+            displayName = QString::fromLatin1("MemoryAllocation:%1").arg(type.detailType());
+        }
         break;
     case DebugMessage:
         displayName = QString::fromLatin1("DebugMessage:%1").arg(type.detailType());
@@ -602,6 +608,8 @@ bool QmlProfilerData::save(const QString &filename)
             stream.writeAttribute("timing5", event, 4, false);
         } else if (type.message() == MemoryAllocation) {
             stream.writeAttribute("amount", event, 0);
+            if (type.detailType() == SampledAllocation)
+                stream.writeAttribute("count", event, 1);
         }
         stream.writeEndElement();
     };